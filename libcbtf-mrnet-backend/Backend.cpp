@@ -19,9 +19,12 @@
 /** @file Definition of the Backend namespace. */
 
 #include <algorithm>
+#include <boost/lexical_cast.hpp>
 #include <boost/thread.hpp>
 #include <iostream>
 #include <KrellInstitute/CBTF/Impl/MRNet.hpp>
+#include <KrellInstitute/CBTF/Trace.hpp>
+#include <map>
 #include <stdexcept>
 #include <sys/select.h>
 
@@ -30,6 +33,7 @@
 #include "Raise.hpp"
 
 using namespace KrellInstitute::CBTF::Impl;
+using KrellInstitute::CBTF::Trace;
 
 
 
@@ -61,6 +65,10 @@ namespace {
             MRN::Event::DATA_EVENT
             );
         
+        // Labels of the trace records, interned only once per message tag
+        const Trace::Label category = Trace::intern("MRNet backend");
+        std::map<int, Trace::Label> tag_labels;
+
         // Run the message pump until instructed to exit
         try
         {
@@ -106,6 +114,8 @@ namespace {
                         }
 
                         // Dispatch the message to the proper handlers
+                        const boost::uint64_t start =
+                            Trace::isEnabled() ? Trace::now() : 0;
                         bool handled = false;                    
                         try
                         {
@@ -116,6 +126,24 @@ namespace {
                             std::cout << "[BE " << getpid() << "] EXCEPTION: "
                                       << error.what() << std::endl;
                         }
+                        if (start != 0)
+                        {
+                            std::map<int, Trace::Label>::iterator i =
+                                tag_labels.find(tag);
+                            if (i == tag_labels.end())
+                            {
+                                i = tag_labels.insert(std::make_pair(
+                                    tag, Trace::intern(
+                                        "tag " +
+                                        boost::lexical_cast<std::string>(tag)
+                                        )
+                                    )).first;
+                            }
+                            Trace::record(
+                                category, i->second,
+                                start, Trace::now() - start
+                                );
+                        }
                         if (is_backend_debug_enabled)
                         {
                             std::cout << "[BE " << getpid() << "] "
@@ -154,6 +182,7 @@ void Backend::startMessagePump(int argc, char* argv[])
 {
     // Determine the type of debugging that should be enabled
     bool is_tracing_debug_enabled = false;
+    bool is_trace_enabled = false;
     for (int i = 0; i < argc; ++i)
     {
         if (std::string(argv[i]) == std::string("--debug"))
@@ -164,6 +193,10 @@ void Backend::startMessagePump(int argc, char* argv[])
         {
             is_tracing_debug_enabled = true;
         }
+        else if (std::string(argv[i]) == std::string("--trace"))
+        {
+            is_trace_enabled = true;
+        }
     }
     
     // Initialize the MRNet library (participating as a backend)
@@ -195,6 +228,24 @@ void Backend::startMessagePump(int argc, char* argv[])
     TheTopologyInfo.NumLeafDescendants = topology_info.get_NumLeafDescendants();
     TheTopologyInfo.RootDistance = topology_info.get_RootDistance();
     TheTopologyInfo.MaxLeafDistance = topology_info.get_MaxLeafDistance();
+
+    // Enable tracing of this backend (if appropriate) unless CBTF_TRACE did
+    if (is_trace_enabled)
+    {
+        Trace::setProcessName(
+            "CBTF MRNet backend " +
+            boost::lexical_cast<std::string>(TheTopologyInfo.Rank)
+            );
+        if (!Trace::isEnabled())
+        {
+            Trace::setOutputFile(
+                "cbtf-trace-backend-" +
+                boost::lexical_cast<std::string>(TheTopologyInfo.Rank) + "-" +
+                boost::lexical_cast<std::string>(getpid()) + ".json"
+                );
+            Trace::setEnabled(true);
+        }
+    }
     
     // Establish the stream used to pass data within this network
     int tag = -1;
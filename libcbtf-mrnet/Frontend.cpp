@@ -21,9 +21,12 @@
 #include <algorithm>
 #include <boost/bind.hpp>
 #include <boost/filesystem.hpp>
+#include <boost/lexical_cast.hpp>
 #include <boost/weak_ptr.hpp>
 #include <iostream>
 #include <KrellInstitute/CBTF/Impl/MRNet.hpp>
+#include <KrellInstitute/CBTF/Trace.hpp>
+#include <map>
 #include <stdexcept>
 #include <stdlib.h>
 #include <string>
@@ -37,6 +40,7 @@
 #include "ResolvePath.hpp"
 
 using namespace KrellInstitute::CBTF::Impl;
+using KrellInstitute::CBTF::Trace;
 
 
 
@@ -233,6 +237,21 @@ Frontend::Frontend(const boost::shared_ptr<MRN::Network>& network,
         MRN::set_OutputLevel(MRN::MAX_OUTPUT_LEVEL);
     }
 
+    // Enable tracing of the frontend (if appropriate) unless CBTF_TRACE did
+    if ((getenv("CBTF_TRACE_MRNET") != NULL) ||
+        (getenv("CBTF_TRACE_MRNET_FRONTEND") != NULL))
+    {
+        Trace::setProcessName("CBTF MRNet frontend");
+        if (!Trace::isEnabled())
+        {
+            Trace::setOutputFile(
+                "cbtf-trace-frontend-" +
+                boost::lexical_cast<std::string>(getpid()) + ".json"
+                );
+            Trace::setEnabled(true);
+        }
+    }
+
     // Resolve the filter path
     boost::filesystem::path filter_path =
         resolvePath(kLibraryFileType, FILTER_FILE);
@@ -361,6 +380,10 @@ void Frontend::doMessagePump()
     // Get the file descriptor for MRNet data event notification
     int mrnet_fd = dm_network->get_EventNotificationFd(MRN::Event::DATA_EVENT);
     
+    // Labels of the trace records, interned only once per message tag
+    const Trace::Label category = Trace::intern("MRNet frontend");
+    std::map<int, Trace::Label> tag_labels;
+
     // Run the message pump until instructed to exit
     try
     {
@@ -403,6 +426,8 @@ void Frontend::doMessagePump()
                     }
                     
                     // Dispatch the message to the proper handlers
+                    const boost::uint64_t start =
+                        Trace::isEnabled() ? Trace::now() : 0;
                     bool handled = false;                    
                     try
                     {
@@ -413,6 +438,23 @@ void Frontend::doMessagePump()
                         std::cout << "[FE " << getpid() << "] EXCEPTION: "
                                   << error.what() << std::endl;
                     }
+                    if (start != 0)
+                    {
+                        std::map<int, Trace::Label>::iterator i =
+                            tag_labels.find(tag);
+                        if (i == tag_labels.end())
+                        {
+                            i = tag_labels.insert(std::make_pair(
+                                tag, Trace::intern(
+                                    "tag " +
+                                    boost::lexical_cast<std::string>(tag)
+                                    )
+                                )).first;
+                        }
+                        Trace::record(
+                            category, i->second, start, Trace::now() - start
+                            );
+                    }
                     if (dm_is_debug_enabled)
                     {
                         std::cout << "[FE " << getpid() << "] "
@@ -55,7 +55,7 @@ Component::Instance IncomingStreamMediator::create(
     Component::Instance mediator_instance =
         boost::reinterpret_pointer_cast<Component>(mediator);
 
-    mediator->converter() = connectWithAutomaticConversion(    
+    mediator->converters() = connectWithAutomaticConversion(    
         mediator_instance, "value", network, to_input
         );
 
@@ -84,7 +84,7 @@ void IncomingStreamMediator::handler(const MRN::PacketPtr& packet)
 IncomingStreamMediator::IncomingStreamMediator(const int& tag) :
     Component(Type(typeid(IncomingStreamMediator)), Version(0, 0, 0)),
     dm_tag(tag),
-    dm_converter()
+    dm_converters()
 {
     declareOutput<MRN::PacketPtr>("value");
 }
@@ -22,6 +22,7 @@
 
 #include <KrellInstitute/CBTF/Component.hpp>
 #include <mrnet/MRNet.h>
+#include <vector>
 #include <xercesc/dom/DOM.hpp>
 
 #include "NamedStreams.hpp"
@@ -82,17 +83,17 @@ namespace KrellInstitute { namespace CBTF { namespace Impl {
          */
         IncomingStreamMediator(const int& tag);
 
-        /** Automatic type converter (if any) for this mediator. */
-        Component::Instance& converter()
+        /** Automatic type converters (if any) for this mediator. */
+        std::vector<Component::Instance>& converters()
         {
-            return dm_converter;
+            return dm_converters;
         }
         
         /** MRNet message tag for the named stream being mediated. */
         const int dm_tag;
 
-        /** Automatic type converter (if any) for this mediator. */
-        Component::Instance dm_converter;
+        /** Automatic type converters (if any) for this mediator. */
+        std::vector<Component::Instance> dm_converters;
                         
     }; // class IncomingStreamMediator
 
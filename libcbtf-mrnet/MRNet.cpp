@@ -105,6 +105,9 @@ std::vector<std::string> Impl::getMRNetBackendArguments()
          (getenv("CBTF_DEBUG_MRNET_BACKEND") != NULL));
     bool is_tracing_debug_enabled = 
         (getenv("CBTF_DEBUG_MRNET_TRACING") != NULL);
+    bool is_backend_trace_enabled =
+        ((getenv("CBTF_TRACE_MRNET") != NULL) ||
+         (getenv("CBTF_TRACE_MRNET_BACKEND") != NULL));
     
     std::vector<std::string> arguments;
     if (is_backend_debug_enabled)
@@ -115,6 +118,10 @@ std::vector<std::string> Impl::getMRNetBackendArguments()
     {
         arguments.push_back("--tracing");
     }
+    if (is_backend_trace_enabled)
+    {
+        arguments.push_back("--trace");
+    }
     
     return arguments;
 }
@@ -135,6 +142,7 @@ void MRNet::registerXML(
     )
 {
     Component::registerFactoryFunction(
+        describeXML(root),
         boost::bind(&MRNet::factoryFunction, document, root)
         );
 }
@@ -371,7 +379,7 @@ void MRNet::parseInput(const xercesc::DOMNode* node)
     const std::string name = xercesc::selectValue(node, "./Name");
     const std::string to_input = xercesc::selectValue(node, "./To/Input");
 
-    std::map<std::string, Type> to_inputs = 
+    const std::map<std::string, Type>& to_inputs = 
         dm_local_component_network.network()->getInputs();
     
     std::map<std::string, Type>::const_iterator i = to_inputs.find(to_input);
@@ -399,7 +407,8 @@ void MRNet::parseInput(const xercesc::DOMNode* node)
     
     declareInput(
         name, i->second, 
-        boost::bind(&InputMediator::handler, input_mediator.get(), _1)
+        boost::bind(&InputMediator::handler, input_mediator.get(), _1),
+        boost::bind(&InputMediator::batchHandler, input_mediator.get(), _1)
         );
 }
 
@@ -414,7 +423,7 @@ void MRNet::parseOutput(const xercesc::DOMNode* node)
     const std::string name = xercesc::selectValue(node, "./Name");    
     const std::string from_output = xercesc::selectValue(node, "./From/Output");
     
-    std::map<std::string, Type> from_outputs = 
+    const std::map<std::string, Type>& from_outputs = 
         dm_local_component_network.network()->getOutputs();
     
     std::map<std::string, Type>::const_iterator i =
@@ -432,9 +441,15 @@ void MRNet::parseOutput(const xercesc::DOMNode* node)
             i->second,
             boost::bind(
                 (void (Component::*)(
-                    const std::string&, const Type&, const boost::any&
+                    const std::string&, const Type&, const Value&
                     ))(&MRNet::emitOutput),
                 this, name, i->second, _1
+                ),
+            boost::bind(
+                (void (Component::*)(
+                    const std::string&, const Type&, const Batch&
+                    ))(&MRNet::emitOutputBatch),
+                this, name, i->second, _1
                 )
             )
         );
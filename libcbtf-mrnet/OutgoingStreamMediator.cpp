@@ -55,7 +55,7 @@ Component::Instance OutgoingStreamMediator::create(
     Component::Instance mediator_instance =
         boost::reinterpret_pointer_cast<Component>(mediator);
 
-    mediator->converter() = connectWithAutomaticConversion(
+    mediator->converters() = connectWithAutomaticConversion(
         network, from_output, mediator_instance, "value"
         );
     
@@ -71,10 +71,10 @@ OutgoingStreamMediator::OutgoingStreamMediator(const int& tag,
     Component(Type(typeid(OutgoingStreamMediator)), Version(0, 0, 0)),
     dm_tag(tag),
     dm_handler(handler),
-    dm_converter()
+    dm_converters()
 {
-    declareInput<MRN::PacketPtr>(
-        "value", boost::bind(&OutgoingStreamMediator::handler, this, _1)
+    declareInputBatch<MRN::PacketPtr>(
+        "value", boost::bind(&OutgoingStreamMediator::batchHandler, this, _1)
         );
 }
 
@@ -90,6 +90,21 @@ void OutgoingStreamMediator::handler(const MRN::PacketPtr& packet)
 
 
 
+//------------------------------------------------------------------------------
+// Forward each of the packets in the batch, in order, within a single call.
+//------------------------------------------------------------------------------
+void OutgoingStreamMediator::batchHandler(
+    const boost::iterator_range<const MRN::PacketPtr*>& packets
+    )
+{
+    for (const MRN::PacketPtr* i = packets.begin(); i != packets.end(); ++i)
+    {
+        handler(*i);
+    }
+}
+
+
+
 //------------------------------------------------------------------------------
 //------------------------------------------------------------------------------
 int OutgoingStreamMediator::tag() const
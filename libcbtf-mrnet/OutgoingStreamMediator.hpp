@@ -20,8 +20,10 @@
 
 #pragma once
 
+#include <boost/range/iterator_range.hpp>
 #include <KrellInstitute/CBTF/Component.hpp>
 #include <mrnet/MRNet.h>
+#include <vector>
 #include <xercesc/dom/DOM.hpp>
 
 #include "MessageHandler.hpp"
@@ -86,10 +88,19 @@ namespace KrellInstitute { namespace CBTF { namespace Impl {
          */
         void handler(const MRN::PacketPtr& packet);
 
-        /** Automatic type converter (if any) for this mediator. */
-        Component::Instance& converter()
+        /**
+         * Batch handler for the "value" input.
+         *
+         * @param packets    Packets containing new messages to be forwarded.
+         */
+        void batchHandler(
+            const boost::iterator_range<const MRN::PacketPtr*>& packets
+            );
+
+        /** Automatic type converters (if any) for this mediator. */
+        std::vector<Component::Instance>& converters()
         {
-            return dm_converter;
+            return dm_converters;
         }
         
         /** Tag applied to each mediated message. */
@@ -98,8 +109,8 @@ namespace KrellInstitute { namespace CBTF { namespace Impl {
         /** Handler for the messages being mediated. */
         const MessageHandler dm_handler;
         
-        /** Automatic type converter (if any) for this mediator. */
-        Component::Instance dm_converter;
+        /** Automatic type converters (if any) for this mediator. */
+        std::vector<Component::Instance> dm_converters;
         
     }; // class OutgoingStreamMediator
 
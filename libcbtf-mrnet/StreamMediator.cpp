@@ -21,6 +21,7 @@
 #include <KrellInstitute/CBTF/Type.hpp>
 #include <map>
 #include <stdexcept>
+#include <vector>
 
 #include "Raise.hpp"
 #include "StreamMediator.hpp"
@@ -32,7 +33,8 @@ using namespace KrellInstitute::CBTF::Impl;
 
 //------------------------------------------------------------------------------
 //------------------------------------------------------------------------------
-Component::Instance KrellInstitute::CBTF::Impl::connectWithAutomaticConversion(
+std::vector<Component::Instance>
+KrellInstitute::CBTF::Impl::connectWithAutomaticConversion(
     Component::Instance output_instance,
     const std::string& output_name,
     Component::Instance input_instance,
@@ -43,7 +45,7 @@ Component::Instance KrellInstitute::CBTF::Impl::connectWithAutomaticConversion(
     // Determine the type of the specified output and input.
     //
 
-    std::map<std::string, Type> outputs = output_instance->getOutputs();
+    const std::map<std::string, Type>& outputs = output_instance->getOutputs();
 
     if (outputs.find(output_name) == outputs.end())
     {
@@ -54,7 +56,7 @@ Component::Instance KrellInstitute::CBTF::Impl::connectWithAutomaticConversion(
 
     Type output_type = outputs.find(output_name)->second;
 
-    std::map<std::string, Type> inputs = input_instance->getInputs();
+    const std::map<std::string, Type>& inputs = input_instance->getInputs();
 
     if (inputs.find(input_name) == inputs.end())
     {
@@ -71,66 +73,56 @@ Component::Instance KrellInstitute::CBTF::Impl::connectWithAutomaticConversion(
     // component connect method.
     //
 
+    std::vector<Component::Instance> converters;
+    
     if (output_type == input_type)
     {
         Component::connect(
             output_instance, output_name, input_instance, input_name
             );
 
-        return Component::Instance();
+        return converters;
     }
 
     //
-    // Otherwise search for a component to perform the type conversion. A
-    // component type is deemed suitable for this purpose if its type name
-    // contains the string "Convert", it has a single input of the same type
-    // as the specified output, and it has a single output of the same type
-    // as the specifed input. The first such component type is instantiated
-    // and interposed between the two given components.
+    // Otherwise look up the shortest chain of converters from the type of the
+    // specified output to the type of the specified input in the index kept
+    // by the Component class. Each converter in the chain is instantiated and
+    // interposed between the two given components.
     //
 
-    std::set<Type> available_types = Component::getAvailableTypes();
+    std::vector<Type> chain = Component::findConverters(output_type, input_type);
 
-    for (std::set<Type>::const_iterator
-             i = available_types.begin(); i != available_types.end(); ++i)
+    if (chain.empty())
     {
-        if (std::string(*i).find("Convert") == std::string::npos)
-        {
-            continue;
-        }
+        raise<std::runtime_error>(
+            "The requested output (%1%) and input (%2%) are not of compatible "
+            "types and no suitable automatic type converter could be found.",
+            output_name, input_name
+            );
+    }
 
+    Component::Instance previous_instance = output_instance;
+    std::string previous_name = output_name;
+    
+    for (std::vector<Type>::const_iterator
+             i = chain.begin(); i != chain.end(); ++i)
+    {
         Component::Instance converter = Component::instantiate(*i);
-        
-        if ((converter->getInputs().size() != 1) ||
-            (converter->getInputs().begin()->second != output_type) ||
-            (converter->getOutputs().size() != 1) ||
-            (converter->getOutputs().begin()->second != input_type))
-        {
-            continue;
-        }
-        
-        Component::connect(
-            output_instance, output_name,
-            converter, converter->getInputs().begin()->first
-            );
 
         Component::connect(
-            converter, converter->getOutputs().begin()->first,
-            input_instance, input_name
+            previous_instance, previous_name,
+            converter, converter->getInputs().begin()->first
             );
 
-        return converter;
+        converters.push_back(converter);
+        previous_instance = converter;
+        previous_name = converter->getOutputs().begin()->first;
     }
 
-    //
-    // Otherwise the specified output and input are of incompatible types and
-    // a suitable automatic type converter could not be found. Throw the usual
-    // exception to let the caller know.
-    //
-
-    raise<std::runtime_error>(
-        "The requested output (%1%) and input (%2%) are not of compatible "
-        "types and no suitable automatic type converter could be found.",
-        output_name, input_name
+    Component::connect(
+        previous_instance, previous_name, input_instance, input_name
         );
+
+    return converters;
 }
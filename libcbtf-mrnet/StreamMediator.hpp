@@ -22,23 +22,31 @@
 
 #include <KrellInstitute/CBTF/Component.hpp>
 #include <string>
+#include <vector>
 
 namespace KrellInstitute { namespace CBTF { namespace Impl {
     
     /**
      * Connect a component's output to a component's input. If the types of the
      * specified output and input are of compatible types, simply connect them
-     * directly. Otherwise search for, instantiate, and interpose an available
-     * component that can provide the conversion.
+     * directly. Otherwise find, instantiate, and interpose the shortest chain
+     * of available components that can provide the conversion.
      *
      * @param output_instance    Component with output being connected.
      * @param output_name        Name of output being connected.
      * @param input_instance     Component with input being connected.
      * @param input_name         Name of input being connected.
-     * @return                   Component instance providing the automatic type
-     *                           conversion, or null if no conversion was used.
+     * @return                   Component instances providing the automatic
+     *                           type conversion, in the order they convert
+     *                           values, or an empty list if no conversion
+     *                           was used.
+     *
+     * @throw std::runtime_error    The requested input or output doesn't
+     *                              exist, or they are not of compatible
+     *                              types and no chain of converters could
+     *                              be found.
      */
-    Component::Instance connectWithAutomaticConversion(
+    std::vector<Component::Instance> connectWithAutomaticConversion(
         Component::Instance output_instance,
         const std::string& output_name,
         Component::Instance input_instance,
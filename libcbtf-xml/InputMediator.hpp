@@ -20,8 +20,9 @@
 
 #pragma once
 
-#include <boost/any.hpp>
 #include <KrellInstitute/CBTF/Component.hpp>
+#include <KrellInstitute/CBTF/Impl/Batch.hpp>
+#include <KrellInstitute/CBTF/Impl/Value.hpp>
 #include <KrellInstitute/CBTF/Type.hpp>
 #include <KrellInstitute/CBTF/Version.hpp>
 #include <typeinfo>
@@ -65,11 +66,21 @@ namespace KrellInstitute { namespace CBTF { namespace Impl {
          *
          * @param value    New value for the input being mediated.
          */
-        void handler(const boost::any& value)
+        void handler(const Value& value)
         {
             emitOutput("value", dm_type, value);
         }
 
+        /**
+         * Batch handler for the input being mediated.
+         *
+         * @param batch    New batch of values for the input being mediated.
+         */
+        void batchHandler(const Batch& batch)
+        {
+            emitOutputBatch("value", dm_type, batch);
+        }
+
     private:
         
         /** Type of the input being mediated. */
@@ -44,6 +44,14 @@ namespace KrellInstitute { namespace CBTF {
      *          kinds of component networks (e.g. <MRNet>) are defined by
      *          other libraries, but XML documents using these extensions
      *          are still registered via this function.
+     *
+     * @note    Caching of parsed documents is disabled by default, and is
+     *          enabled by setting the CBTF_XML_CACHE environment variable to
+     *          the path of a directory. The parsed form of each registered
+     *          document is then saved into that directory, keyed by a hash
+     *          of the document and schemas, so that registering an unchanged
+     *          document again skips XML parsing and validation. The directory
+     *          is created if necessary, and files in it are never removed.
      */
     void registerXML(const boost::filesystem::path& path);
 
@@ -18,25 +18,34 @@
 
 /** @file Definition of the Network class. */
 
+#include <boost/atomic.hpp>
 #include <boost/bind.hpp>
+#include <boost/exception_ptr.hpp>
 #include <boost/filesystem.hpp>
-#include <boost/optional.hpp>
-#include <boost/optional/optional_io.hpp>
+#include <boost/noncopyable.hpp>
 #include <boost/ref.hpp>
-#include <boost/spirit/home/classic.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+#include <cstddef>
 #include <cstdlib>
 #include <KrellInstitute/CBTF/BoostExts.hpp>
 #include <KrellInstitute/CBTF/XML.hpp>
+#include <map>
 #include <set>
 #include <stdexcept>
 
+#include "Arena.hpp"
+#include "Executor.hpp"
 #include "Global.hpp"
 #include "InputMediator.hpp"
 #include "Network.hpp"
+#include "NetworkPlan.hpp"
 #include "OutputMediator.hpp"
 #include "Raise.hpp"
 #include "ResolvePath.hpp"
 #include "XercesExts.hpp"
+#include "XML.hpp"
 
 using namespace KrellInstitute::CBTF;
 using namespace KrellInstitute::CBTF::Impl;
@@ -48,13 +57,6 @@ namespace {
 
     /** Global associative container used to track the loaded plugins. */
     KRELL_INSTITUTE_CBTF_IMPL_GLOBAL(Plugins, std::set<boost::filesystem::path>)
-
-    /** Push the value of the specified node onto the given vector of paths. */
-    void pushPath(const xercesc::DOMNode* node,
-                  std::vector<boost::filesystem::path>& paths)
-    {
-        paths.push_back(xercesc::selectValue(node, "."));
-    }
     
     /**
      * Register the plugin with the specified path (after path resolution) if
@@ -83,6 +85,166 @@ namespace {
     
         Plugins::value().insert(path);
     }
+
+    /**
+     * Compile the specified XML tree and register the plugins it requires.
+     * Registering a XML plugin never instantiates anything, so the shared
+     * library plugins can all be registered afterwards, in parallel.
+     */
+    boost::shared_ptr<const NetworkPlan> compilePlan(
+        const xercesc::DOMNode* root
+        )
+    {
+        boost::shared_ptr<const NetworkPlan> plan(new NetworkPlan(root));
+        
+        std::vector<boost::filesystem::path> library_paths;
+        for (std::vector<boost::filesystem::path>::const_iterator
+                 i = plan->dm_plugin_paths.begin();
+             i != plan->dm_plugin_paths.end();
+             ++i)
+        {
+            if (boost::filesystem::extension(*i) == ".xml")
+            {
+                boost::filesystem::path resolved_path =
+                    resolvePath(plan->dm_search_paths, *i);
+                ::registerPlugin(
+                    resolved_path.empty() ? *i : resolved_path
+                    );
+            }
+            else
+            {
+                library_paths.push_back(*i);
+            }
+        }
+
+        Component::registerPlugins(library_paths, plan->dm_search_paths);
+
+        return plan;
+    }
+    
+    /**
+     * Is the parallel instantiation of the components of a network enabled?
+     * Components are instantiated one after another unless the environment
+     * variable CBTF_NETWORK_PARALLEL is set to something other than "0". Only
+     * enable it when the constructors of all the components in the networks
+     * can safely run concurrently with each other.
+     */
+    bool isParallelEnabled()
+    {
+        const char* value = getenv("CBTF_NETWORK_PARALLEL");
+        return (value != NULL) &&
+            (std::string(value) != "") && (std::string(value) != "0");
+    }
+    
+    /** Task instantiating one of the components of a network. */
+    struct InstantiateTask
+    {
+        /** Plan of the component to be instantiated. */
+        const NetworkPlan::ComponentEntry* dm_entry;
+
+        /** Instance of the component if instantiating it succeeded. */
+        Component::Instance dm_instance;
+
+        /** Exception thrown if instantiating the component failed. */
+        boost::exception_ptr dm_error;
+
+        /** Construct a task instantiating the specified component. */
+        explicit InstantiateTask(const NetworkPlan::ComponentEntry& entry) :
+            dm_entry(&entry),
+            dm_instance(),
+            dm_error()
+        {
+        }
+    };
+
+    /**
+     * Run a task instantiating a component from within the specified arena,
+     * then count it as completed. The arena is that of the network, whose
+     * constructor is running on another thread. Any exception is captured
+     * so that the network's constructor can rethrow it.
+     */
+    void runInstantiateTask(const boost::shared_ptr<Arena>& arena,
+                            InstantiateTask& task,
+                            boost::atomic<std::size_t>& remaining)
+    {
+        {
+            Arena::Scope arena_scope(arena);
+            try
+            {
+                task.dm_instance = task.dm_entry->instantiate();
+            }
+            catch (...)
+            {
+                task.dm_error = boost::current_exception();
+            }
+        }
+        remaining.fetch_sub(1, boost::memory_order_release);
+    }
+    
+    /**
+     * Compiled plans of the component networks instantiated so far, keyed by
+     * the root node of their XML tree. Each plan is compiled by the first
+     * thread to instantiate its network, while holding only that network's
+     * lock, so that different networks can be compiled concurrently. A plan
+     * that fails to compile isn't cached, and is compiled again by the next
+     * instantiation. Deliberately never destroyed so that components can still
+     * be instantiated during static C++ destruction.
+     */
+    struct PlanCache
+    {
+        /** Plan of one component network. */
+        struct Entry :
+            private boost::noncopyable
+        {
+            /** Mutual exclusion lock for this entry. */
+            boost::mutex dm_mutex;
+            
+            /** Document containing the network's XML tree. */
+            boost::shared_ptr<xercesc::DOMDocument> dm_document;
+
+            /** Plan of the network, or null if not yet compiled. */
+            boost::shared_ptr<const NetworkPlan> dm_plan;
+        };
+
+        /** Mutual exclusion lock for this cache. */
+        boost::mutex dm_mutex;
+
+        /** Entries keyed by the root node of their network's XML tree. */
+        std::map<const xercesc::DOMNode*, boost::shared_ptr<Entry> > dm_entries;
+    };
+
+    /**
+     * Get the plan of the component network in the specified XML tree,
+     * compiling it if necessary. The entry holds onto the document so that
+     * the root node remains valid as a key for as long as the entry exists.
+     */
+    boost::shared_ptr<const NetworkPlan> getPlan(
+        const boost::shared_ptr<xercesc::DOMDocument>& document,
+        const xercesc::DOMNode* root
+        )
+    {
+        static PlanCache* the_cache = new PlanCache();
+
+        boost::shared_ptr<PlanCache::Entry> entry;
+        {
+            boost::mutex::scoped_lock guard_cache(the_cache->dm_mutex);
+            boost::shared_ptr<PlanCache::Entry>& cached =
+                the_cache->dm_entries[root];
+            if (!cached)
+            {
+                cached.reset(new PlanCache::Entry());
+                cached->dm_document = document;
+            }
+            entry = cached;
+        }
+
+        boost::mutex::scoped_lock guard_entry(entry->dm_mutex);
+        if (!entry->dm_plan)
+        {
+            entry->dm_plan = compilePlan(root);
+        }
+        return entry->dm_plan;
+    }
     
 } // namespace <anonymous>
 
@@ -96,6 +258,7 @@ void Network::registerXML(
     )
 {
     Component::registerFactoryFunction(
+        describeXML(root),
         boost::bind(&Network::factoryFunction, document, root)
         );
 }
@@ -103,46 +266,22 @@ void Network::registerXML(
 
 
 //------------------------------------------------------------------------------
+// Get the network's plan, compiling it (and registering the network's plugins)
+// if this is the first instantiation, then construct the network. The network,
+// and everything constructed along with it, is allocated from the network's
+// arena.
 //------------------------------------------------------------------------------
 Component::Instance Network::factoryFunction(
     const boost::shared_ptr<xercesc::DOMDocument>& document,
     const xercesc::DOMNode* root
     )
 {
-    std::vector<boost::filesystem::path> search_paths, plugin_paths;
+    boost::shared_ptr<const NetworkPlan> plan = getPlan(document, root);
     
-    xercesc::selectNodes(root, "./SearchPath",
-                         boost::bind(&pushPath, _1, boost::ref(search_paths)));
-    xercesc::selectNodes(root, "./Plugin",
-                         boost::bind(&pushPath, _1, boost::ref(plugin_paths)));
-    
-    for (std::vector<boost::filesystem::path>::const_iterator
-             i = plugin_paths.begin(); i != plugin_paths.end(); ++i)
-    {
-        boost::filesystem::path resolved_path = resolvePath(search_paths, *i);
-
-        if (boost::filesystem::extension(resolved_path) == ".xml")
-        {
-            ::registerPlugin(
-                resolved_path.empty() ? *i : resolved_path
-                );
-        }
-        else
-        {
-            Component::registerPlugin(
-                resolved_path.empty() ? *i : resolved_path
-                );
-        }
-    }
+    Arena::Scope arena_scope(Arena::acquire());
     
     return Component::Instance(
-        reinterpret_cast<Component*>(
-            new Network(
-                Type(xercesc::selectValue(root, "./Type")),
-                Version(xercesc::selectValue(root, "./Version")),
-                document, root
-                )
-            )
+        reinterpret_cast<Component*>(new Network(*plan))
         );
 }
 
@@ -157,162 +296,152 @@ Network::~Network()
 
 
 //------------------------------------------------------------------------------
-// Parse the specified <Network> XML node, construct the corresponding component
-// network, and declare that network's inputs and outputs.
+// The connections within the network are left intact. Only the components in
+// the network need to be reset.
 //------------------------------------------------------------------------------
-Network::Network(const Type& type, const Version& version,
-                 const boost::shared_ptr<xercesc::DOMDocument>& /* Unused */,
-                 const xercesc::DOMNode* root) :
-    Component(type, version),
-    dm_components(),
-    dm_mediators()
+bool Network::reset()
 {
-    xercesc::selectNodes(root, "./Component",
-                         boost::bind(&Network::parseComponent, this, _1));
-    xercesc::selectNodes(root, "./Input",
-                         boost::bind(&Network::parseInput, this, _1));
-    xercesc::selectNodes(root, "./Connection",
-                         boost::bind(&Network::parseConnection, this, _1));
-    xercesc::selectNodes(root, "./Output",
-                         boost::bind(&Network::parseOutput, this, _1));
+    for (std::vector<Component::Instance>::const_iterator
+             i = dm_components.begin(); i != dm_components.end(); ++i)
+    {
+        if (!resetComponent(*i))
+        {
+            return false;
+        }
+    }
+    return true;
 }
-        
+
 
 
 //------------------------------------------------------------------------------
-// Parse the specified <Component> XML node, attempt to instantiate a component
-// of the requested type, and then add the instance to the network's components.
+// Run the specified plan: instantiate the components, make them asynchronous if
+// so requested, then construct the network's inputs, the connections, and
+// finally the network's outputs. Everything after the instantiation is done in
+// the order given by the plan.
 //------------------------------------------------------------------------------
-void Network::parseComponent(const xercesc::DOMNode* node)
+Network::Network(const NetworkPlan& plan) :
+    Component(plan.dm_type, plan.dm_version),
+    dm_components(),
+    dm_mediators()
 {
-    const std::string name = xercesc::selectValue(node, "./Name");
-    
-    if (dm_components.find(name) != dm_components.end())
+    instantiateComponents(plan);
+
+    for (std::vector<NetworkPlan::ComponentEntry>::size_type
+             i = 0; i < plan.dm_components.size(); ++i)
     {
-        raise<std::runtime_error>(
-            "The component name \"%1%\" isn't unique within the network.", name
-            );
+        if (plan.dm_components[i].dm_asynchronous)
+        {
+            Component::setAsynchronous(dm_components[i], true);
+        }
     }
 
-    const Type type(xercesc::selectValue(node, "./Type"));
+    dm_mediators.reserve(plan.dm_inputs.size() + plan.dm_outputs.size());
     
-    boost::optional<Version> minimum_version, maximum_version;
-
-    try
-    {
-        minimum_version = Version(
-            xercesc::selectValue(node, "./Version/@minimum")
-            );
-        maximum_version = Version(
-            xercesc::selectValue(node, "./Version/@maximum")
-            );
-    }
-    catch (...)
+    for (std::vector<NetworkPlan::InputEntry>::const_iterator
+             i = plan.dm_inputs.begin(); i != plan.dm_inputs.end(); ++i)
     {
+        constructInput(*i);
     }
 
-    if (!minimum_version && !maximum_version)
+    for (std::vector<NetworkPlan::ConnectionEntry>::const_iterator
+             i = plan.dm_connections.begin();
+         i != plan.dm_connections.end();
+         ++i)
     {
-        dm_components.insert(
-            std::make_pair(name, Component::instantiate(type))
-            );
+        Component::connect(dm_components[i->dm_from], i->dm_from_output,
+                           dm_components[i->dm_to], i->dm_to_input,
+                           i->dm_asynchronous);
     }
-    else
-    {
-        boost::optional<Version> version;
-
-        const std::set<Version> available_versions = 
-            Component::getAvailableVersions(type);
-        
-        for (std::set<Version>::const_iterator i = available_versions.begin();
-             i != available_versions.end();
-             ++i)
-        {
-            if ((!minimum_version || (*i >= minimum_version)) &&
-                (!maximum_version || (*i <= maximum_version)) &&
-                (!version || (*i > version)))
-            {
-                version = *i;
-            }
-        }
-
-        if (!version)
-        {
-            raise<std::runtime_error>(
-                "No suitable version in the range [%1%, %2%] "
-                "found for the component named \"%3%\".",
-                minimum_version, maximum_version, name
-                );
-        }
 
-        dm_components.insert(
-            std::make_pair(name, Component::instantiate(type, version.get()))
-            );
+    for (std::vector<NetworkPlan::OutputEntry>::const_iterator
+             i = plan.dm_outputs.begin(); i != plan.dm_outputs.end(); ++i)
+    {
+        constructOutput(*i);
     }
 }
 
 
 
 //------------------------------------------------------------------------------
-// Parse the specified <Connection> XML node, locate the requested components
-// within this network, and then establish the connection.
+// When parallel instantiation is enabled, instantiate each component in a
+// separate task of the thread pool, so that the components' constructors can
+// run concurrently. The calling thread helps run those tasks while waiting for
+// them to complete. The instances are then added to this network in the plan's
+// order, and the first of any exceptions, again in the plan's order, is thrown
+// again.
 //------------------------------------------------------------------------------
-void Network::parseConnection(const xercesc::DOMNode* node)
+void Network::instantiateComponents(const NetworkPlan& plan)
 {
-    const std::string from_name = xercesc::selectValue(node, "./From/Name");
-    const std::string from_output = xercesc::selectValue(node, "./From/Output");
-
-    const ComponentMap::iterator from = dm_components.find(from_name);
-
-    if (from == dm_components.end())
+    dm_components.reserve(plan.dm_components.size());
+    
+    if ((plan.dm_components.size() < 2) || !isParallelEnabled())
     {
-        raise<std::runtime_error>(
-            "The component name \"%1%\" isn't found within the network.",
-            from_name
-            );
+        for (std::vector<NetworkPlan::ComponentEntry>::const_iterator
+                 i = plan.dm_components.begin();
+             i != plan.dm_components.end();
+             ++i)
+        {
+            dm_components.push_back(i->instantiate());
+        }
+        return;
+    }
+    
+    std::vector<InstantiateTask> tasks;
+    tasks.reserve(plan.dm_components.size());
+    for (std::vector<NetworkPlan::ComponentEntry>::const_iterator
+             i = plan.dm_components.begin(); i != plan.dm_components.end(); ++i)
+    {
+        tasks.push_back(InstantiateTask(*i));
     }
 
-    const std::string to_name = xercesc::selectValue(node, "./To/Name");
-    const std::string to_input = xercesc::selectValue(node, "./To/Input");
-
-    const ComponentMap::iterator to = dm_components.find(to_name);
-
-    if (to == dm_components.end())
+    const boost::shared_ptr<Arena> arena = Arena::current();
+    
+    boost::atomic<std::size_t> remaining(tasks.size());
+    for (std::vector<InstantiateTask>::iterator
+             i = tasks.begin(); i != tasks.end(); ++i)
     {
-        raise<std::runtime_error>(
-            "The component name \"%1%\" isn't found within the network.",
-            to_name
-            );
+        Executor::instance().submit(boost::bind(
+            &runInstantiateTask, arena, boost::ref(*i), boost::ref(remaining)
+            ));
+    }
+    
+    // Tasks run while waiting needn't belong to this network, so they must
+    // not allocate from its arena
+    {
+        Arena::Scope arena_scope((boost::shared_ptr<Arena>()));
+        while (remaining.load(boost::memory_order_acquire) > 0)
+        {
+            if (!Executor::instance().runPendingTask())
+            {
+                boost::this_thread::yield();
+            }
+        }
     }
 
-    Component::connect(from->second, from_output, to->second, to_input);
+    for (std::vector<InstantiateTask>::const_iterator
+             i = tasks.begin(); i != tasks.end(); ++i)
+    {
+        if (i->dm_error)
+        {
+            boost::rethrow_exception(i->dm_error);
+        }
+        dm_components.push_back(i->dm_instance);
+    }
 }
 
 
 
 //------------------------------------------------------------------------------
-// Parse the specified <Input> XML node, locate the requested component
-// within this network, create an appropriate input mediator, establish
-// the connection, and declare the input.
+// Create an appropriate input mediator, establish the connection, and declare
+// the input.
 //------------------------------------------------------------------------------
-void Network::parseInput(const xercesc::DOMNode* node)
+void Network::constructInput(const NetworkPlan::InputEntry& entry)
 {
-    const std::string input_name = xercesc::selectValue(node, "./Name");
-
-    const std::string to_name = xercesc::selectValue(node, "./To/Name");
-    const std::string to_input = xercesc::selectValue(node, "./To/Input");
-
-    const ComponentMap::iterator to = dm_components.find(to_name);
-
-    if (to == dm_components.end())
-    {
-        raise<std::runtime_error>(
-            "The component name \"%1%\" isn't found within the network.",
-            to_name
-            );
-    }
-
-    std::map<std::string, Type> to_inputs = to->second->getInputs();
+    const Component::Instance& to = dm_components[entry.dm_to];
+    const std::string& to_input = entry.dm_to_input;
+    
+    const std::map<std::string, Type>& to_inputs = to->getInputs();
     
     std::map<std::string, Type>::const_iterator i = to_inputs.find(to_input);
     
@@ -330,43 +459,29 @@ void Network::parseInput(const xercesc::DOMNode* node)
     Component::Instance input_mediator_instance =
         boost::reinterpret_pointer_cast<Component>(input_mediator);
     
-    Component::connect(
-        input_mediator_instance, "value", to->second, to_input
-        );
+    Component::connect(input_mediator_instance, "value", to, to_input);
     
     dm_mediators.push_back(input_mediator_instance);
     
     declareInput(
-        input_name, i->second, 
-        boost::bind(&InputMediator::handler, input_mediator.get(), _1)
+        entry.dm_name, i->second, 
+        boost::bind(&InputMediator::handler, input_mediator.get(), _1),
+        boost::bind(&InputMediator::batchHandler, input_mediator.get(), _1)
         );
 }
 
 
 
 //------------------------------------------------------------------------------
-// Parse the specified <Output> XML node, locate the requested component
-// within this network, create an appropriate output mediator, establish
-// the connection, and declare the output.
+// Create an appropriate output mediator, establish the connection, and declare
+// the output.
 //------------------------------------------------------------------------------
-void Network::parseOutput(const xercesc::DOMNode* node)
+void Network::constructOutput(const NetworkPlan::OutputEntry& entry)
 {
-    const std::string output_name = xercesc::selectValue(node, "./Name");
+    const Component::Instance& from = dm_components[entry.dm_from];
+    const std::string& from_output = entry.dm_from_output;
     
-    const std::string from_name = xercesc::selectValue(node, "./From/Name");
-    const std::string from_output = xercesc::selectValue(node, "./From/Output");
-    
-    const ComponentMap::iterator from = dm_components.find(from_name);
-
-    if (from == dm_components.end())
-    {
-        raise<std::runtime_error>(
-            "The component name \"%1%\" isn't found within the network.",
-            from_name
-            );
-    }
-
-    std::map<std::string, Type> from_outputs = from->second->getOutputs();
+    const std::map<std::string, Type>& from_outputs = from->getOutputs();
     
     std::map<std::string, Type>::const_iterator i =
         from_outputs.find(from_output);
@@ -383,9 +498,15 @@ void Network::parseOutput(const xercesc::DOMNode* node)
             i->second,
             boost::bind(
                 (void (Component::*)(
-                    const std::string&, const Type&, const boost::any&
+                    const std::string&, const Type&, const Value&
                     ))(&Network::emitOutput),
-                this, output_name, i->second, _1
+                this, entry.dm_name, i->second, _1
+                ),
+            boost::bind(
+                (void (Component::*)(
+                    const std::string&, const Type&, const Batch&
+                    ))(&Network::emitOutputBatch),
+                this, entry.dm_name, i->second, _1
                 )
             )
         );
@@ -393,11 +514,9 @@ void Network::parseOutput(const xercesc::DOMNode* node)
     Component::Instance output_mediator_instance =
         boost::reinterpret_pointer_cast<Component>(output_mediator);
 
-    Component::connect(
-        from->second, from_output, output_mediator_instance, "value"
-        );
+    Component::connect(from, from_output, output_mediator_instance, "value");
 
     dm_mediators.push_back(output_mediator_instance);
     
-    declareOutput(output_name, i->second);
+    declareOutput(entry.dm_name, i->second);
 }
@@ -24,17 +24,20 @@
 #include <KrellInstitute/CBTF/Component.hpp>
 #include <KrellInstitute/CBTF/Type.hpp>
 #include <KrellInstitute/CBTF/Version.hpp>
-#include <map>
 #include <string>
 #include <vector>
 #include <xercesc/dom/DOM.hpp>
 
+#include "NetworkPlan.hpp"
+
 namespace KrellInstitute { namespace CBTF { namespace Impl {
 
     /**
      * Container for a network of connected components. The components to be
      * instantiated, the connections between them, and the inputs and outputs
-     * exposed outside the network, are specified by an XML tree.
+     * exposed outside the network, are specified by an XML tree. That tree is
+     * compiled into a NetworkPlan the first time the network is instantiated,
+     * and the plan is reused by every subsequent instantiation.
      */
     class Network :
         public Component
@@ -77,43 +80,45 @@ namespace KrellInstitute { namespace CBTF { namespace Impl {
          * component network.
          */
         virtual ~Network();
-        
-    private:
+
+    protected:
 
         /**
-         * Type of associative container used to map between the names of
-         * component instances and the component instances themselves.
+         * Reset this component network so that it can be recycled. The
+         * network can only be recycled if all of its components can be.
+         *
+         * @return    Boolean "true" if this component network was reset,
+         *            or "false" if it cannot be recycled.
          */
-        typedef std::map<std::string, Component::Instance> ComponentMap;
+        virtual bool reset();
+        
+    private:
 
         /**
-         * Construct a new component network from the specified XML tree.
+         * Construct a new component network from the specified plan.
          *
-         * @param type        Type of this component network.
-         * @param version     Version of this component network.
-         * @param document    Document containing the XML tree describing
-         *                    the component network to be constructed.
-         * @param root        Root node of the XML tree describing the
-         *                    component network to be constructed.
+         * @param plan    Plan of the component network to be constructed.
          */
-        Network(const Type& type, const Version& version,
-                const boost::shared_ptr<xercesc::DOMDocument>& document,
-                const xercesc::DOMNode* root);
+        Network(const NetworkPlan& plan);
         
-        /** Parse the specified ComponentType node. */
-        void parseComponent(const xercesc::DOMNode* node);
-        
-        /** Parse the specified ConnectionType node. */
-        void parseConnection(const xercesc::DOMNode* node);
+        /**
+         * Instantiate the components of this network, concurrently if the
+         * CBTF_NETWORK_PARALLEL environment variable enables it and there
+         * is more than one of them.
+         */
+        void instantiateComponents(const NetworkPlan& plan);
         
-        /** Parse the specified InputType node. */
-        void parseInput(const xercesc::DOMNode* node);
+        /** Construct the specified input of this network. */
+        void constructInput(const NetworkPlan::InputEntry& entry);
         
-        /** Parse the specified OutputType node. */
-        void parseOutput(const xercesc::DOMNode* node);
+        /** Construct the specified output of this network. */
+        void constructOutput(const NetworkPlan::OutputEntry& entry);
 
-        /** Component instances in this network. */
-        ComponentMap dm_components;
+        /**
+         * Component instances in this network, in the same order as the
+         * components in the network's plan.
+         */
+        std::vector<Component::Instance> dm_components;
 
         /** Mediators in this network. */
         std::vector<Component::Instance> dm_mediators;
@@ -0,0 +1,250 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2026 Krell Institute. All Rights Reserved.
+//
+// This program is free software; you can redistribute it and/or modify it under
+// the terms of the GNU General Public License as published by the Free Software
+// Foundation; either version 2 of the License, or (at your option) any later
+// version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+// details.
+//
+// You should have received a copy of the GNU General Public License along with
+// this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+// Place, Suite 330, Boston, MA  02111-1307  USA
+////////////////////////////////////////////////////////////////////////////////
+
+/** @file Definition of the NetworkPlan class. */
+
+#include <boost/bind.hpp>
+#include <boost/optional/optional_io.hpp>
+#include <boost/ref.hpp>
+#include <set>
+#include <stdexcept>
+
+#include "NetworkPlan.hpp"
+#include "Raise.hpp"
+#include "XercesExts.hpp"
+
+using namespace KrellInstitute::CBTF;
+using namespace KrellInstitute::CBTF::Impl;
+
+
+
+/** Anonymous namespace hiding implementation details. */
+namespace {
+
+    /**
+     * Is the specified node flagged, via its optional "asynchronous" attribute,
+     * as being asynchronous?
+     */
+    bool isAsynchronous(const xercesc::DOMNode* node)
+    {
+        try
+        {
+            const std::string value =
+                xercesc::selectValue(node, "./@asynchronous");
+            return (value == "true") || (value == "1");
+        }
+        catch (...)
+        {
+        }
+        return false;
+    }
+    
+} // namespace <anonymous>
+
+
+
+//------------------------------------------------------------------------------
+// Choose the latest available version within the range, if there is a range.
+// The available versions are looked up for every instantiation, rather than
+// being resolved when the plan is compiled, so that versions registered after
+// the plan was compiled are still considered.
+//------------------------------------------------------------------------------
+Component::Instance NetworkPlan::ComponentEntry::instantiate() const
+{
+    if (!dm_minimum_version && !dm_maximum_version)
+    {
+        return Component::instantiate(dm_type);
+    }
+
+    boost::optional<Version> version;
+    
+    const std::set<Version> available_versions = 
+        Component::getAvailableVersions(dm_type);
+    
+    for (std::set<Version>::const_iterator i = available_versions.begin();
+         i != available_versions.end();
+         ++i)
+    {
+        if ((!dm_minimum_version || (*i >= dm_minimum_version)) &&
+            (!dm_maximum_version || (*i <= dm_maximum_version)) &&
+            (!version || (*i > version)))
+        {
+            version = *i;
+        }
+    }
+    
+    if (!version)
+    {
+        raise<std::runtime_error>(
+            "No suitable version in the range [%1%, %2%] "
+            "found for the component named \"%3%\".",
+            dm_minimum_version, dm_maximum_version, dm_name
+            );
+    }
+    
+    return Component::instantiate(dm_type, version.get());
+}
+
+
+
+//------------------------------------------------------------------------------
+// Parse the nodes in the same order in which the Network class originally
+// processed them, so that errors are reported in the same order.
+//------------------------------------------------------------------------------
+NetworkPlan::NetworkPlan(const xercesc::DOMNode* root) :
+    dm_type(xercesc::selectValue(root, "./Type")),
+    dm_version(xercesc::selectValue(root, "./Version")),
+    dm_search_paths(),
+    dm_plugin_paths(),
+    dm_components(),
+    dm_inputs(),
+    dm_connections(),
+    dm_outputs()
+{
+    xercesc::selectNodes(
+        root, "./SearchPath",
+        boost::bind(&NetworkPlan::parsePath, _1, boost::ref(dm_search_paths))
+        );
+    xercesc::selectNodes(
+        root, "./Plugin",
+        boost::bind(&NetworkPlan::parsePath, _1, boost::ref(dm_plugin_paths))
+        );
+    xercesc::selectNodes(root, "./Component",
+                         boost::bind(&NetworkPlan::parseComponent, this, _1));
+    xercesc::selectNodes(root, "./Input",
+                         boost::bind(&NetworkPlan::parseInput, this, _1));
+    xercesc::selectNodes(root, "./Connection",
+                         boost::bind(&NetworkPlan::parseConnection, this, _1));
+    xercesc::selectNodes(root, "./Output",
+                         boost::bind(&NetworkPlan::parseOutput, this, _1));
+}
+
+
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+void NetworkPlan::parsePath(const xercesc::DOMNode* node,
+                            std::vector<boost::filesystem::path>& paths)
+{
+    paths.push_back(xercesc::selectValue(node, "."));
+}
+
+
+
+//------------------------------------------------------------------------------
+// Parse the specified <Component> XML node, checking that the component's name
+// is unique, and reading the component's type and optional version range.
+//------------------------------------------------------------------------------
+void NetworkPlan::parseComponent(const xercesc::DOMNode* node)
+{
+    const std::string name = xercesc::selectValue(node, "./Name");
+
+    for (std::vector<ComponentEntry>::const_iterator
+             i = dm_components.begin(); i != dm_components.end(); ++i)
+    {
+        if (i->dm_name == name)
+        {
+            raise<std::runtime_error>(
+                "The component name \"%1%\" isn't unique within the network.",
+                name
+                );
+        }
+    }
+
+    ComponentEntry entry(Type(xercesc::selectValue(node, "./Type")));
+    entry.dm_name = name;
+
+    try
+    {
+        entry.dm_minimum_version = Version(
+            xercesc::selectValue(node, "./Version/@minimum")
+            );
+        entry.dm_maximum_version = Version(
+            xercesc::selectValue(node, "./Version/@maximum")
+            );
+    }
+    catch (...)
+    {
+    }
+
+    entry.dm_asynchronous = isAsynchronous(node);
+    
+    dm_components.push_back(entry);
+}
+
+
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+void NetworkPlan::parseConnection(const xercesc::DOMNode* node)
+{
+    ConnectionEntry entry;
+    entry.dm_from = findComponent(xercesc::selectValue(node, "./From/Name"));
+    entry.dm_from_output = xercesc::selectValue(node, "./From/Output");
+    entry.dm_to = findComponent(xercesc::selectValue(node, "./To/Name"));
+    entry.dm_to_input = xercesc::selectValue(node, "./To/Input");
+    entry.dm_asynchronous = isAsynchronous(node);
+    dm_connections.push_back(entry);
+}
+
+
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+void NetworkPlan::parseInput(const xercesc::DOMNode* node)
+{
+    InputEntry entry;
+    entry.dm_name = xercesc::selectValue(node, "./Name");
+    entry.dm_to = findComponent(xercesc::selectValue(node, "./To/Name"));
+    entry.dm_to_input = xercesc::selectValue(node, "./To/Input");
+    dm_inputs.push_back(entry);
+}
+
+
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+void NetworkPlan::parseOutput(const xercesc::DOMNode* node)
+{
+    OutputEntry entry;
+    entry.dm_name = xercesc::selectValue(node, "./Name");
+    entry.dm_from = findComponent(xercesc::selectValue(node, "./From/Name"));
+    entry.dm_from_output = xercesc::selectValue(node, "./From/Output");
+    dm_outputs.push_back(entry);
+}
+
+
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+std::size_t NetworkPlan::findComponent(const std::string& name) const
+{
+    for (std::vector<ComponentEntry>::size_type
+             i = 0; i < dm_components.size(); ++i)
+    {
+        if (dm_components[i].dm_name == name)
+        {
+            return i;
+        }
+    }
+
+    raise<std::runtime_error>(
+        "The component name \"%1%\" isn't found within the network.", name
+        );
+    return 0;
+}
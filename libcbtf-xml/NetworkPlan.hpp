@@ -0,0 +1,197 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2026 Krell Institute. All Rights Reserved.
+//
+// This program is free software; you can redistribute it and/or modify it under
+// the terms of the GNU General Public License as published by the Free Software
+// Foundation; either version 2 of the License, or (at your option) any later
+// version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+// details.
+//
+// You should have received a copy of the GNU General Public License along with
+// this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+// Place, Suite 330, Boston, MA  02111-1307  USA
+////////////////////////////////////////////////////////////////////////////////
+
+/** @file Declaration of the NetworkPlan class. */
+
+#pragma once
+
+#include <boost/filesystem.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/optional.hpp>
+#include <cstddef>
+#include <KrellInstitute/CBTF/Component.hpp>
+#include <KrellInstitute/CBTF/Type.hpp>
+#include <KrellInstitute/CBTF/Version.hpp>
+#include <string>
+#include <vector>
+#include <xercesc/dom/DOM.hpp>
+
+namespace KrellInstitute { namespace CBTF { namespace Impl {
+
+    /**
+     * Compiled form of the XML tree describing a network of connected
+     * components. Everything the Network class needs from the XML tree is
+     * extracted once, into an immutable plan, so that each instantiation of
+     * the network simply runs the plan rather than walking the XML tree.
+     * Components are referred to by their index within the plan, the names
+     * of components having been resolved when the plan was compiled.
+     */
+    class NetworkPlan :
+        private boost::noncopyable
+    {
+
+    public:
+
+        /** Component instantiated within the network. */
+        struct ComponentEntry
+        {
+            /** Name of the component within the network. */
+            std::string dm_name;
+
+            /** Type of the component. */
+            Type dm_type;
+
+            /** Optional minimum version of the component. */
+            boost::optional<Version> dm_minimum_version;
+
+            /** Optional maximum version of the component. */
+            boost::optional<Version> dm_maximum_version;
+
+            /** Is the component asynchronous? */
+            bool dm_asynchronous;
+
+            /** Construct an entry for a component of the given type. */
+            explicit ComponentEntry(const Type& type) :
+                dm_name(),
+                dm_type(type),
+                dm_minimum_version(),
+                dm_maximum_version(),
+                dm_asynchronous(false)
+            {
+            }
+
+            /**
+             * Instantiate the component, choosing the latest available
+             * version within the component's version range.
+             *
+             * @return    New instance of the component.
+             *
+             * @throw std::runtime_error    No suitable version of the
+             *                              component is available.
+             */
+            Component::Instance instantiate() const;
+        };
+
+        /** Connection between two components within the network. */
+        struct ConnectionEntry
+        {
+            /** Index of the component whose output is connected. */
+            std::size_t dm_from;
+
+            /** Name of the output. */
+            std::string dm_from_output;
+
+            /** Index of the component whose input is connected. */
+            std::size_t dm_to;
+
+            /** Name of the input. */
+            std::string dm_to_input;
+
+            /** Is the connection asynchronous? */
+            bool dm_asynchronous;
+        };
+
+        /** Input of the network, forwarded to the input of a component. */
+        struct InputEntry
+        {
+            /** Name of the network's input. */
+            std::string dm_name;
+
+            /** Index of the component receiving the input. */
+            std::size_t dm_to;
+
+            /** Name of that component's input. */
+            std::string dm_to_input;
+        };
+
+        /** Output of the network, forwarded from the output of a component. */
+        struct OutputEntry
+        {
+            /** Name of the network's output. */
+            std::string dm_name;
+
+            /** Index of the component emitting the output. */
+            std::size_t dm_from;
+
+            /** Name of that component's output. */
+            std::string dm_from_output;
+        };
+
+        /**
+         * Compile the specified XML tree.
+         *
+         * @param root    Root node of the XML tree describing the component
+         *                network to be compiled.
+         *
+         * @throw std::runtime_error    The specified XML tree is not of the
+         *                              correct format, or refers to component
+         *                              names not found in the network.
+         *
+         * @note    The root node of the provided XML tree must conform to
+         *          the NetworkType described in the "Network.xsd" schema.
+         */
+        explicit NetworkPlan(const xercesc::DOMNode* root);
+
+        /** Type of the network. */
+        Type dm_type;
+
+        /** Version of the network. */
+        Version dm_version;
+
+        /** Paths searched for the network's plugins. */
+        std::vector<boost::filesystem::path> dm_search_paths;
+
+        /** Paths of the network's plugins, in the order given. */
+        std::vector<boost::filesystem::path> dm_plugin_paths;
+
+        /** Components within the network, in the order given. */
+        std::vector<ComponentEntry> dm_components;
+
+        /** Inputs of the network, in the order given. */
+        std::vector<InputEntry> dm_inputs;
+
+        /** Connections within the network, in the order given. */
+        std::vector<ConnectionEntry> dm_connections;
+
+        /** Outputs of the network, in the order given. */
+        std::vector<OutputEntry> dm_outputs;
+
+    private:
+
+        /** Parse the specified ComponentType node. */
+        void parseComponent(const xercesc::DOMNode* node);
+        
+        /** Parse the specified ConnectionType node. */
+        void parseConnection(const xercesc::DOMNode* node);
+        
+        /** Parse the specified InputType node. */
+        void parseInput(const xercesc::DOMNode* node);
+        
+        /** Parse the specified OutputType node. */
+        void parseOutput(const xercesc::DOMNode* node);
+
+        /** Parse the specified SearchPath or Plugin node into a list. */
+        static void parsePath(const xercesc::DOMNode* node,
+                              std::vector<boost::filesystem::path>& paths);
+        
+        /** Find the index of the named component within the network. */
+        std::size_t findComponent(const std::string& name) const;
+        
+    }; // class NetworkPlan
+            
+} } } // namespace KrellInstitute::CBTF::Impl
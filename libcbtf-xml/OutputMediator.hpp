@@ -20,9 +20,10 @@
 
 #pragma once
 
-#include <boost/any.hpp>
 #include <boost/function.hpp>
 #include <KrellInstitute/CBTF/Component.hpp>
+#include <KrellInstitute/CBTF/Impl/Batch.hpp>
+#include <KrellInstitute/CBTF/Impl/Value.hpp>
 #include <KrellInstitute/CBTF/Type.hpp>
 #include <KrellInstitute/CBTF/Version.hpp>
 #include <typeinfo>
@@ -52,23 +53,29 @@ namespace KrellInstitute { namespace CBTF { namespace Impl {
         /**
          * Construct a new mediator for an output.
          *
-         * @param type       Type of the output being mediated.
-         * @param handler    Handler for the output being mediated.
+         * @param type             Type of the output being mediated.
+         * @param handler          Handler for the output being mediated.
+         * @param batch_handler    Batch handler for the output being mediated.
          */
         OutputMediator(
             const Type& type,
-            const boost::function<void (const boost::any&)>& handler
+            const boost::function<void (const Value&)>& handler,
+            const boost::function<void (const Batch&)>& batch_handler
             ) :
             Component(Type(typeid(OutputMediator)), Version(0, 0, 0)),
-            dm_handler(handler)
+            dm_handler(handler),
+            dm_batch_handler(batch_handler)
         {
-            declareInput("value", type, handler);
+            declareInput("value", type, handler, batch_handler);
         }
         
     private:
 
         /** Handler for the output being mediated. */
-        const boost::function<void (const boost::any&)> dm_handler;
+        const boost::function<void (const Value&)> dm_handler;
+
+        /** Batch handler for the output being mediated. */
+        const boost::function<void (const Batch&)> dm_batch_handler;
         
     }; // class OutputMediator
 
@@ -19,7 +19,15 @@
 /** @file Definition of the XML functions. */
 
 #include <boost/bind.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/filesystem/fstream.hpp>
+#include <boost/format.hpp>
+#include <boost/ref.hpp>
+#include <cstdlib>
 #include <KrellInstitute/CBTF/XML.hpp>
+#include <set>
+#include <stdexcept>
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -66,6 +74,117 @@ namespace {
         xercesc::XMLString::release(&transcoded_node_name);
     }
 
+    /** Insert the value of the <Name> of the specified node into a set. */
+    void insertName(const xercesc::DOMNode* node, std::set<std::string>& names)
+    {
+        names.insert(xercesc::selectValue(node, "./Name"));
+    }
+
+    /**
+     * Get the directory holding the binary forms of registered XML documents.
+     * The cache is disabled unless the CBTF_XML_CACHE environment variable
+     * specifies the directory. Setting it to "0" also disables the cache.
+     *
+     * @return    Path of the directory, or an empty path if the cache is
+     *            disabled.
+     */
+    boost::filesystem::path getCacheDirectory()
+    {
+        const char* value = getenv("CBTF_XML_CACHE");
+        if ((value == NULL) || (std::string(value) == "") ||
+            (std::string(value) == "0"))
+        {
+            return boost::filesystem::path();
+        }
+        return boost::filesystem::path(value);
+    }
+
+    /**
+     * Add the contents of the specified file to a 64-bit FNV-1a hash.
+     *
+     * @param path      Path of the file.
+     * @retval hash     Hash to which the file's contents are added.
+     * @return          Boolean "true" if the file was read, or "false"
+     *                  otherwise.
+     */
+    bool hashFile(const boost::filesystem::path& path, boost::uint64_t& hash)
+    {
+        boost::filesystem::ifstream stream(
+            path, std::ios::in | std::ios::binary
+            );
+        if (!stream)
+        {
+            return false;
+        }
+
+        char buffer[65536];
+        while (stream.read(buffer, sizeof(buffer)) || (stream.gcount() > 0))
+        {
+            for (std::streamsize i = 0; i < stream.gcount(); ++i)
+            {
+                hash = (hash ^ static_cast<unsigned char>(buffer[i])) *
+                    0x100000001B3ULL;
+            }
+        }
+
+        // Separate the contents of consecutive files
+        hash = (hash ^ 0xFF) * 0x100000001B3ULL;
+        
+        return !stream.bad();
+    }
+    
+    /**
+     * Load the specified XML document, using its binary form from the cache
+     * if the document and schemas are unchanged since the binary form was
+     * saved. Otherwise the document is parsed and its binary form is saved
+     * for next time. Failing to save the binary form is silently ignored.
+     */
+    boost::shared_ptr<xercesc::DOMDocument> loadDocument(
+        const boost::filesystem::path& path,
+        const std::vector<boost::filesystem::path>& schema_paths
+        )
+    {
+        const boost::filesystem::path directory = getCacheDirectory();
+
+        boost::uint64_t key = 0xCBF29CE484222325ULL;
+        bool cacheable = !directory.empty() && hashFile(path, key);
+        for (std::vector<boost::filesystem::path>::const_iterator
+                 i = schema_paths.begin();
+             cacheable && (i != schema_paths.end());
+             ++i)
+        {
+            cacheable = hashFile(*i, key);
+        }
+
+        if (!cacheable)
+        {
+            return xercesc::loadFromFile(path, schema_paths);
+        }
+        
+        const boost::filesystem::path cache_path = directory /
+            boost::str(boost::format("%016x.dom") % key);
+        
+        boost::shared_ptr<xercesc::DOMDocument> document =
+            xercesc::loadFromBinary(cache_path, key);
+        if (document)
+        {
+            return document;
+        }
+
+        document = xercesc::loadFromFile(path, schema_paths);
+
+        try
+        {
+            boost::filesystem::create_directories(directory);
+            xercesc::saveToBinary(document.get(), cache_path, key);
+        }
+        catch (const std::exception&)
+        {
+        }
+
+        return document;
+    }
+    
     /**
      * Statically initialized C++ structure registering the "Network" kind
      * of component network.
@@ -109,7 +228,7 @@ void KrellInstitute::CBTF::registerXML(const boost::filesystem::path& path)
     }
     
     boost::shared_ptr<xercesc::DOMDocument> document =
-        xercesc::loadFromFile(path, schema_paths);
+        loadDocument(path, schema_paths);
     
     xercesc::selectNodes(document.get(), "./*",
                          boost::bind(invokeHandler, document, _1));
@@ -134,6 +253,31 @@ void KrellInstitute::CBTF::Impl::registerKindOfComponentNetwork(
 
 
 
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+Component::Descriptor KrellInstitute::CBTF::Impl::describeXML(
+    const xercesc::DOMNode* root
+    )
+{
+    Component::Descriptor descriptor(
+        Type(xercesc::selectValue(root, "./Type")),
+        Version(xercesc::selectValue(root, "./Version"))
+        );
+
+    xercesc::selectNodes(
+        root, "./Input",
+        boost::bind(&insertName, _1, boost::ref(descriptor.dm_inputs))
+        );
+    xercesc::selectNodes(
+        root, "./Output",
+        boost::bind(&insertName, _1, boost::ref(descriptor.dm_outputs))
+        );
+
+    return descriptor;
+}
+
+
+
 //------------------------------------------------------------------------------
 //------------------------------------------------------------------------------
 Component::Instance KrellInstitute::CBTF::Impl::instantiateXML(
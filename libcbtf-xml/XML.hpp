@@ -44,6 +44,17 @@ namespace KrellInstitute { namespace CBTF { namespace Impl {
     void registerKindOfComponentNetwork(const std::string& tag,
                                         const DOMNodeHandler& handler);
 
+    /**
+     * Describe the component network in a XML tree without instantiating it.
+     * Only the type, version, and the names of the inputs and outputs are
+     * read, so none of the plugins used by the component network are loaded.
+     *
+     * @param root    Root node of the XML tree describing the component
+     *                network to be described.
+     * @return        Descriptor of that component network.
+     */
+    Component::Descriptor describeXML(const xercesc::DOMNode* root);
+
     /**
      * Instantiate a new component directly from a XML tree describing the
      * network of connected components. The component's type is <em>not</em>
@@ -18,16 +18,33 @@
 
 /** @file Definition of extensions to the standard Xerces-C++ library. */
 
+#include <algorithm>
+#include <boost/algorithm/string/classification.hpp>
+#include <boost/algorithm/string/split.hpp>
 #include <boost/algorithm/string/trim.hpp>
 #include <boost/bind.hpp>
+#include <boost/filesystem/fstream.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/noncopyable.hpp>
 #include <boost/ref.hpp>
-#include <boost/spirit/home/classic.hpp>
-#include <deque>
+#include <boost/thread/locks.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/shared_mutex.hpp>
+#include <cctype>
+#include <cstring>
+#include <fcntl.h>
+#include <map>
 #include <set>
 #include <stdexcept>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 #include <utility>
 #include <vector>
 #include <xercesc/framework/MemBufInputSource.hpp>
+#include <xercesc/framework/XMLGrammarPool.hpp>
+#include <xercesc/internal/XMLGrammarPoolImpl.hpp>
 #include <xercesc/parsers/XercesDOMParser.hpp>
 #include <xercesc/sax/ErrorHandler.hpp>
 #include <xercesc/sax/SAXParseException.hpp>
@@ -153,6 +170,99 @@ namespace {
 
     }; // class ParsingExceptionHandler
 
+    /**
+     * Process-wide pool of the schema grammars loaded so far. Every parser
+     * validating against schemas shares this pool, so that each schema is
+     * loaded, and fully checked, only once per process. Between loads the
+     * pool is locked, which makes Xerces-C++ use a synchronized string pool,
+     * so that any number of parsers can parse with it concurrently. They hold
+     * the pool's lock shared, while loading a new schema holds it exclusively.
+     * Deliberately never destroyed, since the pool can't be destroyed after
+     * the Xerces-C++ library has been terminated.
+     */
+    struct GrammarPool
+    {
+        /** Readers/writer lock for this pool. */
+        boost::shared_mutex dm_mutex;
+
+        /** Grammars loaded so far. */
+        XMLGrammarPool* dm_grammars;
+
+        /** Paths of the schemas whose grammars have been loaded. */
+        std::set<std::string> dm_loaded;
+
+        /** Default constructor. */
+        GrammarPool() :
+            dm_mutex(),
+            dm_grammars(
+                new XMLGrammarPoolImpl(XMLPlatformUtils::fgMemoryManager)
+                ),
+            dm_loaded()
+        {
+        }
+    };
+
+    /** Access the process-wide pool of schema grammars. */
+    GrammarPool& grammarPool()
+    {
+        static GrammarPool* the_pool = new GrammarPool();
+        return *the_pool;
+    }
+
+    /**
+     * Load any of the specified schemas not yet in the pool. Must be called
+     * while holding the pool's lock exclusively.
+     */
+    void loadGrammars(GrammarPool& pool,
+                      const std::vector<boost::filesystem::path>& schema_paths)
+    {
+        std::vector<boost::filesystem::path> missing;
+        for (std::vector<boost::filesystem::path>::const_iterator
+                 i = schema_paths.begin(); i != schema_paths.end(); ++i)
+        {
+            if (pool.dm_loaded.find(i->string()) == pool.dm_loaded.end())
+            {
+                missing.push_back(*i);
+            }
+        }
+        if (missing.empty())
+        {
+            return;
+        }
+
+        pool.dm_grammars->unlockPool();
+        try
+        {
+            XercesDOMParser parser(
+                NULL, XMLPlatformUtils::fgMemoryManager, pool.dm_grammars
+                );
+            ParsingExceptionHandler handler;
+            parser.setErrorHandler(&handler);
+            parser.setDoNamespaces(true);
+            parser.setDoSchema(true);
+            parser.setValidationSchemaFullChecking(true);
+            
+            for (std::vector<boost::filesystem::path>::const_iterator
+                     i = missing.begin(); i != missing.end(); ++i)
+            {
+                if (parser.loadGrammar(i->string().c_str(),
+                                       Grammar::SchemaGrammarType,
+                                       true) != NULL)
+                {
+                    pool.dm_loaded.insert(i->string());
+                }
+            }
+
+            handler.throwExceptions();
+        }
+        catch (...)
+        {
+            pool.dm_grammars->lockPool();
+            throw;
+        }
+        pool.dm_grammars->lockPool();
+    }
+    
     /**
      * Deleter for documents.
      *
@@ -198,166 +308,754 @@ namespace {
         }
     }
 
+    /** Magic number identifying the binary form of a document. */
+    const char kBinaryMagic[8] = { 'C', 'B', 'T', 'F', 'D', 'O', 'M', '1' };
+
+    /** Index of a string that isn't present (e.g. no namespace). */
+    const boost::uint32_t kNoString = 0xFFFFFFFF;
+    
     /**
-     * Parse the specified XPath expression for the given node, applying
-     * the specified function for each matching node.
+     * Writer of the binary form of a document. The binary form consists of:
+     *
+     *     - The magic number.
+     *     - The 64-bit key and the 32-bit number of strings and of words.
+     *     - Each distinct string, as its 32-bit length in characters followed
+     *       by its null-terminated UTF-16 characters, padded to 32 bits.
+     *     - The nodes as a preorder sequence of 32-bit words. Each node is its
+     *       type, the string index of its namespace and of its name (element)
+     *       or data (anything else), its number of attributes and children,
+     *       the string indices of each attribute's namespace, name and value,
+     *       and then its children.
+     *
+     * Strings are kept in the same UTF-16 encoding used by the DOM so that no
+     * transcoding is needed in either direction.
      */
-    void parse(const DOMNode* root, const std::string& expression,
-               const boost::function<void (const DOMNode*)>& function)
+    class BinaryWriter :
+        private boost::noncopyable
     {
-        using namespace boost::spirit::classic;
 
-        std::vector<std::string> path;
+    public:
 
-        parse(expression.c_str(),
-              list_p((*anychar_p)[push_back_a(path)], ch_p('/')),
-              space_p);
+        /** Construct the binary form of the specified document. */
+        explicit BinaryWriter(const DOMDocument* document) :
+            dm_strings(),
+            dm_indices(),
+            dm_words()
+        {
+            addChildren(document);
+        }
 
-        if (path.empty())
+        /** Write the binary form to a stream. */
+        void write(std::ostream& stream, const boost::uint64_t& key) const
         {
-            return;
+            stream.write(kBinaryMagic, sizeof(kBinaryMagic));
+            writeWord(stream, key);
+            writeWord(stream, static_cast<boost::uint32_t>(dm_strings.size()));
+            writeWord(stream, static_cast<boost::uint32_t>(dm_words.size()));
+            
+            for (std::vector<std::vector<XMLCh> >::const_iterator
+                     i = dm_strings.begin(); i != dm_strings.end(); ++i)
+            {
+                writeWord(stream, static_cast<boost::uint32_t>(i->size()));
+                stream.write(reinterpret_cast<const char*>(&(*i)[0]),
+                             i->size() * sizeof(XMLCh));
+                if ((i->size() * sizeof(XMLCh)) % 4 != 0)
+                {
+                    stream.write("\0\0", 4 - (i->size() * sizeof(XMLCh)) % 4);
+                }
+            }
+
+            stream.write(reinterpret_cast<const char*>(&dm_words[0]),
+                         dm_words.size() * sizeof(boost::uint32_t));
         }
+        
+    private:
 
-        const DOMNode* initial_node = root;
-        std::vector<std::string>::size_type initial_index = 0;
+        /** Is the specified node saved in the binary form? */
+        static bool isSaved(const DOMNode* node)
+        {
+            switch (node->getNodeType())
+            {
+            case DOMNode::ELEMENT_NODE:
+            case DOMNode::TEXT_NODE:
+            case DOMNode::CDATA_SECTION_NODE:
+            case DOMNode::COMMENT_NODE:
+                return true;
+            default:
+                return false;
+            }
+        }
+        
+        /** Write a value to a stream in host byte order. */
+        template <typename T>
+        static void writeWord(std::ostream& stream, const T& value)
+        {
+            stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+        }
+        
+        /** Get the index of the specified string, adding it if necessary. */
+        boost::uint32_t intern(const XMLCh* string)
+        {
+            if (string == NULL)
+            {
+                return kNoString;
+            }
+
+            std::vector<XMLCh> value(
+                string, string + XMLString::stringLen(string) + 1
+                );
 
-        if (path[0].empty())
+            std::map<std::vector<XMLCh>, boost::uint32_t>::const_iterator i =
+                dm_indices.find(value);
+            if (i != dm_indices.end())
+            {
+                return i->second;
+            }
+            
+            const boost::uint32_t index =
+                static_cast<boost::uint32_t>(dm_strings.size());
+            dm_strings.push_back(value);
+            dm_indices.insert(std::make_pair(value, index));
+            return index;
+        }
+
+        /** Add the saved children of the specified node. */
+        void addChildren(const DOMNode* node)
         {
-            if (root->getNodeType() != DOMNode::DOCUMENT_NODE)
+            for (const DOMNode* child = node->getFirstChild();
+                 child != NULL;
+                 child = child->getNextSibling())
             {
-                if (root->getOwnerDocument() == NULL)
+                if (isSaved(child))
                 {
-                    raise<std::runtime_error>(
-                        "The root node has no owner document."
-                        );
+                    addNode(child);
                 }
-                initial_node = root->getOwnerDocument()->getDocumentElement();
             }
-            initial_index = 1;
         }
         
-        std::set<const DOMNode*> matches;
+        /** Add the specified node, and its saved children. */
+        void addNode(const DOMNode* node)
+        {
+            boost::uint32_t children = 0;
+            for (const DOMNode* child = node->getFirstChild();
+                 child != NULL;
+                 child = child->getNextSibling())
+            {
+                if (isSaved(child))
+                {
+                    ++children;
+                }
+            }
+            
+            const DOMNamedNodeMap* attributes = node->getAttributes();
+
+            dm_words.push_back(node->getNodeType());
+            if (node->getNodeType() == DOMNode::ELEMENT_NODE)
+            {
+                dm_words.push_back(intern(node->getNamespaceURI()));
+                dm_words.push_back(intern(node->getNodeName()));
+            }
+            else
+            {
+                dm_words.push_back(kNoString);
+                dm_words.push_back(intern(node->getNodeValue()));
+            }
+            dm_words.push_back(static_cast<boost::uint32_t>(
+                (attributes != NULL) ? attributes->getLength() : 0
+                ));
+            dm_words.push_back(children);
+
+            if (attributes != NULL)
+            {
+                for (XMLSize_t i = 0; i < attributes->getLength(); ++i)
+                {
+                    const DOMNode* attribute = attributes->item(i);
+                    dm_words.push_back(intern(attribute->getNamespaceURI()));
+                    dm_words.push_back(intern(attribute->getNodeName()));
+                    dm_words.push_back(intern(attribute->getNodeValue()));
+                }
+            }
+
+            addChildren(node);
+        }
+        
+        /** Distinct strings, in the order they were added. */
+        std::vector<std::vector<XMLCh> > dm_strings;
+
+        /** Map of the distinct strings to their index. */
+        std::map<std::vector<XMLCh>, boost::uint32_t> dm_indices;
+
+        /** Words of the nodes. */
+        std::vector<boost::uint32_t> dm_words;
+        
+    }; // class BinaryWriter
+
+    /**
+     * Reader rebuilding a document from its binary form in memory. Any
+     * inconsistency in the binary form causes the read to fail rather than
+     * reading outside of the binary form.
+     */
+    class BinaryReader :
+        private boost::noncopyable
+    {
+
+    public:
+
+        /** Construct a reader of the specified binary form. */
+        BinaryReader(const char* begin, const char* end) :
+            dm_begin(begin),
+            dm_end(end),
+            dm_strings(),
+            dm_words(NULL),
+            dm_words_end(NULL)
+        {
+        }
+
+        /**
+         * Read the binary form, rebuilding its document.
+         *
+         * @param key         Key with which the binary form must have been
+         *                    saved.
+         * @retval document   Document rebuilt from the binary form.
+         * @return            Boolean "true" if the document was rebuilt,
+         *                    or "false" otherwise.
+         */
+        bool read(const boost::uint64_t& key, DOMDocument*& document)
+        {
+            const char* ptr = dm_begin;
+
+            const char* magic = take(ptr, sizeof(kBinaryMagic));
+            boost::uint64_t saved_key = 0;
+            boost::uint32_t strings = 0, words = 0;
+            if ((magic == NULL) ||
+                !std::equal(kBinaryMagic, kBinaryMagic + sizeof(kBinaryMagic),
+                            magic) ||
+                !readWord(ptr, saved_key) || (saved_key != key) ||
+                !readWord(ptr, strings) || !readWord(ptr, words))
+            {
+                return false;
+            }
+            
+            for (boost::uint32_t i = 0; i < strings; ++i)
+            {
+                boost::uint32_t length = 0;
+                if (!readWord(ptr, length) || (length == 0))
+                {
+                    return false;
+                }
+                const std::size_t size = length * sizeof(XMLCh);
+                const XMLCh* string = reinterpret_cast<const XMLCh*>(
+                    take(ptr, size + ((size % 4 != 0) ? (4 - size % 4) : 0))
+                    );
+                if ((string == NULL) || (string[length - 1] != chNull))
+                {
+                    return false;
+                }
+                dm_strings.push_back(string);
+            }
+
+            dm_words = reinterpret_cast<const boost::uint32_t*>(
+                take(ptr, words * sizeof(boost::uint32_t))
+                );
+            if ((dm_words == NULL) || (ptr != dm_end))
+            {
+                return false;
+            }
+            dm_words_end = dm_words + words;
+            
+            // Malformed names or values make the DOM throw, which is treated
+            // like any other inconsistency in the binary form
+            document = DOMImplementation::getImplementation()->createDocument();
+            try
+            {
+                while (dm_words != dm_words_end)
+                {
+                    if (!readNode(document, document))
+                    {
+                        document->release();
+                        document = NULL;
+                        return false;
+                    }
+                }
+            }
+            catch (const DOMException&)
+            {
+                document->release();
+                document = NULL;
+                return false;
+            }
+            
+            return true;
+        }
+        
+    private:
+
+        /** Take the specified number of bytes, returning null if too few. */
+        const char* take(const char*& ptr, const std::size_t& size)
+        {
+            if (static_cast<std::size_t>(dm_end - ptr) < size)
+            {
+                ptr = dm_end;
+                return NULL;
+            }
+            const char* taken = ptr;
+            ptr += size;
+            return taken;
+        }
+
+        /** Read a value in host byte order. */
+        template <typename T>
+        bool readWord(const char*& ptr, T& value)
+        {
+            const char* taken = take(ptr, sizeof(T));
+            if (taken == NULL)
+            {
+                return false;
+            }
+            std::memcpy(&value, taken, sizeof(T));
+            return true;
+        }
         
-        for (std::deque<
-                 std::pair<const DOMNode*, std::vector<std::string>::size_type>
-                 > queue(1, std::make_pair(initial_node, initial_index));
-             !queue.empty();
-             queue.pop_front())
+        /** Read the next node word. */
+        bool readWord(boost::uint32_t& value)
         {
-            const DOMNode* node = queue.front().first;
-            std::vector<std::string>::size_type index = queue.front().second;
+            if (dm_words == dm_words_end)
+            {
+                return false;
+            }
+            value = *dm_words++;
+            return true;
+        }
 
-            if (index == path.size())
+        /** Read the next node word as a string, which may be absent. */
+        bool readString(const XMLCh*& value)
+        {
+            boost::uint32_t index = 0;
+            if (!readWord(index) ||
+                ((index != kNoString) && (index >= dm_strings.size())))
             {
-                matches.insert(node);
+                return false;
+            }
+            value = (index == kNoString) ? NULL : dm_strings[index];
+            return true;
+        }
+        
+        /** Read a node, and its children, appending it to the given parent. */
+        bool readNode(DOMDocument* document, DOMNode* parent)
+        {
+            boost::uint32_t type = 0, attributes = 0, children = 0;
+            const XMLCh* namespace_uri = NULL;
+            const XMLCh* value = NULL;
+            if (!readWord(type) || !readString(namespace_uri) ||
+                !readString(value) || (value == NULL) ||
+                !readWord(attributes) || !readWord(children))
+            {
+                return false;
             }
 
-            else if (path[index].empty() /* "//" */)
+            DOMNode* node = NULL;
+            switch (type)
             {
-                queue.push_back(std::make_pair(node, index + 1));
-                for (std::deque<const DOMNode*> all(1, node);
-                     !all.empty();
-                     all.pop_front())
+
+            case DOMNode::ELEMENT_NODE:
                 {
-                    DOMNodeList* children = all.front()->getChildNodes();
-                    for (XMLSize_t i = 0; i < children->getLength(); ++i)
+                    DOMElement* element = (namespace_uri != NULL) ?
+                        document->createElementNS(namespace_uri, value) :
+                        document->createElement(value);
+                    for (boost::uint32_t i = 0; i < attributes; ++i)
                     {
-                        DOMNode* child = children->item(i);
-                        if (child->getNodeType() == DOMNode::ELEMENT_NODE)
+                        const XMLCh* attribute_namespace_uri = NULL;
+                        const XMLCh* attribute_name = NULL;
+                        const XMLCh* attribute_value = NULL;
+                        if (!readString(attribute_namespace_uri) ||
+                            !readString(attribute_name) ||
+                            !readString(attribute_value) ||
+                            (attribute_name == NULL) ||
+                            (attribute_value == NULL))
                         {
-                            queue.push_back(std::make_pair(child, index + 1));
+                            element->release();
+                            return false;
+                        }
+                        if (attribute_namespace_uri != NULL)
+                        {
+                            element->setAttributeNS(attribute_namespace_uri,
+                                                    attribute_name,
+                                                    attribute_value);
+                        }
+                        else
+                        {
+                            element->setAttribute(attribute_name,
+                                                  attribute_value);
                         }
                     }
-                }                
+                    node = element;
+                }
+                break;
+
+            case DOMNode::TEXT_NODE:
+                node = document->createTextNode(value);
+                break;
+
+            case DOMNode::CDATA_SECTION_NODE:
+                node = document->createCDATASection(value);
+                break;
+
+            case DOMNode::COMMENT_NODE:
+                node = document->createComment(value);
+                break;
+
+            default:
+                return false;
+                
+            }
+
+            if ((type != DOMNode::ELEMENT_NODE) && (attributes != 0))
+            {
+                node->release();
+                return false;
             }
             
-            else if (path[index] == "*")
+            parent->appendChild(node);
+
+            for (boost::uint32_t i = 0; i < children; ++i)
             {
-                DOMNodeList* children = node->getChildNodes();
-                for (XMLSize_t i = 0; i < children->getLength(); ++i)
+                if (!readNode(document, node))
                 {
-                    DOMNode* child = children->item(i);
-                    if (child->getNodeType() == DOMNode::ELEMENT_NODE)
-                    {
-                        queue.push_back(std::make_pair(child, index + 1));
-                    }
+                    return false;
                 }
             }
+            
+            return true;
+        }
+        
+        /** Beginning of the binary form. */
+        const char* const dm_begin;
+
+        /** End of the binary form. */
+        const char* const dm_end;
 
-            else if (path[index] == "..")
+        /** Strings of the binary form. */
+        std::vector<const XMLCh*> dm_strings;
+
+        /** Next unread word of the nodes. */
+        const boost::uint32_t* dm_words;
+
+        /** End of the words of the nodes. */
+        const boost::uint32_t* dm_words_end;
+        
+    }; // class BinaryReader
+    
+    /**
+     * XPath expression compiled into its sequence of location steps, with
+     * the names in those steps transcoded ahead of time. Only the subset of
+     * the XPath language described in XercesExts.hpp is supported.
+     */
+    class Selector :
+        private boost::noncopyable
+    {
+
+    public:
+
+        /** Compile the specified XPath expression. */
+        explicit Selector(const std::string& expression) :
+            dm_absolute(false),
+            dm_sorted(true),
+            dm_steps()
+        {
+            std::string path;
+            for (std::string::const_iterator
+                     i = expression.begin(); i != expression.end(); ++i)
             {
-                if (node->getParentNode() == NULL)
+                if (!std::isspace(static_cast<unsigned char>(*i)))
+                {
+                    path += *i;
+                }
+            }
+
+            std::vector<std::string> names;
+            boost::algorithm::split(
+                names, path, boost::algorithm::is_any_of("/")
+                );
+
+            std::vector<std::string>::size_type initial_index = 0;
+            if (names[0].empty())
+            {
+                dm_absolute = true;
+                initial_index = 1;
+            }
+
+            for (std::vector<std::string>::size_type
+                     i = initial_index; i < names.size(); ++i)
+            {
+                Step step;
+                
+                if (names[i].empty() /* "//" */)
+                {
+                    step.dm_kind = Step::kSelfAndChildren;
+                    dm_sorted = false;
+                }
+                else if (names[i] == "*")
+                {
+                    step.dm_kind = Step::kChildren;
+                }
+                else if (names[i] == "..")
+                {
+                    step.dm_kind = Step::kParent;
+                    dm_sorted = false;
+                }
+                else if (names[i] == ".")
+                {
+                    step.dm_kind = Step::kSelf;
+                }
+                else if (names[i][0] == '@')
+                {
+                    step.dm_kind = Step::kAttribute;
+                    step.dm_name = transcode(names[i].substr(1));
+                }
+                else
+                {
+                    step.dm_kind = Step::kElement;
+                    step.dm_name = transcode(names[i]);
+                }
+
+                dm_steps.push_back(step);
+            }
+        }
+
+        /**
+         * Select the nodes matching this expression from the tree rooted at
+         * the given node, applying the specified function to each matching
+         * node in document order.
+         */
+        void select(
+            const DOMNode* root,
+            const boost::function<void (const DOMNode*)>& function
+            ) const
+        {
+            const DOMNode* initial_node = root;
+
+            if (dm_absolute && (root->getNodeType() != DOMNode::DOCUMENT_NODE))
+            {
+                if (root->getOwnerDocument() == NULL)
                 {
                     raise<std::runtime_error>(
-                        "The current node has no parent node."
+                        "The root node has no owner document."
                         );
                 }
-                queue.push_back(
-                    std::make_pair(node->getParentNode(), index + 1)
-                    );
+                initial_node = root->getOwnerDocument()->getDocumentElement();
             }
 
-            else if (path[index] == ".")
+            std::vector<const DOMNode*> nodes(1, initial_node);
+            std::vector<const DOMNode*> next;
+            
+            for (std::vector<Step>::const_iterator i = dm_steps.begin();
+                 !nodes.empty() && (i != dm_steps.end());
+                 ++i)
             {
-                queue.push_back(std::make_pair(node, index + 1));
+                next.clear();
+                
+                for (std::vector<const DOMNode*>::const_iterator
+                         j = nodes.begin(); j != nodes.end(); ++j)
+                {
+                    apply(*i, *j, next);
+                }
+
+                nodes.swap(next);
             }
 
-            else if (path[index][0] == '@')
+            // Steps that can reach a node more than once, or out of document
+            // order, require the matches to be put back into document order
+            if (!dm_sorted && (nodes.size() > 1))
             {
-                if (node->getNodeType() == DOMNode::ELEMENT_NODE)
-                {
-                    XMLCh* value = XMLString::transcode(&(path[index][1]));
-                    if (value == NULL)
-                    {
-                        raise<std::runtime_error>(
-                            "Transcoding of the attribute's name failed."
-                            );
-                    }
+                std::sort(nodes.begin(), nodes.end(), &precedes);
+                nodes.erase(std::unique(nodes.begin(), nodes.end()),
+                            nodes.end());
+            }
+            
+            for (std::vector<const DOMNode*>::const_iterator
+                     i = nodes.begin(); i != nodes.end(); ++i)
+            {
+                function(*i);
+            }
+        }
+        
+    private:
 
-                    DOMAttr* attribute = reinterpret_cast<const DOMElement*>(
-                        node
-                        )->getAttributeNode(value);
+        /** Single location step of an XPath expression. */
+        struct Step
+        {
+            /** Enumeration of the kinds of step. */
+            enum Kind
+            {
+                kSelfAndChildren,  /**< "//" */
+                kChildren,         /**< "*" */
+                kParent,           /**< ".." */
+                kSelf,             /**< "." */
+                kAttribute,        /**< "@name" */
+                kElement           /**< "name" */
+            };
 
-                    if (attribute != NULL)
-                    {
-                        queue.push_back(std::make_pair(attribute, index + 1));
-                    }
-                    
-                    XMLString::release(&value);
+            /** Kind of this step. */
+            Kind dm_kind;
+
+            /**
+             * Transcoded attribute or element name matched by this step,
+             * including its null terminator.
+             */
+            std::vector<XMLCh> dm_name;
+        };
+
+        /** Transcode the specified name. */
+        static std::vector<XMLCh> transcode(const std::string& name)
+        {
+            XMLCh* value = XMLString::transcode(name.c_str());
+            if (value == NULL)
+            {
+                raise<std::runtime_error>(
+                    "Transcoding of the node's name failed."
+                    );
+            }
+            std::vector<XMLCh> transcoded(
+                value, value + XMLString::stringLen(value) + 1
+                );
+            XMLString::release(&value);
+            return transcoded;
+        }
+
+        /** Does one node precede another in document order? */
+        static bool precedes(const DOMNode* lhs, const DOMNode* rhs)
+        {
+            return (lhs != rhs) &&
+                ((lhs->compareDocumentPosition(rhs) &
+                  DOMNode::DOCUMENT_POSITION_FOLLOWING) != 0);
+        }
+
+        /** Append the child elements of the given node to a list. */
+        static void children(const DOMNode* node,
+                             std::vector<const DOMNode*>& nodes)
+        {
+            for (const DOMNode* child = node->getFirstChild();
+                 child != NULL;
+                 child = child->getNextSibling())
+            {
+                if (child->getNodeType() == DOMNode::ELEMENT_NODE)
+                {
+                    nodes.push_back(child);
                 }
             }
+        }
 
-            else
+        /**
+         * Apply a step to the given node, appending the nodes it reaches,
+         * in document order, to a list.
+         */
+        static void apply(const Step& step, const DOMNode* node,
+                          std::vector<const DOMNode*>& nodes)
+        {
+            switch (step.dm_kind)
             {
-                XMLCh* value = XMLString::transcode(path[index].c_str());
-                if (value == NULL)
+
+            case Step::kSelfAndChildren:
+                nodes.push_back(node);
+                children(node, nodes);
+                break;
+
+            case Step::kChildren:
+                children(node, nodes);
+                break;
+
+            case Step::kParent:
+                if (node->getParentNode() == NULL)
                 {
                     raise<std::runtime_error>(
-                        "Transcoding of the node's name failed."
+                        "The current node has no parent node."
                         );
                 }
+                nodes.push_back(node->getParentNode());
+                break;
+
+            case Step::kSelf:
+                nodes.push_back(node);
+                break;
+
+            case Step::kAttribute:
+                if (node->getNodeType() == DOMNode::ELEMENT_NODE)
+                {
+                    const DOMAttr* attribute =
+                        reinterpret_cast<const DOMElement*>(
+                            node
+                            )->getAttributeNode(&step.dm_name[0]);
+                    if (attribute != NULL)
+                    {
+                        nodes.push_back(attribute);
+                    }
+                }
+                break;
 
-                DOMNodeList* children = node->getChildNodes();
-                for (XMLSize_t i = 0; i < children->getLength(); ++i)
+            case Step::kElement:
+                for (const DOMNode* child = node->getFirstChild();
+                     child != NULL;
+                     child = child->getNextSibling())
                 {
-                    DOMNode* child = children->item(i);
                     if ((child->getNodeType() == DOMNode::ELEMENT_NODE) &&
-                        XMLString::equals(child->getNodeName(), value))
+                        XMLString::equals(child->getNodeName(),
+                                          &step.dm_name[0]))
                     {
-                        queue.push_back(std::make_pair(child, index + 1));
+                        nodes.push_back(child);
                     }
                 }
+                break;
                 
-                XMLString::release(&value);
             }
-            
         }
+        
+        /** Is this expression an absolute path? */
+        bool dm_absolute;
+
+        /** Are the matches always unique and in document order? */
+        bool dm_sorted;
+
+        /** Location steps of this expression. */
+        std::vector<Step> dm_steps;
+        
+    }; // class Selector
 
-        for (std::set<const DOMNode*>::const_iterator
-                 i = matches.begin(); i != matches.end(); ++i)
+    /**
+     * Cache of compiled XPath expressions, keyed by the expressions. The
+     * helpers are invoked with a small, fixed set of expressions, so the
+     * cache is never pruned. Deliberately never destroyed so that it can
+     * still be used during static C++ destruction.
+     */
+    struct SelectorCache
+    {
+        /** Mutual exclusion lock for this cache. */
+        boost::mutex dm_mutex;
+
+        /** Compiled expressions. */
+        std::map<std::string, boost::shared_ptr<const Selector> > dm_selectors;
+    };
+
+    /**
+     * Get the compiled form of the specified XPath expression, compiling it
+     * only if it isn't already in the cache.
+     */
+    boost::shared_ptr<const Selector> compile(const std::string& expression)
+    {
+        static SelectorCache* the_cache = new SelectorCache();
+
+        boost::mutex::scoped_lock guard_cache(the_cache->dm_mutex);
+
+        std::map<
+            std::string, boost::shared_ptr<const Selector>
+            >::const_iterator i = the_cache->dm_selectors.find(expression);
+        if (i != the_cache->dm_selectors.end())
         {
-            function(*i);
+            return i->second;
         }
+
+        boost::shared_ptr<const Selector> selector(new Selector(expression));
+        the_cache->dm_selectors.insert(std::make_pair(expression, selector));
+        return selector;
     }
     
 } // namespace <anonymous>
@@ -365,6 +1063,9 @@ namespace {
 
 
 //------------------------------------------------------------------------------
+// Load any schemas missing from the grammar pool while holding the pool's lock
+// exclusively, then parse while holding it shared, so that documents using the
+// pool are parsed concurrently once their schemas have been loaded.
 //------------------------------------------------------------------------------
 boost::shared_ptr<DOMDocument> XERCES_CPP_NAMESPACE_QUALIFIER loadFromFile(
     const boost::filesystem::path& path,
@@ -380,8 +1081,55 @@ boost::shared_ptr<DOMDocument> XERCES_CPP_NAMESPACE_QUALIFIER loadFromFile(
             );
     }
 
+    for (std::vector<boost::filesystem::path>::const_iterator
+             i = schema_paths.begin(); i != schema_paths.end(); ++i)
+    {
+        if (!is_regular_file(*i))
+        {
+            raise<std::runtime_error>(
+                "The specified schema file (%1%) doesn't exist.", *i
+                );
+        }
+    }
+
+    GrammarPool& pool = grammarPool();
+    boost::shared_lock<boost::shared_mutex> guard_pool(
+        pool.dm_mutex, boost::defer_lock
+        );
+    
     DOMDocument* document = NULL;
-    XercesDOMParser* parser = new XercesDOMParser();
+    XercesDOMParser* parser = NULL;
+
+    if (schema_paths.empty())
+    {
+        parser = new XercesDOMParser();
+    }
+    else
+    {
+        // Grammars are never removed from the pool, so once any missing
+        // schemas have been loaded they are still present when parsing
+        {
+            boost::upgrade_lock<boost::shared_mutex> guard_upgrade(
+                pool.dm_mutex
+                );
+            for (std::vector<boost::filesystem::path>::const_iterator
+                     i = schema_paths.begin(); i != schema_paths.end(); ++i)
+            {
+                if (pool.dm_loaded.find(i->string()) == pool.dm_loaded.end())
+                {
+                    boost::upgrade_to_unique_lock<boost::shared_mutex>
+                        guard_unique(guard_upgrade);
+                    loadGrammars(pool, schema_paths);
+                    break;
+                }
+            }
+        }
+        
+        guard_pool.lock();
+        parser = new XercesDOMParser(
+            NULL, XMLPlatformUtils::fgMemoryManager, pool.dm_grammars
+            );
+    }
 
     try
     {
@@ -406,21 +1154,6 @@ boost::shared_ptr<DOMDocument> XERCES_CPP_NAMESPACE_QUALIFIER loadFromFile(
             // parser->setValidationScheme(AbstractDOMParser::Val_Always);
             parser->setValidationSchemaFullChecking(true);
             parser->useCachedGrammarInParse(true);
-            
-            for (std::vector<boost::filesystem::path>::const_iterator
-                     i = schema_paths.begin(); i != schema_paths.end(); ++i)
-            {
-                if (!is_regular_file(*i))
-                {
-                    raise<std::runtime_error>(
-                        "The specified schema file (%1%) doesn't exist.", *i
-                        );
-                }
-
-                parser->loadGrammar(
-                    i->string().c_str(), Grammar::SchemaGrammarType, true
-                    );
-            }
         }
         
         parser->parse(path.string().c_str());
@@ -475,6 +1208,105 @@ boost::shared_ptr<DOMDocument> XERCES_CPP_NAMESPACE_QUALIFIER loadFromString(
 
 
 
+//------------------------------------------------------------------------------
+// Map the file into memory and rebuild the document from it. The strings are
+// passed to the DOM straight from the mapping, which copies them, so that the
+// file can be unmapped as soon as the document is rebuilt.
+//------------------------------------------------------------------------------
+boost::shared_ptr<DOMDocument> XERCES_CPP_NAMESPACE_QUALIFIER loadFromBinary(
+    const boost::filesystem::path& path, const boost::uint64_t& key
+    )
+{
+    int fd = open(path.string().c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd == -1)
+    {
+        return boost::shared_ptr<DOMDocument>();
+    }
+
+    struct stat status;
+    if ((fstat(fd, &status) == -1) || (status.st_size == 0))
+    {
+        close(fd);
+        return boost::shared_ptr<DOMDocument>();
+    }
+    
+    void* mapping = mmap(NULL, status.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED)
+    {
+        return boost::shared_ptr<DOMDocument>();
+    }
+
+    DOMDocument* document = NULL;
+    try
+    {
+        const char* begin = static_cast<const char*>(mapping);
+        BinaryReader reader(begin, begin + status.st_size);
+        if (!reader.read(key, document))
+        {
+            document = NULL;
+        }
+    }
+    catch (...)
+    {
+        munmap(mapping, status.st_size);
+        throw;
+    }
+
+    munmap(mapping, status.st_size);
+    
+    return (document == NULL) ? boost::shared_ptr<DOMDocument>() :
+        boost::shared_ptr<DOMDocument>(document, deleteDocument);
+}
+
+
+
+//------------------------------------------------------------------------------
+// Write the binary form into a temporary file alongside the requested one,
+// and then rename it into place.
+//------------------------------------------------------------------------------
+void XERCES_CPP_NAMESPACE_QUALIFIER saveToBinary(
+    const DOMDocument* document,
+    const boost::filesystem::path& path,
+    const boost::uint64_t& key
+    )
+{
+    const boost::filesystem::path temporary_path(
+        path.string() + "." +
+        boost::lexical_cast<std::string>(getpid()) + ".tmp"
+        );
+    
+    BinaryWriter writer(document);
+    
+    {
+        boost::filesystem::ofstream stream(
+            temporary_path, std::ios::out | std::ios::binary | std::ios::trunc
+            );
+        writer.write(stream, key);
+        stream.close();
+        if (!stream)
+        {
+            boost::system::error_code error;
+            boost::filesystem::remove(temporary_path, error);
+            raise<std::runtime_error>(
+                "The specified file (%1%) couldn't be written.", path
+                );
+        }
+    }
+
+    boost::system::error_code error;
+    boost::filesystem::rename(temporary_path, path, error);
+    if (error)
+    {
+        boost::filesystem::remove(temporary_path, error);
+        raise<std::runtime_error>(
+            "The specified file (%1%) couldn't be written.", path
+            );
+    }
+}
+
+
+
 //------------------------------------------------------------------------------
 //------------------------------------------------------------------------------
 std::string XERCES_CPP_NAMESPACE_QUALIFIER saveToString(const DOMNode* root)
@@ -535,7 +1367,7 @@ void XERCES_CPP_NAMESPACE_QUALIFIER selectNodes(
     const boost::function<void (const DOMNode*)>& function
     )
 {
-    parse(root, expression, function);
+    compile(expression)->select(root, function);
 }
 
 
@@ -547,6 +1379,8 @@ std::string XERCES_CPP_NAMESPACE_QUALIFIER selectValue(
     )
 {
     std::string value;
-    parse(root, expression, boost::bind(&getValue, _1, boost::ref(value)));
+    compile(expression)->select(
+        root, boost::bind(&getValue, _1, boost::ref(value))
+        );
     return value;
 }
@@ -20,6 +20,7 @@
 
 #pragma once
 
+#include <boost/cstdint.hpp>
 #include <boost/filesystem.hpp>
 #include <boost/function.hpp>
 #include <boost/shared_ptr.hpp>
@@ -40,6 +41,10 @@ XERCES_CPP_NAMESPACE_BEGIN
      *
      * @throw std::runtime_error    The specified {schema} file doesn't exist,
      *                              or schema validation failed.
+     *
+     * @note    Each schema is loaded only once per process, into a grammar
+     *          pool shared by all subsequent calls. Documents are parsed
+     *          concurrently, except while a schema is being loaded.
      */
     boost::shared_ptr<DOMDocument> loadFromFile(
         const boost::filesystem::path& path,
@@ -56,6 +61,38 @@ XERCES_CPP_NAMESPACE_BEGIN
      */
     boost::shared_ptr<DOMDocument> loadFromString(const std::string& value);
 
+    /**
+     * Load a document previously saved by saveToBinary(). The file is mapped
+     * into memory and the document rebuilt directly from it, without parsing
+     * or validating any XML. Return the resulting document to the caller.
+     *
+     * @param path    Path of the file to load.
+     * @param key     Key with which the file must have been saved.
+     * @return        Document contained in the loaded file, or a null
+     *                pointer if the file doesn't exist, is malformed, or
+     *                was saved with a different key.
+     */
+    boost::shared_ptr<DOMDocument> loadFromBinary(
+        const boost::filesystem::path& path, const boost::uint64_t& key
+        );
+
+    /**
+     * Save the specified document to a file in a compact binary form that
+     * can be loaded by loadFromBinary(). The elements, attributes, text,
+     * and comments of the document are saved. The file is replaced
+     * atomically, so concurrent loads never see a partially written file.
+     *
+     * @param document    Document to be saved.
+     * @param path        Path of the file to save.
+     * @param key         Key identifying the file's contents, typically a
+     *                    hash of the XML from which the document was parsed.
+     *
+     * @throw std::runtime_error    The file couldn't be written.
+     */
+    void saveToBinary(const DOMDocument* document,
+                      const boost::filesystem::path& path,
+                      const boost::uint64_t& key);
+
     /**
      * Save the tree rooted at the specified node to a string. Return the
      * resulting string to the caller.
@@ -68,7 +105,7 @@ XERCES_CPP_NAMESPACE_BEGIN
     /**
      * Select the set of nodes matching the given XPath expression from
      * the tree rooted at the specified node. Invoke the given function
-     * for each of the selected nodes.
+     * for each of the selected nodes, in document order.
      *
      * @param root          Root node of the tree.
      * @param expression    XPath expression to be evaluated.
@@ -80,7 +117,12 @@ XERCES_CPP_NAMESPACE_BEGIN
      * @note    Because Xerces-C++ 2.8.x and 3.0.x do not support the use
      *          of XPath for querying DOM element trees, this function is
      *          implemented using a custom parser supporting only a basic
-     *          subset of the full XPath language.
+     *          subset of the full XPath language: "/" and "//" separated
+     *          steps that are each "*", ".", "..", "@attribute" or "element".
+     *          Unlike full XPath, "//" selects only the current node and its
+     *          child elements rather than all of its descendants. Each node
+     *          is selected at most once, even when reached more than once.
+     *          Each distinct expression is compiled only once and is cached.
      *
      * @sa http://en.wikipedia.org/wiki/Xpath
      */
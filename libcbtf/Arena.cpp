@@ -0,0 +1,253 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2026 Krell Institute. All Rights Reserved.
+//
+// This program is free software; you can redistribute it and/or modify it under
+// the terms of the GNU General Public License as published by the Free Software
+// Foundation; either version 2 of the License, or (at your option) any later
+// version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+// details.
+//
+// You should have received a copy of the GNU General Public License along with
+// this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+// Place, Suite 330, Boston, MA  02111-1307  USA
+////////////////////////////////////////////////////////////////////////////////
+
+/** @file Definition of the Arena class. */
+
+#include <boost/static_assert.hpp>
+#include <boost/thread/tss.hpp>
+#include <cstdlib>
+#include <KrellInstitute/CBTF/Impl/Invoker.hpp>
+#include <string>
+
+#include "Arena.hpp"
+
+using namespace KrellInstitute::CBTF::Impl;
+
+
+
+/** Anonymous namespace hiding implementation details. */
+namespace {
+
+    /**
+     * Size (in bytes) of the header preceding each object allocated by
+     * allocateObject(). Holds the reference to the object's arena, and is
+     * large enough to preserve the alignment of memory from operator new.
+     */
+    const std::size_t kHeaderSize = 16;
+
+    BOOST_STATIC_ASSERT(sizeof(boost::shared_ptr<Arena>) <= kHeaderSize);
+
+    /** Leave the current arena of an exiting thread alone. */
+    void releaseArena(Arena*)
+    {
+    }
+
+    /** Current arena of the calling thread. */
+    boost::thread_specific_ptr<Arena> current_arena(releaseArena);
+
+    /** Is the use of arenas by component networks enabled? */
+    bool isEnabled()
+    {
+        const char* value = getenv("CBTF_NETWORK_ARENA");
+        return (value == NULL) || (std::string(value) != "0");
+    }
+
+    /** Round the given pointer up to the given (power of two) alignment. */
+    char* align(char* ptr, const std::size_t& alignment)
+    {
+        return reinterpret_cast<char*>(
+            (reinterpret_cast<std::size_t>(ptr) + alignment - 1) &
+            ~(alignment - 1)
+            );
+    }
+
+} // namespace <anonymous>
+
+
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+Arena::Scope::Scope(const boost::shared_ptr<Arena>& arena) :
+    dm_arena(arena),
+    dm_previous(current_arena.get())
+{
+    current_arena.reset(dm_arena.get());
+}
+
+
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+Arena::Scope::~Scope()
+{
+    current_arena.reset(dm_previous);
+}
+
+
+
+//------------------------------------------------------------------------------
+// The current arena is always kept alive by the scope that made it current.
+//------------------------------------------------------------------------------
+boost::shared_ptr<Arena> Arena::current()
+{
+    Arena* arena = current_arena.get();
+    return (arena == NULL) ? boost::shared_ptr<Arena>() :
+        arena->shared_from_this();
+}
+
+
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+boost::shared_ptr<Arena> Arena::acquire()
+{
+    static const bool kEnabled = isEnabled();
+
+    boost::shared_ptr<Arena> arena = current();
+    if (!arena && kEnabled)
+    {
+        arena.reset(new Arena());
+    }
+    return arena;
+}
+
+
+
+//------------------------------------------------------------------------------
+// Every object is preceded by a header holding a reference to its arena, which
+// is empty for objects allocated from the heap.
+//------------------------------------------------------------------------------
+void* Arena::allocateObject(std::size_t size)
+{
+    boost::shared_ptr<Arena> arena = current();
+
+    char* header = static_cast<char*>(
+        arena ? arena->allocate(kHeaderSize + size, kHeaderSize) :
+        ::operator new(kHeaderSize + size)
+        );
+    new (header) boost::shared_ptr<Arena>(arena);
+    
+    return header + kHeaderSize;
+}
+
+
+
+//------------------------------------------------------------------------------
+// The object's arena is released only after its header is destroyed, since the
+// header itself may be the last thing keeping the arena alive.
+//------------------------------------------------------------------------------
+void Arena::deallocateObject(void* ptr)
+{
+    if (ptr == NULL)
+    {
+        return;
+    }
+
+    char* header = static_cast<char*>(ptr) - kHeaderSize;
+    boost::shared_ptr<Arena>* arena =
+        reinterpret_cast<boost::shared_ptr<Arena>*>(header);
+
+    boost::shared_ptr<Arena> released;
+    released.swap(*arena);
+    arena->~shared_ptr<Arena>();
+    
+    if (!released)
+    {
+        ::operator delete(header);
+    }
+}
+
+
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+Arena::Arena(const std::size_t& block_size) :
+    dm_mutex(),
+    dm_block_size(block_size),
+    dm_blocks(),
+    dm_next(NULL),
+    dm_end(NULL),
+    dm_size(0)
+{
+}
+
+
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+Arena::~Arena()
+{
+    for (std::vector<char*>::const_iterator
+             i = dm_blocks.begin(); i != dm_blocks.end(); ++i)
+    {
+        ::operator delete(*i);
+    }
+}
+
+
+
+//------------------------------------------------------------------------------
+// Allocations larger than a quarter of a block are given a block of their own,
+// leaving the free space in the current block for the smaller allocations that
+// follow.
+//------------------------------------------------------------------------------
+void* Arena::allocate(const std::size_t& size, const std::size_t& alignment)
+{
+    boost::mutex::scoped_lock guard_arena(dm_mutex);
+
+    if (size > (dm_block_size / 4))
+    {
+        dm_blocks.reserve(dm_blocks.size() + 1);
+        char* block = static_cast<char*>(::operator new(size));
+        dm_blocks.push_back(block);
+        dm_size += size;
+        return block;
+    }
+    
+    char* ptr = (dm_next == NULL) ? NULL : align(dm_next, alignment);
+    if ((ptr == NULL) || (static_cast<std::size_t>(dm_end - ptr) < size))
+    {
+        dm_blocks.reserve(dm_blocks.size() + 1);
+        dm_next = static_cast<char*>(::operator new(dm_block_size));
+        dm_end = dm_next + dm_block_size;
+        dm_blocks.push_back(dm_next);
+        ptr = dm_next;
+    }
+    
+    dm_next = ptr + size;
+    dm_size += size;
+    return ptr;
+}
+
+
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+std::size_t Arena::getSize() const
+{
+    boost::mutex::scoped_lock guard_arena(dm_mutex);
+    return dm_size;
+}
+
+
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+void* Invoker::operator new(std::size_t size)
+{
+    return Arena::allocateObject(size);
+}
+
+
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+void Invoker::operator delete(void* ptr)
+{
+    Arena::deallocateObject(ptr);
+}
@@ -0,0 +1,292 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2026 Krell Institute. All Rights Reserved.
+//
+// This program is free software; you can redistribute it and/or modify it under
+// the terms of the GNU General Public License as published by the Free Software
+// Foundation; either version 2 of the License, or (at your option) any later
+// version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+// details.
+//
+// You should have received a copy of the GNU General Public License along with
+// this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+// Place, Suite 330, Boston, MA  02111-1307  USA
+////////////////////////////////////////////////////////////////////////////////
+
+/** @file Declaration of the Arena and ArenaAllocator classes. */
+
+#pragma once
+
+#include <boost/enable_shared_from_this.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/type_traits/alignment_of.hpp>
+#include <cstddef>
+#include <new>
+#include <vector>
+
+namespace KrellInstitute { namespace CBTF { namespace Impl {
+
+    /**
+     * Monotonic memory arena. Memory is allocated from the arena by bumping a
+     * pointer through large blocks, and is never individually deallocated.
+     * All of the blocks are instead freed in one step when the arena itself
+     * is destroyed. Everything allocated from an arena holds a reference to
+     * it, so the arena is destroyed only once all of those objects are.
+     *
+     * Each thread has a current arena, set by constructing a Scope, that is
+     * used by ArenaAllocator and by the classes allocating their instances
+     * with allocateObject(). A component network makes its arena current
+     * while it is being constructed, so that the implementation details of
+     * its components, their input and output tables, and their handlers, are
+     * packed together rather than scattered throughout the heap.
+     *
+     * @note    Setting the CBTF_NETWORK_ARENA environment variable to "0"
+     *          disables the use of arenas by component networks, which can
+     *          be useful when debugging with heap checking tools.
+     */
+    class Arena :
+        public boost::enable_shared_from_this<Arena>,
+        private boost::noncopyable
+    {
+
+    public:
+
+        /**
+         * Makes an arena the calling thread's current arena within the scope
+         * of an instance of this class. Scopes may be nested, in which case
+         * the previous current arena is restored when leaving the inner one.
+         */
+        class Scope :
+            private boost::noncopyable
+        {
+
+        public:
+
+            /**
+             * Enter a scope.
+             *
+             * @param arena    Arena to be made current, or a null pointer
+             *                 if allocations are to come from the heap.
+             */
+            explicit Scope(const boost::shared_ptr<Arena>& arena);
+
+            /** Leave the scope. */
+            ~Scope();
+
+        private:
+
+            /** Arena made current by this scope. */
+            const boost::shared_ptr<Arena> dm_arena;
+
+            /** Arena that was current before entering this scope. */
+            Arena* const dm_previous;
+
+        }; // class Scope
+
+        /**
+         * Get the calling thread's current arena.
+         *
+         * @return    Current arena, or a null pointer if allocations are to
+         *            come from the heap.
+         */
+        static boost::shared_ptr<Arena> current();
+
+        /**
+         * Get the arena to be used by a new component network. Networks that
+         * are constructed within another network share its arena.
+         *
+         * @return    Current arena if there is one, otherwise a new arena,
+         *            or a null pointer if the use of arenas is disabled.
+         */
+        static boost::shared_ptr<Arena> acquire();
+
+        /**
+         * Allocate memory for an object from the current arena, if any, or
+         * otherwise from the heap. Intended for use by class-specific
+         * allocation functions.
+         *
+         * @param size    Size (in bytes) of the object.
+         * @return        Allocated memory.
+         *
+         * @throw std::bad_alloc    The memory couldn't be allocated.
+         */
+        static void* allocateObject(std::size_t size);
+
+        /**
+         * Deallocate memory for an object that was allocated by
+         * allocateObject(). Memory allocated from an arena is only released
+         * along with the whole arena.
+         *
+         * @param ptr    Memory to be deallocated.
+         */
+        static void deallocateObject(void* ptr);
+
+        /**
+         * Construct an empty arena.
+         *
+         * @param block_size    Size (in bytes) of the blocks allocated from
+         *                      the heap.
+         */
+        explicit Arena(const std::size_t& block_size = 64 * 1024);
+
+        /** Destroy this arena, freeing all of its memory. */
+        ~Arena();
+
+        /**
+         * Allocate memory from this arena.
+         *
+         * @param size         Size (in bytes) of the memory.
+         * @param alignment    Alignment (in bytes) of the memory. Must be a
+         *                     power of two no larger than the alignment of
+         *                     memory returned by operator new.
+         * @return             Allocated memory.
+         *
+         * @throw std::bad_alloc    The memory couldn't be allocated.
+         */
+        void* allocate(const std::size_t& size, const std::size_t& alignment);
+
+        /**
+         * Get the size of this arena.
+         *
+         * @return    Size (in bytes) of the memory allocated from this arena.
+         */
+        std::size_t getSize() const;
+
+    private:
+
+        /** Mutual exclusion lock for this arena. */
+        mutable boost::mutex dm_mutex;
+
+        /** Size (in bytes) of the blocks allocated from the heap. */
+        const std::size_t dm_block_size;
+
+        /** Blocks allocated from the heap. */
+        std::vector<char*> dm_blocks;
+
+        /** Next free byte of the most recently allocated block. */
+        char* dm_next;
+
+        /** End of the most recently allocated block. */
+        char* dm_end;
+
+        /** Size (in bytes) of the memory allocated from this arena. */
+        std::size_t dm_size;
+
+    }; // class Arena
+
+    /**
+     * Allocator using the arena that was current when it was constructed, or
+     * the heap if there was none. Containers copied with this allocator use
+     * the arena current at the time of the copy rather than the original's,
+     * so that copy-on-write tables replaced after their network is built no
+     * longer grow its arena.
+     *
+     * @tparam T    Type of the values being allocated.
+     */
+    template <typename T>
+    class ArenaAllocator
+    {
+
+        template <typename U> friend class ArenaAllocator;
+
+    public:
+
+        typedef T value_type;
+        typedef T* pointer;
+        typedef const T* const_pointer;
+        typedef T& reference;
+        typedef const T& const_reference;
+        typedef std::size_t size_type;
+        typedef std::ptrdiff_t difference_type;
+
+        template <typename U>
+        struct rebind
+        {
+            typedef ArenaAllocator<U> other;
+        };
+
+        ArenaAllocator() :
+            dm_arena(Arena::current())
+        {
+        }
+
+        template <typename U>
+        ArenaAllocator(const ArenaAllocator<U>& other) :
+            dm_arena(other.dm_arena)
+        {
+        }
+
+        ArenaAllocator select_on_container_copy_construction() const
+        {
+            return ArenaAllocator();
+        }
+
+        pointer address(reference value) const
+        {
+            return &value;
+        }
+
+        const_pointer address(const_reference value) const
+        {
+            return &value;
+        }
+
+        pointer allocate(size_type n, const void* /* Unused */ = 0)
+        {
+            if (!dm_arena)
+            {
+                return static_cast<pointer>(::operator new(n * sizeof(T)));
+            }
+            return static_cast<pointer>(
+                dm_arena->allocate(n * sizeof(T), boost::alignment_of<T>::value)
+                );
+        }
+
+        void deallocate(pointer ptr, size_type /* Unused */)
+        {
+            if (!dm_arena)
+            {
+                ::operator delete(ptr);
+            }
+        }
+
+        size_type max_size() const
+        {
+            return static_cast<size_type>(-1) / sizeof(T);
+        }
+
+        void construct(pointer ptr, const_reference value)
+        {
+            new (ptr) T(value);
+        }
+
+        void destroy(pointer ptr)
+        {
+            ptr->~T();
+        }
+
+        template <typename U>
+        bool operator==(const ArenaAllocator<U>& other) const
+        {
+            return dm_arena == other.dm_arena;
+        }
+
+        template <typename U>
+        bool operator!=(const ArenaAllocator<U>& other) const
+        {
+            return dm_arena != other.dm_arena;
+        }
+
+    private:
+
+        /** Arena from which values are allocated, or null for the heap. */
+        boost::shared_ptr<Arena> dm_arena;
+
+    }; // class ArenaAllocator<T>
+
+} } } // namespace KrellInstitute::CBTF::Impl
@@ -38,6 +38,29 @@ void Component::registerPlugin(const boost::filesystem::path& path)
 
 
 
+//------------------------------------------------------------------------------
+// Let the implementation do the real work.
+//------------------------------------------------------------------------------
+void Component::registerPlugins(
+    const std::vector<boost::filesystem::path>& paths,
+    const std::vector<boost::filesystem::path>& search_paths
+    )
+{
+    ComponentImpl::registerPlugins(paths, search_paths);
+}
+
+
+
+//------------------------------------------------------------------------------
+// Let the implementation do the real work.
+//------------------------------------------------------------------------------
+void Component::writePluginManifest(const boost::filesystem::path& path)
+{
+    ComponentImpl::writePluginManifest(path);
+}
+
+
+
 //------------------------------------------------------------------------------
 // Let the implementation do the real work.
 //------------------------------------------------------------------------------
@@ -58,6 +81,29 @@ std::set<Version> Component::getAvailableVersions(const Type& type)
 
 
 
+//------------------------------------------------------------------------------
+// Let the implementation do the real work.
+//------------------------------------------------------------------------------
+Component::Descriptor Component::getDescriptor(
+    const Type& type,
+    const boost::optional<Version>& version
+    )
+{
+    return ComponentImpl::getDescriptor(type, version);
+}
+
+
+
+//------------------------------------------------------------------------------
+// Let the implementation do the real work.
+//------------------------------------------------------------------------------
+std::vector<Type> Component::findConverters(const Type& from, const Type& to)
+{
+    return ComponentImpl::findConverters(from, to);
+}
+
+
+
 //------------------------------------------------------------------------------
 // Let the implementation do the real work.
 //------------------------------------------------------------------------------
@@ -77,10 +123,11 @@ Component::Instance Component::instantiate(
 void Component::connect(Component::Instance output_instance,
                         const std::string& output_name,
                         Component::Instance input_instance,
-                        const std::string& input_name)
+                        const std::string& input_name,
+                        const bool& asynchronous)
 {
     ComponentImpl::connect(output_instance, output_name,
-                           input_instance, input_name);
+                           input_instance, input_name, asynchronous);
 }
         
 
@@ -99,6 +146,47 @@ void Component::disconnect(Component::Instance output_instance,
 
 
 
+//------------------------------------------------------------------------------
+// Let the implementation do the real work.
+//------------------------------------------------------------------------------
+void Component::setAsynchronous(Component::Instance instance,
+                                const bool& asynchronous)
+{
+    ComponentImpl::setAsynchronous(instance, asynchronous);
+}
+
+
+
+//------------------------------------------------------------------------------
+// Let the implementation do the real work.
+//------------------------------------------------------------------------------
+void Component::setThreadPoolSize(const std::size_t& size)
+{
+    ComponentImpl::setThreadPoolSize(size);
+}
+
+
+
+//------------------------------------------------------------------------------
+// Let the implementation do the real work.
+//------------------------------------------------------------------------------
+void Component::setStatisticsEnabled(const bool& enabled)
+{
+    ComponentImpl::setStatisticsEnabled(enabled);
+}
+
+
+
+//------------------------------------------------------------------------------
+// Let the implementation do the real work.
+//------------------------------------------------------------------------------
+void Component::setPoolCapacity(const Type& type, const std::size_t& capacity)
+{
+    ComponentImpl::setPoolCapacity(type, capacity);
+}
+
+
+
 //------------------------------------------------------------------------------
 // Let the implementation do the real work.
 //------------------------------------------------------------------------------
@@ -142,7 +230,7 @@ Version Component::getVersion() const
 //------------------------------------------------------------------------------
 // Let the implementation do the real work.
 //------------------------------------------------------------------------------
-std::map<std::string, Type> Component::getInputs() const
+const std::map<std::string, Type>& Component::getInputs() const
 {
     return dm_impl->getInputs();
 }
@@ -152,13 +240,23 @@ std::map<std::string, Type> Component::getInputs() const
 //------------------------------------------------------------------------------
 // Let the implementation do the real work.
 //------------------------------------------------------------------------------
-std::map<std::string, Type> Component::getOutputs() const
+const std::map<std::string, Type>& Component::getOutputs() const
 {
     return dm_impl->getOutputs();
 }
 
 
 
+//------------------------------------------------------------------------------
+// Let the implementation do the real work.
+//------------------------------------------------------------------------------
+Statistics Component::getStatistics() const
+{
+    return dm_impl->getStatistics();
+}
+
+
+
 //------------------------------------------------------------------------------
 // Let the implementation do the real work.
 //------------------------------------------------------------------------------
@@ -171,6 +269,38 @@ void Component::registerFactoryFunction(
 
 
 
+//------------------------------------------------------------------------------
+// Let the implementation do the real work.
+//------------------------------------------------------------------------------
+void Component::registerFactoryFunction(
+    const Descriptor& descriptor,
+    const Component::FactoryFunction& function
+    )
+{
+    ComponentImpl::registerFactoryFunction(descriptor, function);
+}
+
+
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+bool Component::resetComponent(const Instance& instance)
+{
+    return instance->reset();
+}
+
+
+
+//------------------------------------------------------------------------------
+// Components cannot be recycled unless they override this.
+//------------------------------------------------------------------------------
+bool Component::reset()
+{
+    return false;
+}
+
+
+
 //------------------------------------------------------------------------------
 // Let the implementation do the real work.
 //------------------------------------------------------------------------------
@@ -198,9 +328,32 @@ void Component::declareInputImpl(
 //------------------------------------------------------------------------------
 // Let the implementation do the real work.
 //------------------------------------------------------------------------------
-void Component::declareOutputImpl(const std::string& name, const Type& type)
+std::size_t Component::declareOutputImpl(const std::string& name,
+                                         const Type& type)
+{
+    return dm_impl->declareOutputImpl(name, type);
+}
+
+
+
+//------------------------------------------------------------------------------
+// Let the implementation do the real work.
+//------------------------------------------------------------------------------
+std::size_t Component::declareOutputImpl(const std::string& name,
+                                         const Type& type,
+                                         boost::atomic<bool>& connected)
+{
+    return dm_impl->declareOutputImpl(name, type, &connected);
+}
+
+
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+boost::mutex& Component::directConnections()
 {
-    dm_impl->declareOutputImpl(name, type);
+    static boost::mutex* the_mutex = new boost::mutex();
+    return *the_mutex;
 }
 
 
@@ -209,7 +362,40 @@ void Component::declareOutputImpl(const std::string& name, const Type& type)
 // Let the implementation do the real work.
 //------------------------------------------------------------------------------
 void Component::emitOutputImpl(const std::string& name, const Type& type,
-                               const boost::any& value)
+                               const Impl::Value& value)
 {
     dm_impl->emitOutputImpl(name, type, value);
 }
+
+
+
+//------------------------------------------------------------------------------
+// Let the implementation do the real work.
+//------------------------------------------------------------------------------
+void Component::emitOutputImpl(const std::size_t& index, const Type& type,
+                               const Impl::Value& value)
+{
+    dm_impl->emitOutputImpl(index, type, value);
+}
+
+
+
+//------------------------------------------------------------------------------
+// Let the implementation do the real work.
+//------------------------------------------------------------------------------
+void Component::emitOutputImpl(const std::string& name, const Type& type,
+                               const Impl::Batch& batch)
+{
+    dm_impl->emitOutputImpl(name, type, batch);
+}
+
+
+
+//------------------------------------------------------------------------------
+// Let the implementation do the real work.
+//------------------------------------------------------------------------------
+void Component::emitOutputImpl(const std::size_t& index, const Type& type,
+                               const Impl::Batch& batch)
+{
+    dm_impl->emitOutputImpl(index, type, batch);
+}
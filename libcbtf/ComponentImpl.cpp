@@ -19,15 +19,30 @@
 /** @file Definition of the ComponentImpl class. */
 
 #include <boost/assert.hpp>
+#include <boost/bind.hpp>
+#include <boost/exception_ptr.hpp>
 #include <boost/filesystem.hpp>
 #include <boost/format.hpp>
+#include <boost/make_shared.hpp>
+#include <boost/ref.hpp>
+#include <boost/thread/condition_variable.hpp>
 #include <boost/thread/locks.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/recursive_mutex.hpp>
+#include <boost/thread/thread.hpp>
+#include <cstdlib>
+#include <deque>
 #include <dlfcn.h>
+#include <exception>
+#include <iostream>
 #include <set>
 #include <stdexcept>
+#include <vector>
 
 #include "ComponentImpl.hpp"
+#include "Executor.hpp"
 #include "Global.hpp"
+#include "Manifest.hpp"
 #include "Raise.hpp"
 #include "ResolvePath.hpp"
 
@@ -39,494 +54,2469 @@ using namespace KrellInstitute::CBTF::Impl;
 /** Anonymous namespace hiding implementation details. */
 namespace {
 
+    /**
+     * Maximum number of values handled each time the mailbox of a component
+     * receiving asynchronously is drained, before yielding the worker thread
+     * to other components.
+     */
+    const std::size_t kMailboxDrainLimit = 64;
+
     /** Global associative container used to track the loaded plugins. */
     KRELL_INSTITUTE_CBTF_IMPL_GLOBAL(Plugins, std::set<boost::filesystem::path>)
 
-    /** 
-     * Global associative container mapping the available component
-     * types and versions to their corresponding factory function.
+    /**
+     * Component factory function and the descriptor of its components. The
+     * factory function of a component listed in a plugin's manifest is empty
+     * until that plugin is actually loaded.
+     */
+    struct Factory
+    {
+        /** Descriptor of the components instantiated by this factory. */
+        Component::Descriptor dm_descriptor;
+
+        /** Factory function, or an empty function if not yet loaded. */
+        Component::FactoryFunction dm_function;
+
+        /** Plugin to be loaded in order to obtain the factory function. */
+        boost::filesystem::path dm_plugin;
+
+        /** Construct a factory. */
+        Factory(const Component::Descriptor& descriptor,
+                const Component::FactoryFunction& function,
+                const boost::filesystem::path& plugin) :
+            dm_descriptor(descriptor),
+            dm_function(function),
+            dm_plugin(plugin)
+        {
+        }
+    };
+
+    /** Table mapping component types and versions to their factory. */
+    typedef std::map<Type, std::map<Version, Factory> > FactoryTable;
+
+    /**
+     * Registry of the available component types and versions. Lookups read
+     * the published snapshot of the table without taking any lock, and the
+     * factory functions are always called without holding any lock, so that
+     * components can be instantiated concurrently.
+     */
+    struct Registry
+    {
+        /** Current table of the available factories. */
+        Snapshot<FactoryTable> dm_factories;
+
+        /** Mutual exclusion lock serializing updates of the table. */
+        boost::mutex dm_updating;
+
+        /**
+         * Queue of the factory functions registered without a descriptor and
+         * not yet called to learn the type and version of their components.
+         */
+        std::deque<Component::FactoryFunction> dm_pending;
+
+        /** Number of the queued factory functions currently being called. */
+        std::size_t dm_in_flight;
+        
+        /**
+         * Mutual exclusion lock guarding the queue and the above count. Never
+         * held while a queued factory function is being called, since these
+         * may take arbitrarily long, and may in turn query the registry, from
+         * the calling thread or from others.
+         */
+        boost::mutex dm_resolving;
+
+        /** Condition signaled when no factory function is being called. */
+        boost::condition_variable dm_resolved;
+        
+        /**
+         * Flag indicating if the queue might be non-empty, or any factory
+         * function might still be being called.
+         */
+        boost::atomic<bool> dm_any_pending;
+
+        /** Default constructor. */
+        Registry() :
+            dm_factories(new FactoryTable()),
+            dm_updating(),
+            dm_pending(),
+            dm_in_flight(0),
+            dm_resolving(),
+            dm_resolved(),
+            dm_any_pending(false)
+        {
+        }
+    };
+
+    /**
+     * Access the registry. Deliberately never destroyed so that components can
+     * still be instantiated during static C++ destruction.
+     */
+    Registry& registry()
+    {
+        static Registry* the_registry = new Registry();
+        return *the_registry;
+    }
+
+    /** Number of queued factory functions being called by the calling thread. */
+    __thread std::size_t resolving_depth = 0;
+
+    /**
+     * Component type converting values of one type into another. Any component
+     * type whose name contains "Convert", and which has a single input and a
+     * single output, is assumed to convert values of its input's type into
+     * values of its output's type.
+     */
+    struct Converter
+    {
+        /** Type of the converter. */
+        Type dm_type;
+
+        /** Type of the values converted by the converter. */
+        Type dm_from;
+
+        /** Type of the values produced by the converter. */
+        Type dm_to;
+    };
+
+    /**
+     * Index of the available converters, keyed by the type of the values they
+     * convert. Converter types are queued as they are registered, and are each
+     * instantiated once, by the next search for converters, in order to learn
+     * the types of their input and output. The chains of converters found by
+     * searches are cached until another converter is indexed. Deliberately
+     * never destroyed, like the registry.
+     */
+    struct ConverterIndex
+    {
+        /**
+         * Mutual exclusion lock for the queue. Never held while acquiring any
+         * other lock, so that it can be acquired while registering factories.
+         */
+        boost::mutex dm_queue_mutex;
+
+        /** Converter types registered but not yet indexed. */
+        std::set<Type> dm_queue;
+
+        /**
+         * Mutual exclusion lock for the index. Recursive because indexing a
+         * converter instantiates it, which may in turn search for converters.
+         * Converters are instantiated while holding this lock, so a converter
+         * whose constructor waits for another thread that is searching for
+         * converters deadlocks.
+         */
+        boost::recursive_mutex dm_mutex;
+
+        /** Indexed converters, keyed by the type of the values they convert. */
+        std::multimap<Type, Converter> dm_converters;
+
+        /**
+         * Shortest chains of converters previously found, keyed by the types
+         * of the values they convert and produce.
+         */
+        std::map<std::pair<Type, Type>, std::vector<Type> > dm_chains;
+
+        /** Default constructor. */
+        ConverterIndex() :
+            dm_queue_mutex(),
+            dm_queue(),
+            dm_mutex(),
+            dm_converters(),
+            dm_chains()
+        {
+        }
+    };
+
+    /** Access the index of the available converters. */
+    ConverterIndex& converterIndex()
+    {
+        static ConverterIndex* the_index = new ConverterIndex();
+        return *the_index;
+    }
+
+    /** Queue the given component type for indexing if it is a converter. */
+    void queueConverter(const Type& type)
+    {
+        if (std::string(type).find("Convert") == std::string::npos)
+        {
+            return;
+        }
+
+        ConverterIndex& index = converterIndex();
+        boost::mutex::scoped_lock guard_queue(index.dm_queue_mutex);
+        index.dm_queue.insert(type);
+    }
+    
+    /**
+     * Pools of recycled component instances, keyed by their type and version.
+     * Deliberately never destroyed so that components can still be released
+     * during static C++ destruction.
      */
-    KRELL_INSTITUTE_CBTF_IMPL_GLOBAL(
-        Factories,
+    struct InstancePool
+    {
+        /** Flag indicating if any component type is pooled. */
+        boost::atomic<bool> dm_enabled;
+        
+        /** Mutual exclusion lock for the pools. */
+        boost::mutex dm_mutex;
+
+        /** Capacity of the pool of each pooled component type. */
+        std::map<Type, std::size_t> dm_capacities;
+
+        /** Recycled instances of each pooled component type and version. */
         std::map<
-            Type BOOST_PP_COMMA() 
-            std::map<Version BOOST_PP_COMMA() Component::FactoryFunction>
-            >
-        )
+            std::pair<Type, Version>, std::vector<Component::Instance>
+            > dm_instances;
+
+        /** Default constructor. */
+        InstancePool() :
+            dm_enabled(false),
+            dm_mutex(),
+            dm_capacities(),
+            dm_instances()
+        {
+        }
+    };
+
+    /** Access the pools of recycled component instances. */
+    InstancePool& instancePool()
+    {
+        static InstancePool* the_pool = new InstancePool();
+        return *the_pool;
+    }
+
+    /**
+     * Deleter of the instances of pooled component types. Instead of deleting
+     * the component, recycles the instance that owns it.
+     */
+    struct Recycler
+    {
+        /** Instance owning the component. */
+        Component::Instance dm_owner;
+
+        /** Construct a deleter for the component owned by this instance. */
+        explicit Recycler(const Component::Instance& owner) :
+            dm_owner(owner)
+        {
+        }
+
+        /** Recycle the component. */
+        void operator()(Component*)
+        {
+            Component::Instance owner;
+            owner.swap(dm_owner);
+            ComponentImpl::recycle(owner);
+        }
+    };
+
+    /**
+     * Interned schemas of component ports. Each schema is reached from a
+     * smaller one by declaring one more port, and those steps are cached so
+     * that constructing another instance of a component type only looks up
+     * the schemas already interned for the first instance. Deliberately never
+     * destroyed, so that references to the schemas remain valid for the life
+     * of the process.
+     */
+    struct SchemaTable
+    {
+        /** Type of an interned schema. */
+        typedef std::map<std::string, Type> Schema;
+
+        /** Mutual exclusion lock for this table. */
+        boost::mutex dm_mutex;
+
+        /** Interned schemas. */
+        std::set<Schema> dm_schemas;
+
+        /** Schemas reached by extending a schema with the given port. */
+        std::map<
+            std::pair<const Schema*, std::pair<std::string, Type> >,
+            const Schema*
+            > dm_extensions;
+    };
+
+    /** Access the table of interned schemas. */
+    SchemaTable& schemaTable()
+    {
+        static SchemaTable* the_table = new SchemaTable();
+        return *the_table;
+    }
+
+    /**
+     * Mutual exclusion lock guarding the connection topology, i.e. the list of
+     * upstream components kept by each component. Always acquired before any
+     * of the individual component locks. Deliberately never destroyed so that
+     * components can still be destroyed during static C++ destruction.
+     */
+    boost::mutex& topology()
+    {
+        static boost::mutex* the_mutex = new boost::mutex();
+        return *the_mutex;
+    }
+
+    /**
+     * Flag indicating if statistics are being collected. Read, without any
+     * ordering constraints, on every emission and handler invocation, so that
+     * collection costs almost nothing when disabled.
+     */
+    boost::atomic<bool> collecting_statistics(false);
+
+    /**
+     * Components whose statistics are to be written to the standard error
+     * stream, as requested by the CBTF_STATISTICS environment variable, when
+     * they are destroyed or when the process exits. Deliberately never
+     * destroyed so that components can still be destroyed during static C++
+     * destruction.
+     */
+    struct StatisticsReport
+    {
+        /** Flag indicating if the statistics are to be written at all. */
+        bool dm_enabled;
+        
+        /** Mutual exclusion lock for the live components. */
+        boost::mutex dm_mutex;
+
+        /** Live components whose statistics haven't yet been written. */
+        std::set<const ComponentImpl*> dm_components;
+
+        /** Write the statistics of the given component unless it was idle. */
+        static void write(const ComponentImpl& component)
+        {
+            const Statistics statistics = component.getStatistics();
+
+            bool idle = true;
+            for (std::map<std::string, Statistics::Input>::const_iterator
+                     i = statistics.dm_inputs.begin();
+                 i != statistics.dm_inputs.end();
+                 ++i)
+            {
+                idle = idle && (i->second.dm_invocations == 0);
+            }
+            for (std::map<std::string, Statistics::Output>::const_iterator
+                     i = statistics.dm_outputs.begin();
+                 i != statistics.dm_outputs.end();
+                 ++i)
+            {
+                idle = idle && (i->second.dm_emissions == 0);
+            }
+            
+            if (!idle)
+            {
+                std::cerr << "[CBTF] Statistics of component "
+                          << component.getType() << " "
+                          << component.getVersion()
+                          << " (" << &component << "):" << std::endl
+                          << statistics;
+            }
+        }
+
+        /** Write the statistics of the components still alive at exit. */
+        static void writeAll();
+        
+        /** Default constructor. */
+        StatisticsReport() :
+            dm_enabled(false),
+            dm_mutex(),
+            dm_components()
+        {
+            const char* value = getenv("CBTF_STATISTICS");
+            if ((value != NULL) && (std::string(value) != "") &&
+                (std::string(value) != "0"))
+            {
+                dm_enabled = true;
+                collecting_statistics.store(true);
+                atexit(&StatisticsReport::writeAll);
+            }
+        }
+    };
+
+    /** Access the statistics report requested by the environment. */
+    StatisticsReport& statisticsReport()
+    {
+        static StatisticsReport* the_report = new StatisticsReport();
+        return *the_report;
+    }
+
+    void StatisticsReport::writeAll()
+    {
+        StatisticsReport& report = statisticsReport();
+        boost::mutex::scoped_lock guard_report(report.dm_mutex);
+        for (std::set<const ComponentImpl*>::const_iterator
+                 i = report.dm_components.begin();
+             i != report.dm_components.end();
+             ++i)
+        {
+            write(**i);
+        }
+        report.dm_components.clear();
+    }
     
-} // namespace <anonymous>
+    /** Get the number of values in a value. */
+    std::size_t countOf(const Impl::Value&)
+    {
+        return 1;
+    }
+
+    /** Get the number of values in a batch. */
+    std::size_t countOf(const Impl::Batch& batch)
+    {
+        return batch.size();
+    }
+
+    /** Is the specified environment variable set to a true value? */
+    bool isEnvironmentSet(const char* name)
+    {
+        const char* value = getenv(name);
+        return (value != NULL) && (std::string(value) != "") &&
+            (std::string(value) != "0");
+    }
+
+    /**
+     * Plugin loading options requested by the environment. Setting the
+     * CBTF_PLUGIN_LAZY_BINDING environment variable loads plugins with
+     * RTLD_LAZY rather than RTLD_NOW, deferring the binding of each function
+     * until it is first called. Setting CBTF_PLUGIN_TIMING writes the time
+     * taken to register and load each plugin to the standard error stream.
+     */
+    struct PluginOptions
+    {
+        /** Flag indicating if plugins are loaded with lazy binding. */
+        bool dm_lazy_binding;
+
+        /** Flag indicating if the time taken by each plugin is written. */
+        bool dm_timing;
+
+        /** Default constructor. */
+        PluginOptions() :
+            dm_lazy_binding(isEnvironmentSet("CBTF_PLUGIN_LAZY_BINDING")),
+            dm_timing(isEnvironmentSet("CBTF_PLUGIN_TIMING"))
+        {
+        }
+    };
+
+    /** Access the plugin loading options requested by the environment. */
+    const PluginOptions& pluginOptions()
+    {
+        static PluginOptions* the_options = new PluginOptions();
+        return *the_options;
+    }
+
+    /** Convert a time in nanoseconds to microseconds for reporting. */
+    boost::uint64_t toMicroseconds(const boost::uint64_t& nanoseconds)
+    {
+        return nanoseconds / 1000;
+    }
+
+    /**
+     * Record the time spent on one phase of registering the specified plugin
+     * if tracing is enabled.
+     */
+    void tracePlugin(const boost::filesystem::path& path,
+                     const std::string& phase,
+                     const boost::uint64_t& start)
+    {
+        if (Trace::isEnabled())
+        {
+            Trace::record(Trace::intern("Plugin"),
+                          Trace::intern(
+                              phase + " " + path.filename().string()
+                              ),
+                          start, Trace::now() - start);
+        }
+    }
+
+    /**
+     * Load the specified plugin, running the static initializers that register
+     * the factory functions for its component types.
+     */
+    void loadPlugin(const boost::filesystem::path& path)
+    {
+        const boost::uint64_t start = Trace::now();
+
+        if (dlopen(path.string().c_str(),
+                   pluginOptions().dm_lazy_binding ? RTLD_LAZY : RTLD_NOW)
+            == NULL)
+        {
+            raise<std::runtime_error>(
+                "The specified plugin (%1%) doesn't exist or is not "
+                "of the correct format. dlopen() reported \"%2%\".",
+                path, dlerror()
+                );
+        }
+
+        tracePlugin(path, "load", start);
+    }
+
+    /**
+     * Add a factory function to the available components. A factory function
+     * that hasn't been loaded yet is replaced once it is actually registered.
+     */
+    void insertFactory(const Component::Descriptor& descriptor,
+                       const Component::FactoryFunction& function,
+                       const boost::filesystem::path& plugin =
+                           boost::filesystem::path())
+    {
+        Registry& the_registry = registry();
+        boost::mutex::scoped_lock guard_updating(the_registry.dm_updating);
+
+        const FactoryTable& factories = *the_registry.dm_factories.get();
+
+        FactoryTable::const_iterator i = factories.find(descriptor.dm_type);
+        if (i != factories.end())
+        {
+            FactoryTable::mapped_type::const_iterator j =
+                i->second.find(descriptor.dm_version);
+            if ((j != i->second.end()) && (j->second.dm_function || !function))
+            {
+                return;
+            }
+        }
+
+        FactoryTable* updated = new FactoryTable(factories);
+        FactoryTable::mapped_type& versions = (*updated)[descriptor.dm_type];
+        versions.erase(descriptor.dm_version);
+        versions.insert(
+            std::make_pair(descriptor.dm_version,
+                           Factory(descriptor, function, plugin))
+            );
+        the_registry.dm_factories.publish(updated);
+
+        queueConverter(descriptor.dm_type);
+    }
+
+    /**
+     * Call a queued factory function once in order to learn the type, version,
+     * and ports of its components, then add it to the available components.
+     */
+    void resolveFactory(const Component::FactoryFunction& function)
+    {
+        Component::Instance instance = function();
+        if (!instance)
+        {
+            raise<std::runtime_error>(
+                "The factory function didn't instantiate a component."
+                );
+        }
+        
+        Component::Descriptor descriptor(
+            instance->getType(), instance->getVersion()
+            );
+
+        const std::map<std::string, Type>& inputs = instance->getInputs();
+        for (std::map<std::string, Type>::const_iterator
+                 i = inputs.begin(); i != inputs.end(); ++i)
+        {
+            descriptor.dm_inputs.insert(i->first);
+        }
+
+        const std::map<std::string, Type>& outputs = instance->getOutputs();
+        for (std::map<std::string, Type>::const_iterator
+                 i = outputs.begin(); i != outputs.end(); ++i)
+        {
+            descriptor.dm_outputs.insert(i->first);
+        }
+
+        insertFactory(descriptor, function);
+    }
+    
+    /**
+     * Resolve each of the queued factory functions in turn. A factory function
+     * may itself register more factory functions, which are resolved in turn.
+     * Each factory function is popped from the queue under the lock, but then
+     * called without holding any lock. Other threads thus remain free to query
+     * the registry, and to resolve the rest of the queue, in the meantime.
+     *
+     * Factory functions are registered while loading an executable or plugin,
+     * where nobody could catch an exception, and are resolved on behalf of
+     * whichever unrelated caller first queries the available components. So a
+     * factory function that fails is reported, and then dropped, without
+     * affecting the factory functions queued after it.
+     */
+    void resolvePendingFactories()
+    {
+        Registry& the_registry = registry();
+        if (!the_registry.dm_any_pending.load(boost::memory_order_acquire))
+        {
+            return;
+        }
+
+        boost::mutex::scoped_lock guard_resolving(the_registry.dm_resolving);
+
+        while (!the_registry.dm_pending.empty())
+        {
+            Component::FactoryFunction function =
+                the_registry.dm_pending.front();
+            the_registry.dm_pending.pop_front();
+            ++the_registry.dm_in_flight;
+            
+            guard_resolving.unlock();
+            ++resolving_depth;
+            try
+            {
+                resolveFactory(function);
+            }
+            catch (const std::exception& error)
+            {
+                std::cerr << "[CBTF] A factory function failed while being "
+                          << "registered: " << error.what() << std::endl;
+            }
+            catch (...)
+            {
+                std::cerr << "[CBTF] A factory function failed while being "
+                          << "registered." << std::endl;
+            }
+            --resolving_depth;
+            guard_resolving.lock();
+
+            if (--the_registry.dm_in_flight == 0)
+            {
+                the_registry.dm_resolved.notify_all();
+            }
+        }
+
+        if (the_registry.dm_in_flight == 0)
+        {
+            the_registry.dm_any_pending.store(
+                false, boost::memory_order_release
+                );
+        }
+    }
+
+    /**
+     * Wait until no queued factory function is being called by another thread,
+     * and then resolve any factory functions that they queued in turn. Never
+     * waits if the calling thread is itself calling a queued factory function,
+     * since that might be what the other threads are waiting for.
+     *
+     * @return    Boolean "true" if there was anything to wait for, or "false"
+     *            otherwise.
+     */
+    bool awaitPendingFactories()
+    {
+        Registry& the_registry = registry();
+        if (!the_registry.dm_any_pending.load(boost::memory_order_acquire) ||
+            (resolving_depth > 0))
+        {
+            return false;
+        }
+
+        {
+            boost::mutex::scoped_lock guard_resolving(
+                the_registry.dm_resolving
+                );
+            if (the_registry.dm_in_flight == 0)
+            {
+                return false;
+            }
+            while (the_registry.dm_in_flight > 0)
+            {
+                the_registry.dm_resolved.wait(guard_resolving);
+            }
+        }
+
+        resolvePendingFactories();
+        return true;
+    }
+
+    /**
+     * Is the specified component type, and version if one is specified, among
+     * the available components? Factory functions being called by other threads
+     * are only waited for when the answer would otherwise be "no", so that the
+     * usual lookups never wait on each other.
+     */
+    bool isAvailable(const Type& type, const boost::optional<Version>& version)
+    {
+        resolvePendingFactories();
+        do
+        {
+            Epoch::Guard guard;
+            const FactoryTable& factories = *registry().dm_factories.get();
+
+            FactoryTable::const_iterator i = factories.find(type);
+            if ((i != factories.end()) &&
+                (!version || (i->second.find(*version) != i->second.end())))
+            {
+                return true;
+            }
+        }
+        while (awaitPendingFactories());
+        return false;
+    }
+
+    /**
+     * Look up the factory for the specified component type and version, or for
+     * the most recent version if none is specified. The factory is copied out
+     * of the table so that it can be used after leaving the critical section.
+     */
+    Factory lookupFactory(const Type& type,
+                          const boost::optional<Version>& version)
+    {
+        resolvePendingFactories();
+        if (registry().dm_any_pending.load(boost::memory_order_acquire))
+        {
+            isAvailable(type, version);
+        }
+
+        Epoch::Guard guard;
+        const FactoryTable& factories = *registry().dm_factories.get();
+
+        FactoryTable::const_iterator i = factories.find(type);
+        if (i == factories.end())
+        {
+            raise<std::runtime_error>(
+                "There is no factory function registered "
+                "for the specified component type (%1%).",
+                type
+                );
+        }
+
+        if (!version)
+        {
+            return i->second.rbegin()->second;
+        }
+
+        FactoryTable::mapped_type::const_iterator j = 
+            i->second.find(version.get());
+
+        if (j == i->second.end())
+        {
+            raise<std::runtime_error>(
+                "There is no factory function registered "
+                "for the specified component version (%1%).",
+                *version
+                );
+        }
+
+        return j->second;
+    }
+
+    /**
+     * Find the factory for the specified component type and version, loading
+     * the plugin providing it if that hasn't been done yet.
+     */
+    Factory findFactory(const Type& type,
+                        const boost::optional<Version>& version)
+    {
+        Factory factory = lookupFactory(type, version);
+        if (factory.dm_function)
+        {
+            return factory;
+        }
+
+        const boost::uint64_t start = Trace::now();
+        loadPlugin(factory.dm_plugin);
+        if (pluginOptions().dm_timing)
+        {
+            std::cerr << "[CBTF] Plugin " << factory.dm_plugin
+                      << ": loaded on first use in "
+                      << toMicroseconds(Trace::now() - start) << " us"
+                      << std::endl;
+        }
+        
+        factory = lookupFactory(type, version);
+        if (!factory.dm_function)
+        {
+            raise<std::runtime_error>(
+                "The plugin (%1%) doesn't provide the component "
+                "type (%2%) and version (%3%) listed in its manifest.",
+                factory.dm_plugin, type, factory.dm_descriptor.dm_version
+                );
+        }
+
+        return factory;
+    }
+    
+    /**
+     * Register a plugin providing one or more component types. The plugin is
+     * resolved against the given search paths, and then the plugin search
+     * paths. It is registered from its manifest when possible, and otherwise
+     * loaded. The plugin is claimed before it is registered, so that another
+     * thread registering the same plugin returns immediately.
+     */
+    void registerPluginWith(
+        const std::vector<boost::filesystem::path>& search_paths,
+        const boost::filesystem::path& path
+        )
+    {
+        const boost::uint64_t start = Trace::now();
+
+        boost::filesystem::path resolved_path = search_paths.empty() ?
+            boost::filesystem::path() : resolvePath(search_paths, path);
+        if (resolved_path.empty())
+        {
+            resolved_path = resolvePath(kPluginFileType, path);
+        }
+
+        if (resolved_path.empty())
+        {
+            raise<std::runtime_error>(
+                "The specified plugin (%1%) doesn't exist.", path
+                );
+        }
+
+        tracePlugin(resolved_path, "resolve", start);
+        const boost::uint64_t resolved = Trace::now();
+        
+        {
+            Plugins::GuardType guard_plugins(Plugins::mutex());
+            if (!Plugins::value().insert(resolved_path).second)
+            {
+                return;
+            }
+        }
+
+        bool from_manifest = false;
+        try
+        {
+            std::vector<Component::Descriptor> descriptors;
+            from_manifest = readManifest(resolved_path, descriptors);
+            if (from_manifest)
+            {
+                for (std::vector<Component::Descriptor>::const_iterator
+                         i = descriptors.begin(); i != descriptors.end(); ++i)
+                {
+                    insertFactory(*i, Component::FactoryFunction(),
+                                  resolved_path);
+                }
+                tracePlugin(resolved_path, "register", resolved);
+            }
+            else
+            {
+                loadPlugin(resolved_path);
+            }
+        }
+        catch (...)
+        {
+            Plugins::GuardType guard_plugins(Plugins::mutex());
+            Plugins::value().erase(resolved_path);
+            throw;
+        }
+
+        if (pluginOptions().dm_timing)
+        {
+            std::cerr << "[CBTF] Plugin " << resolved_path
+                      << ": resolved in "
+                      << toMicroseconds(resolved - start) << " us, "
+                      << (from_manifest ?
+                          "registered from its manifest in " : "loaded in ")
+                      << toMicroseconds(Trace::now() - resolved) << " us"
+                      << std::endl;
+        }
+    }
+
+    /** Plugin registered by a task of the thread pool, and its outcome. */
+    struct PluginTask
+    {
+        /** Path of the plugin. */
+        boost::filesystem::path dm_path;
+
+        /** Exception thrown if registering the plugin failed. */
+        boost::exception_ptr dm_error;
+
+        /** Construct a task registering the specified plugin. */
+        explicit PluginTask(const boost::filesystem::path& path) :
+            dm_path(path),
+            dm_error()
+        {
+        }
+    };
+
+    /**
+     * Run a task registering a plugin, then count it as completed. Any
+     * exception is captured so that the waiting thread can rethrow it.
+     */
+    void runPluginTask(const std::vector<boost::filesystem::path>& search_paths,
+                       PluginTask& task,
+                       boost::atomic<std::size_t>& remaining)
+    {
+        try
+        {
+            registerPluginWith(search_paths, task.dm_path);
+        }
+        catch (...)
+        {
+            task.dm_error = boost::current_exception();
+        }
+        remaining.fetch_sub(1, boost::memory_order_release);
+    }
+    
+} // namespace <anonymous>
+
+
+
+//------------------------------------------------------------------------------
+// Load the module with the specified path (after path resolution) if it hasn't
+// already been loaded. Loading a module causes all of the components contained
+// within that module to be registered with this class.
+//------------------------------------------------------------------------------
+void ComponentImpl::registerPlugin(const boost::filesystem::path& path)
+{
+    registerPluginWith(std::vector<boost::filesystem::path>(), path);
+}
+
+
+
+//------------------------------------------------------------------------------
+// Register each plugin in a separate task of the thread pool. The calling thread
+// helps run those tasks while waiting for them to complete, and then throws the
+// first of any exceptions again, in the order of the paths.
+//------------------------------------------------------------------------------
+void ComponentImpl::registerPlugins(
+    const std::vector<boost::filesystem::path>& paths,
+    const std::vector<boost::filesystem::path>& search_paths
+    )
+{
+    const boost::uint64_t start = Trace::now();
+
+    std::vector<PluginTask> tasks;
+    for (std::vector<boost::filesystem::path>::const_iterator
+             i = paths.begin(); i != paths.end(); ++i)
+    {
+        tasks.push_back(PluginTask(*i));
+    }
+    
+    boost::atomic<std::size_t> remaining(tasks.size());
+    for (std::vector<PluginTask>::iterator
+             i = tasks.begin(); i != tasks.end(); ++i)
+    {
+        Executor::instance().submit(boost::bind(
+            &runPluginTask, boost::cref(search_paths),
+            boost::ref(*i), boost::ref(remaining)
+            ));
+    }
+    
+    while (remaining.load(boost::memory_order_acquire) > 0)
+    {
+        if (!Executor::instance().runPendingTask())
+        {
+            boost::this_thread::yield();
+        }
+    }
+
+    if (pluginOptions().dm_timing && !tasks.empty())
+    {
+        std::cerr << "[CBTF] Registering " << tasks.size() << " plugins took "
+                  << toMicroseconds(Trace::now() - start) << " us"
+                  << std::endl;
+    }
+    
+    for (std::vector<PluginTask>::const_iterator
+             i = tasks.begin(); i != tasks.end(); ++i)
+    {
+        if (i->dm_error)
+        {
+            boost::rethrow_exception(i->dm_error);
+        }
+    }
+}
+
+
+
+//------------------------------------------------------------------------------
+// Load the plugin and compare the available components before and after doing
+// so in order to find those provided by the plugin.
+//------------------------------------------------------------------------------
+void ComponentImpl::writePluginManifest(const boost::filesystem::path& path)
+{
+    boost::filesystem::path resolved_path = resolvePath(kPluginFileType, path);
+
+    if (resolved_path.empty())
+    {
+        raise<std::runtime_error>(
+            "The specified plugin (%1%) doesn't exist.", path
+            );
+    }
+
+    resolvePendingFactories();
+    std::set<std::pair<Type, Version> > before;
+    {
+        Epoch::Guard guard;
+        const FactoryTable& factories = *registry().dm_factories.get();
+        for (FactoryTable::const_iterator
+                 i = factories.begin(); i != factories.end(); ++i)
+        {
+            for (FactoryTable::mapped_type::const_iterator
+                     j = i->second.begin(); j != i->second.end(); ++j)
+            {
+                before.insert(std::make_pair(i->first, j->first));
+            }
+        }
+    }
+    
+    loadPlugin(resolved_path);
+    resolvePendingFactories();
+
+    std::vector<Component::Descriptor> descriptors;
+    {
+        Epoch::Guard guard;
+        const FactoryTable& factories = *registry().dm_factories.get();
+        for (FactoryTable::const_iterator
+                 i = factories.begin(); i != factories.end(); ++i)
+        {
+            for (FactoryTable::mapped_type::const_iterator
+                     j = i->second.begin(); j != i->second.end(); ++j)
+            {
+                if (before.find(std::make_pair(i->first, j->first)) ==
+                    before.end())
+                {
+                    descriptors.push_back(j->second.dm_descriptor);
+                }
+            }
+        }
+    }
+
+    writeManifest(resolved_path, descriptors);
+}
+
+
+
+//------------------------------------------------------------------------------
+// Queue the specified component factory function. Learning the type and version
+// of its components requires instantiating one, which is deferred until they
+// are actually needed.
+//------------------------------------------------------------------------------
+void ComponentImpl::registerFactoryFunction(
+    const Component::FactoryFunction& function
+    )
+{
+    Registry& the_registry = registry();
+    boost::mutex::scoped_lock guard_resolving(the_registry.dm_resolving);
+    the_registry.dm_pending.push_back(function);
+    the_registry.dm_any_pending.store(true, boost::memory_order_release);
+}
+
+
+
+//------------------------------------------------------------------------------
+// Add the specified component factory function to the set of available
+// components without instantiating anything.
+//------------------------------------------------------------------------------
+void ComponentImpl::registerFactoryFunction(
+    const Component::Descriptor& descriptor,
+    const Component::FactoryFunction& function
+    )
+{
+    insertFactory(descriptor, function);
+}
+
+
+
+//------------------------------------------------------------------------------
+// Construct and return the set of available component types.
+//------------------------------------------------------------------------------
+std::set<Type> ComponentImpl::getAvailableTypes()
+{
+    do
+    {
+        resolvePendingFactories();
+    }
+    while (awaitPendingFactories());
+
+    Epoch::Guard guard;
+    const FactoryTable& factories = *registry().dm_factories.get();
+
+    std::set<Type> available_types;
+    for (FactoryTable::const_iterator
+             i = factories.begin(); i != factories.end(); ++i)
+    {
+        available_types.insert(i->first);
+    }
+    
+    return available_types;
+}
+
+
+
+//------------------------------------------------------------------------------
+// Construct and return the set of available versions of the given component
+// type.
+//------------------------------------------------------------------------------
+std::set<Version> ComponentImpl::getAvailableVersions(const Type& type)
+{
+    resolvePendingFactories();
+    if (registry().dm_any_pending.load(boost::memory_order_acquire))
+    {
+        isAvailable(type, boost::optional<Version>());
+    }
+
+    Epoch::Guard guard;
+    const FactoryTable& factories = *registry().dm_factories.get();
+
+    FactoryTable::const_iterator i = factories.find(type);
+    if (i == factories.end())
+    {
+        raise<std::runtime_error>(
+            "There are no available versions of "
+            "of the given component type (%1%).",
+            type
+            );
+    }
+
+    std::set<Version> available_versions;
+    for (FactoryTable::mapped_type::const_iterator
+             j = i->second.begin(); j != i->second.end(); ++j)
+    {
+        available_versions.insert(j->first);
+    }
+    
+    return available_versions;
+}
+
+
+
+//------------------------------------------------------------------------------
+// Use the set of available components to find the descriptor corresponding to
+// the specified component type and version.
+//------------------------------------------------------------------------------
+Component::Descriptor ComponentImpl::getDescriptor(
+    const Type& type,
+    const boost::optional<Version>& version
+    )
+{
+    return lookupFactory(type, version).dm_descriptor;
+}
+
+
+
+//------------------------------------------------------------------------------
+// Index any newly registered converters, instantiating the most recent version
+// of each to learn its ports, and discard the cached chains if the converters
+// changed. Converter types that can't be instantiated are reported, and queued
+// again so that the next search retries them. Then look for a cached chain,
+// and otherwise do a breadth-first
+// search from the source type, so that the chain found has the fewest possible
+// converters, and cache that chain.
+//------------------------------------------------------------------------------
+std::vector<Type> ComponentImpl::findConverters(const Type& from,
+                                                const Type& to)
+{
+    resolvePendingFactories();
+
+    ConverterIndex& index = converterIndex();
+    boost::recursive_mutex::scoped_lock guard_index(index.dm_mutex);
+
+    std::set<Type> queue, failed;
+    {
+        boost::mutex::scoped_lock guard_queue(index.dm_queue_mutex);
+        queue.swap(index.dm_queue);
+    }
+
+    for (std::set<Type>::const_iterator
+             i = queue.begin(); i != queue.end(); ++i)
+    {
+        for (std::multimap<Type, Converter>::iterator
+                 j = index.dm_converters.begin();
+             j != index.dm_converters.end();)
+        {
+            if (j->second.dm_type == *i)
+            {
+                index.dm_converters.erase(j++);
+            }
+            else
+            {
+                ++j;
+            }
+        }
+
+        try
+        {
+            Component::Instance converter = instantiate(
+                *i, boost::optional<Version>()
+                );
+            
+            std::map<std::string, Type> inputs = converter->getInputs();
+            std::map<std::string, Type> outputs = converter->getOutputs();
+            if ((inputs.size() == 1) && (outputs.size() == 1))
+            {
+                Converter entry = {
+                    *i, inputs.begin()->second, outputs.begin()->second
+                };
+                index.dm_converters.insert(std::make_pair(entry.dm_from, entry));
+            }
+        }
+        catch (const std::exception& error)
+        {
+            std::cerr << "[CBTF] A converter (" << *i << ") failed while being "
+                      << "indexed: " << error.what() << std::endl;
+            failed.insert(*i);
+        }
+        catch (...)
+        {
+            std::cerr << "[CBTF] A converter (" << *i << ") failed while being "
+                      << "indexed." << std::endl;
+            failed.insert(*i);
+        }
+    }
+
+    if (!failed.empty())
+    {
+        boost::mutex::scoped_lock guard_queue(index.dm_queue_mutex);
+        index.dm_queue.insert(failed.begin(), failed.end());
+    }
+
+    if (!queue.empty())
+    {
+        index.dm_chains.clear();
+    }
+
+    const std::pair<Type, Type> key(from, to);
+    std::map<std::pair<Type, Type>, std::vector<Type> >::const_iterator i =
+        index.dm_chains.find(key);
+    if (i != index.dm_chains.end())
+    {
+        return i->second;
+    }
+
+    std::map<Type, const Converter*> reached;
+    std::deque<Type> frontier(1, from);
+    while (!frontier.empty() && (reached.find(to) == reached.end()))
+    {
+        const Type current = frontier.front();
+        frontier.pop_front();
+
+        typedef std::multimap<Type, Converter>::const_iterator Iterator;
+        std::pair<Iterator, Iterator> range =
+            index.dm_converters.equal_range(current);
+        for (Iterator j = range.first; j != range.second; ++j)
+        {
+            const Type& next = j->second.dm_to;
+            if ((next != from) && (reached.find(next) == reached.end()))
+            {
+                reached.insert(std::make_pair(next, &j->second));
+                frontier.push_back(next);
+            }
+        }
+    }
+
+    std::vector<Type> chain;
+    if (from != to)
+    {
+        for (std::map<Type, const Converter*>::const_iterator
+                 j = reached.find(to);
+             j != reached.end();
+             j = reached.find(j->second->dm_from))
+        {
+            chain.insert(chain.begin(), j->second->dm_type);
+        }
+    }
+    
+    index.dm_chains.insert(std::make_pair(key, chain));
+    return chain;
+}
+
+
+
+//------------------------------------------------------------------------------
+// Use the set of available components to find the component factory function
+// corresponding to the specified component type and version, then instantiate
+// the component, without holding any lock, and return it. Instances of pooled
+// component types are taken from their pool when possible, and are returned
+// with a deleter that puts them back into the pool.
+//------------------------------------------------------------------------------
+Component::Instance ComponentImpl::instantiate(
+    const Type& type,
+    const boost::optional<Version>& version
+    )
+{
+    Factory factory = findFactory(type, version);
+
+    InstancePool& pool = instancePool();
+    if (!pool.dm_enabled.load(boost::memory_order_relaxed))
+    {
+        return factory.dm_function();
+    }
+
+    Component::Instance owner;
+    {
+        boost::mutex::scoped_lock guard_pool(pool.dm_mutex);
+        if (pool.dm_capacities.find(type) == pool.dm_capacities.end())
+        {
+            return factory.dm_function();
+        }
+        
+        std::vector<Component::Instance>& instances = pool.dm_instances[
+            std::make_pair(type, factory.dm_descriptor.dm_version)
+            ];
+        if (!instances.empty())
+        {
+            owner = instances.back();
+            instances.pop_back();
+        }
+    }
+
+    if (!owner)
+    {
+        owner = factory.dm_function();
+    }
+    
+    return Component::Instance(owner.get(), Recycler(owner));
+}
+
+
+
+//------------------------------------------------------------------------------
+// Check the validity of the specified connection and then publish an updated
+// copy of the output component's outputs that includes the new connection. The
+// output's connected flag, if any, is also set so that a statically typed output
+// knows it must now emit its values by name as well.
+//------------------------------------------------------------------------------
+void ComponentImpl::connect(Component::Instance output_instance,
+                            const std::string& output_name,
+                            Component::Instance input_instance,
+                            const std::string& input_name,
+                            const bool& asynchronous)
+{
+    ComponentImpl& output_impl = *(output_instance->dm_impl);
+    ComponentImpl& input_impl = *(input_instance->dm_impl);
+
+    boost::mutex::scoped_lock guard_topology(topology());
+    boost::mutex::scoped_lock guard_output(output_impl.dm_mutex);
+    Epoch::Guard guard_epoch;
+
+    const OutputTable& outputs = *output_impl.dm_outputs.get();
+    const InputTable& inputs = *input_impl.dm_inputs.get();
+    
+    OutputTable::NameMap::const_iterator i =
+        outputs.dm_names.find(&output_name);
+    if (i == outputs.dm_names.end())
+    {
+        raise<std::runtime_error>(
+            "The requested output (%1%) doesn't exist.", output_name
+            );
+    }
+    
+    InputTable::const_iterator j = inputs.find(&input_name);
+    if (j == inputs.end())
+    {
+        raise<std::runtime_error>(
+            "The requested input (%1%) doesn't exist.", input_name
+            );
+    }
+
+    const Output& output = outputs.dm_outputs[i->second];
+    
+    if (output.dm_port->second != j->second.dm_port->second)
+    {
+        raise<std::runtime_error>(
+            "The requested output (%1%) and input "
+            "(%2%) are not of compatible types.",
+            output_name, input_name
+            );
+    }
+
+    boost::shared_ptr<TargetList> targets(new TargetList());
+    if (output.dm_targets)
+    {
+        targets->reserve(output.dm_targets->size() + 1);
+        
+        for (TargetList::const_iterator
+                 k = output.dm_targets->begin();
+             k != output.dm_targets->end();
+             ++k)
+        {
+            if ((k->dm_impl == &input_impl) && (*k->dm_name == input_name))
+            {
+                raise<std::runtime_error>(
+                    "The requested output (%1%) and input (%2%) "
+                    "are already connected to each other.",
+                    output_name, input_name
+                    );
+            }
+            
+            targets->push_back(*k);
+        }
+    }
+
+    Target target;
+    target.dm_instance = input_instance;
+    target.dm_impl = &input_impl;
+    target.dm_name = j->first;
+    target.dm_invoker = j->second.dm_handler.get();
+    target.dm_counters = j->second.dm_counters.get();
+    target.dm_asynchronous_connection = asynchronous;
+    target.dm_asynchronous = asynchronous || input_impl.dm_asynchronous;
+    targets->push_back(target);
+
+    if (output.dm_connected != NULL)
+    {
+        output.dm_connected->store(true);
+    }
+    
+    OutputTable* updated = new OutputTable(outputs);
+    updated->dm_outputs[i->second].dm_targets = targets;
+    output_impl.dm_outputs.publish(updated);
+    
+    input_impl.dm_upstream.insert(&output_impl);
+}
+
+
+
+//------------------------------------------------------------------------------
+// Check the validity of the specified connection and then publish an updated
+// copy of the output component's outputs that excludes the connection.
+//------------------------------------------------------------------------------
+void ComponentImpl::disconnect(Component::Instance output_instance,
+                               const std::string& output_name,
+                               Component::Instance input_instance,
+                               const std::string& input_name)
+{
+    ComponentImpl& output_impl = *(output_instance->dm_impl);
+    ComponentImpl& input_impl = *(input_instance->dm_impl);
+
+    boost::mutex::scoped_lock guard_topology(topology());
+    boost::mutex::scoped_lock guard_output(output_impl.dm_mutex);
+    Epoch::Guard guard_epoch;
+
+    const OutputTable& outputs = *output_impl.dm_outputs.get();
+    const InputTable& inputs = *input_impl.dm_inputs.get();
+
+    OutputTable::NameMap::const_iterator i =
+        outputs.dm_names.find(&output_name);
+    if (i == outputs.dm_names.end())
+    {
+        raise<std::runtime_error>(
+            "The requested output (%1%) doesn't exist.", output_name
+            );
+    }
+    
+    if (inputs.find(&input_name) == inputs.end())
+    {
+        raise<std::runtime_error>(
+            "The requested input (%1%) doesn't exist.", input_name
+            );
+    }
+
+    const Output& output = outputs.dm_outputs[i->second];
+
+    if (output.dm_targets)
+    {
+        for (TargetList::const_iterator
+                 j = output.dm_targets->begin();
+             j != output.dm_targets->end();
+             ++j)
+        {
+            if ((j->dm_impl == &input_impl) && (*j->dm_name == input_name))
+            {
+                boost::shared_ptr<TargetList> targets;
+                if (output.dm_targets->size() > 1)
+                {
+                    targets.reset(new TargetList(output.dm_targets->begin(), j));
+                    targets->insert(targets->end(),
+                                    j + 1, output.dm_targets->end());
+                }
+                else if (output.dm_connected != NULL)
+                {
+                    output.dm_connected->store(false);
+                }
+                
+                OutputTable* updated = new OutputTable(outputs);
+                updated->dm_outputs[i->second].dm_targets = targets;
+                output_impl.dm_outputs.publish(updated);
+
+                input_impl.dm_upstream.erase(
+                    input_impl.dm_upstream.find(&output_impl)
+                    );
+                return;
+            }
+        }
+    }
+    
+    raise<std::runtime_error>(
+        "The requested output (%1%) and input "
+        "(%2%) are not connected to each other.",
+        output_name, input_name
+        );
+}
+
+
+
+//------------------------------------------------------------------------------
+// Update the flag and then update the connections to this component from all
+// of its upstream components so that they deliver values accordingly.
+//------------------------------------------------------------------------------
+void ComponentImpl::setAsynchronous(Component::Instance instance,
+                                    const bool& asynchronous)
+{
+    ComponentImpl& impl = *(instance->dm_impl);
+    
+    boost::mutex::scoped_lock guard_topology(topology());
+
+    if (impl.dm_asynchronous == asynchronous)
+    {
+        return;
+    }
+    
+    impl.dm_asynchronous = asynchronous;
+    
+    for (std::multiset<ComponentImpl*>::const_iterator
+             i = impl.dm_upstream.begin();
+         i != impl.dm_upstream.end();
+         i = impl.dm_upstream.upper_bound(*i))
+    {
+        boost::mutex::scoped_lock guard_upstream((*i)->dm_mutex);
+        (*i)->updateTargets(&impl);
+    }
+}
+
+
+
+//------------------------------------------------------------------------------
+// Let the executor do the real work.
+//------------------------------------------------------------------------------
+void ComponentImpl::setThreadPoolSize(const std::size_t& size)
+{
+    Executor::instance().setSize(size);
+}
+
+
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+void ComponentImpl::setStatisticsEnabled(const bool& enabled)
+{
+    collecting_statistics.store(enabled);
+}
+
+
+
+//------------------------------------------------------------------------------
+// Discard any pooled instances in excess of the new capacity. They are released
+// after unlocking the pools since their destruction can release other pooled
+// instances.
+//------------------------------------------------------------------------------
+void ComponentImpl::setPoolCapacity(const Type& type,
+                                    const std::size_t& capacity)
+{
+    InstancePool& pool = instancePool();
+    std::vector<Component::Instance> discarded;
+
+    {
+        boost::mutex::scoped_lock guard_pool(pool.dm_mutex);
+
+        if (capacity == 0)
+        {
+            pool.dm_capacities.erase(type);
+        }
+        else
+        {
+            pool.dm_capacities[type] = capacity;
+        }
+        pool.dm_enabled.store(!pool.dm_capacities.empty());
+        
+        for (std::map<
+                 std::pair<Type, Version>, std::vector<Component::Instance>
+                 >::iterator i = pool.dm_instances.begin();
+             i != pool.dm_instances.end();
+             ++i)
+        {
+            if ((i->first.first == type) && (i->second.size() > capacity))
+            {
+                discarded.insert(discarded.end(),
+                                 i->second.begin() + capacity, i->second.end());
+                i->second.resize(capacity);
+            }
+        }
+    }
+}
+
+
+
+//------------------------------------------------------------------------------
+// Remove all of the instance's connections and let the component reset itself.
+// The instance is then put back into its pool if there is room, and otherwise
+// destroyed when the last reference to it is dropped on return.
+//------------------------------------------------------------------------------
+void ComponentImpl::recycle(const Component::Instance& instance)
+{
+    try
+    {
+        instance->dm_impl->removeConnections();
+        instance->dm_impl->discardConnections();
+
+        if (!instance->reset())
+        {
+            return;
+        }
+        
+        InstancePool& pool = instancePool();
+        boost::mutex::scoped_lock guard_pool(pool.dm_mutex);
+        
+        std::map<Type, std::size_t>::const_iterator i =
+            pool.dm_capacities.find(instance->dm_impl->dm_type);
+        if (i == pool.dm_capacities.end())
+        {
+            return;
+        }
+
+        std::vector<Component::Instance>& instances = pool.dm_instances[
+            std::make_pair(instance->dm_impl->dm_type,
+                           instance->dm_impl->dm_version)
+            ];
+        if (instances.size() < i->second)
+        {
+            instances.push_back(instance);
+        }
+    }
+    catch (...)
+    {
+        // Let the component be destroyed if it couldn't be recycled
+    }
+}
+
+
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+ComponentImpl::ComponentImpl(const Type& type, const Version& version) :
+    dm_mutex(),
+    dm_type(type),
+    dm_version(version),
+    dm_input_schema(emptySchema()),
+    dm_output_schema(emptySchema()),
+    dm_inputs(new InputTable()),
+    dm_outputs(new OutputTable()),
+    dm_upstream(),
+    dm_asynchronous(false),
+    dm_mailbox_mutex(),
+    dm_mailbox(),
+    dm_mailbox_scheduled(false)
+{
+    StatisticsReport& report = statisticsReport();
+    if (report.dm_enabled)
+    {
+        boost::mutex::scoped_lock guard_report(report.dm_mutex);
+        report.dm_components.insert(this);
+    }
+}
+
+
+
+//------------------------------------------------------------------------------
+// Write this component's statistics if requested by the environment. Then
+// remove all connections involving this component from the other components
+// so that they aren't left holding expired connections.
+//------------------------------------------------------------------------------
+ComponentImpl::~ComponentImpl()
+{
+    StatisticsReport& report = statisticsReport();
+    if (report.dm_enabled)
+    {
+        boost::mutex::scoped_lock guard_report(report.dm_mutex);
+        if (report.dm_components.erase(this) > 0)
+        {
+            StatisticsReport::write(*this);
+        }
+    }
+    
+    removeConnections();
+}
+
+
+
+//------------------------------------------------------------------------------
+// Connections to this component are removed from its upstream components, and
+// this component is removed from the upstream lists of its downstream
+// components.
+//------------------------------------------------------------------------------
+void ComponentImpl::removeConnections()
+{
+    boost::mutex::scoped_lock guard_topology(topology());
+
+    for (std::multiset<ComponentImpl*>::const_iterator
+             i = dm_upstream.begin();
+         i != dm_upstream.end();
+         i = dm_upstream.upper_bound(*i))
+    {
+        if (*i != this)
+        {
+            boost::mutex::scoped_lock guard_upstream((*i)->dm_mutex);
+            (*i)->removeTargets(this);
+        }
+    }
+
+    const OutputTable& outputs = *dm_outputs.get();
+    for (OutputTable::OutputList::const_iterator
+             i = outputs.dm_outputs.begin(); i != outputs.dm_outputs.end(); ++i)
+    {
+        if (i->dm_targets)
+        {
+            for (TargetList::const_iterator
+                     j = i->dm_targets->begin();
+                 j != i->dm_targets->end();
+                 ++j)
+            {
+                if (j->dm_impl != this)
+                {
+                    j->dm_impl->dm_upstream.erase(
+                        j->dm_impl->dm_upstream.find(this)
+                        );
+                }
+            }
+        }
+    }
+
+}
+
+
+
+//------------------------------------------------------------------------------
+// Called after removeConnections() when this component is about to be reused,
+// so that it is left in the same state as a newly constructed component.
+//------------------------------------------------------------------------------
+void ComponentImpl::discardConnections()
+{
+    {
+        boost::mutex::scoped_lock guard_topology(topology());
+        dm_upstream.clear();
+        dm_asynchronous = false;
+    }
+
+    {
+        boost::mutex::scoped_lock guard_outputs(dm_mutex);
+        OutputTable* updated = new OutputTable(*dm_outputs.get());
+        for (OutputTable::OutputList::iterator
+                 i = updated->dm_outputs.begin();
+             i != updated->dm_outputs.end();
+             ++i)
+        {
+            i->dm_targets.reset();
+            if (i->dm_connected != NULL)
+            {
+                i->dm_connected->store(false);
+            }
+        }
+        dm_outputs.publish(updated);
+    }
+
+    boost::mutex::scoped_lock guard_mailbox(dm_mailbox_mutex);
+    dm_mailbox.clear();
+    dm_mailbox_scheduled = false;
+}
+
+
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+std::string ComponentImpl::getBuildString() const
+{
+#if defined(__GNUC__)
+    return boost::str(
+        boost::format("Built by GCC %1%.%2%.%3% at %4% on %5%.")
+        % __GNUC__ % __GNUC_MINOR__ % __GNUC_PATCHLEVEL__ % __TIME__ % __DATE__
+        );    
+#else
+    return boost::str(
+        boost::format("Built by an unidentified compiler at %1% on %2%.")
+        % __TIME__ % __DATE__
+        );
+#endif
+}
+
+
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+Type ComponentImpl::getType() const
+{
+    return dm_type;
+}
+
+
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+Version ComponentImpl::getVersion() const
+{
+    return dm_version;
+}
+
+
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+const std::map<std::string, Type>& ComponentImpl::getInputs() const
+{
+    return *dm_input_schema.load(boost::memory_order_acquire);
+}
+
+
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+const std::map<std::string, Type>& ComponentImpl::getOutputs() const
+{
+    return *dm_output_schema.load(boost::memory_order_acquire);
+}
+
+
+
+//------------------------------------------------------------------------------
+// Take a copy of the current value of each counter. Counters are updated
+// without locking, so the copy isn't necessarily a consistent snapshot of
+// any single point in time.
+//------------------------------------------------------------------------------
+Statistics ComponentImpl::getStatistics() const
+{
+    Epoch::Guard guard_epoch;
+
+    const InputTable& inputs = *dm_inputs.get();
+    const OutputTable& outputs = *dm_outputs.get();
+
+    Statistics statistics;
+
+    for (InputTable::const_iterator i = inputs.begin(); i != inputs.end(); ++i)
+    {
+        const InputCounters& counters = *(i->second.dm_counters);
+
+        Statistics::Input input;
+        input.dm_values = counters.dm_values.load();
+        input.dm_invocations = counters.dm_invocations.load();
+        input.dm_time = counters.dm_time.load();
+        for (std::size_t b = 0; b < Statistics::kHistogramBuckets; ++b)
+        {
+            input.dm_histogram.push_back(counters.dm_histogram[b].load());
+        }
+
+        statistics.dm_inputs.insert(std::make_pair(*i->first, input));
+    }
+
+    for (OutputTable::OutputList::const_iterator
+             i = outputs.dm_outputs.begin(); i != outputs.dm_outputs.end(); ++i)
+    {
+        Statistics::Output output;
+        output.dm_values = i->dm_counters->dm_values.load();
+        output.dm_emissions = i->dm_counters->dm_emissions.load();
+
+        statistics.dm_outputs.insert(
+            std::make_pair(i->dm_port->first, output)
+            );
+    }
+    
+    return statistics;
+}
+
+
+
+//------------------------------------------------------------------------------
+// Publish an updated copy of this component's inputs, and their schema, that
+// includes the specified input.
+//------------------------------------------------------------------------------
+void ComponentImpl::declareInputImpl(
+    const std::string& name,
+    const Type& type,
+    const boost::shared_ptr<Impl::Invoker>& handler
+    )
+{
+    boost::mutex::scoped_lock guard_this(dm_mutex);
+
+    const InputTable& inputs = *dm_inputs.get();
+    
+    if (inputs.find(&name) != inputs.end())
+    {
+        raise<std::invalid_argument>(
+            "An input has already been declared with the given name (%1%).",
+            name
+            );
+    }
+
+    const Schema* schema = extendSchema(
+        dm_input_schema.load(boost::memory_order_relaxed), name, type
+        );
+    const Schema::value_type& port = *schema->find(name);
+    
+    Input input = {
+        &port, handler,
+        boost::allocate_shared<InputCounters>(
+            ArenaAllocator<InputCounters>(), dm_type, name
+            )
+        };
+    InputTable* updated = new InputTable(inputs);
+    updated->insert(std::make_pair(&port.first, input));
+    dm_inputs.publish(updated);
+    dm_input_schema.store(schema, boost::memory_order_release);
+}
+
+
+
+//------------------------------------------------------------------------------
+// Publish an updated copy of this component's outputs, and their schema, that
+// includes the specified output.
+//------------------------------------------------------------------------------
+std::size_t ComponentImpl::declareOutputImpl(const std::string& name,
+                                             const Type& type,
+                                             boost::atomic<bool>* connected)
+{
+    boost::mutex::scoped_lock guard_this(dm_mutex);
+
+    const OutputTable& outputs = *dm_outputs.get();
+    
+    if (outputs.dm_names.find(&name) != outputs.dm_names.end())
+    {
+        raise<std::invalid_argument>(
+            "An output has already been declared with the given name (%1%).",
+            name
+            );
+    }
+
+    const std::size_t index = outputs.dm_outputs.size();
+
+    const Schema* schema = extendSchema(
+        dm_output_schema.load(boost::memory_order_relaxed), name, type
+        );
+    const Schema::value_type& port = *schema->find(name);
+    
+    Output output = {
+        &port, boost::shared_ptr<const TargetList>(),
+        boost::allocate_shared<OutputCounters>(
+            ArenaAllocator<OutputCounters>()
+            ),
+        connected
+        };
+    OutputTable* updated = new OutputTable(outputs);
+    updated->dm_outputs.push_back(output);
+    updated->dm_names.insert(std::make_pair(&port.first, index));
+    dm_outputs.publish(updated);
+    dm_output_schema.store(schema, boost::memory_order_release);
+
+    return index;
+}
+
+
+
+//------------------------------------------------------------------------------
+// Look up the specified output in the currently published snapshot of this
+// component's outputs, and then pass the output value to each of its current
+// connections. No lock is acquired. Instead the snapshot is protected by an
+// epoch critical section only long enough to take a reference to the output's
+// list of connections. The critical section is left before any handler is
+// called, so that long-running handlers, and everything downstream of them,
+// don't delay the reclamation of retired snapshots. Handlers can thus freely
+// connect or disconnect components, including this one.
+//------------------------------------------------------------------------------
+void ComponentImpl::emitOutputImpl(const std::string& name, const Type& type,
+                                   const Impl::Value& value)
+{
+    boost::shared_ptr<const TargetList> targets;
+    {
+        Epoch::Guard guard_epoch;
+        targets = getTargets(findOutput(*dm_outputs.get(), name, type), value);
+    }
+    dispatch(targets.get(), value);
+}
+
+
+
+//------------------------------------------------------------------------------
+// Pass the output value to each of the current connections of the specified
+// output without acquiring any lock. See above.
+//------------------------------------------------------------------------------
+void ComponentImpl::emitOutputImpl(const std::size_t& index, const Type& type,
+                                   const Impl::Value& value)
+{
+    boost::shared_ptr<const TargetList> targets;
+    {
+        Epoch::Guard guard_epoch;
+        targets = getTargets(findOutput(*dm_outputs.get(), index, type), value);
+    }
+    dispatch(targets.get(), value);
+}
+
+
+
+//------------------------------------------------------------------------------
+// Pass the batch of output values to each of the current connections of the
+// specified output without acquiring any lock. See above. Empty batches are
+// checked but not passed on.
+//------------------------------------------------------------------------------
+void ComponentImpl::emitOutputImpl(const std::string& name, const Type& type,
+                                   const Impl::Batch& batch)
+{
+    boost::shared_ptr<const TargetList> targets;
+    {
+        Epoch::Guard guard_epoch;
+        const Output& output = findOutput(*dm_outputs.get(), name, type);
+        if (batch.empty())
+        {
+            return;
+        }
+        targets = getTargets(output, batch);
+    }
+    dispatch(targets.get(), batch);
+}
+
+
+
+//------------------------------------------------------------------------------
+// Pass the batch of output values to each of the current connections of the
+// specified output without acquiring any lock. See above.
+//------------------------------------------------------------------------------
+void ComponentImpl::emitOutputImpl(const std::size_t& index, const Type& type,
+                                   const Impl::Batch& batch)
+{
+    boost::shared_ptr<const TargetList> targets;
+    {
+        Epoch::Guard guard_epoch;
+        const Output& output = findOutput(*dm_outputs.get(), index, type);
+        if (batch.empty())
+        {
+            return;
+        }
+        targets = getTargets(output, batch);
+    }
+    dispatch(targets.get(), batch);
+}
 
 
 
 //------------------------------------------------------------------------------
-// Load the module with the specified path (after path resolution) if it hasn't
-// already been loaded. Loading a module causes all of the components contained
-// within that module to be registered with this class.
+// Find the output with the specified name and check that it is of the type
+// being emitted.
 //------------------------------------------------------------------------------
-void ComponentImpl::registerPlugin(const boost::filesystem::path& path)
+const ComponentImpl::Output& ComponentImpl::findOutput(
+    const OutputTable& outputs, const std::string& name, const Type& type
+    )
 {
-    boost::filesystem::path resolved_path = resolvePath(kPluginFileType, path);
-
-    if (resolved_path.empty())
+    OutputTable::NameMap::const_iterator i =
+        outputs.dm_names.find(&name);
+    if (i == outputs.dm_names.end())
     {
-        raise<std::runtime_error>(
-            "The specified plugin (%1%) doesn't exist.", path
+        raise<std::invalid_argument>(
+            "The requested output (%1%) wasn't declared.", name
             );
     }
     
-    Plugins::GuardType guard_plugins(Plugins::mutex());
-
-    if (Plugins::value().find(resolved_path) != Plugins::value().end())
-    {
-        return;
-    }
-    
-    if (dlopen(resolved_path.string().c_str(), RTLD_NOW) == NULL)
+    const Output& output = outputs.dm_outputs[i->second];
+    if (output.dm_port->second != type)
     {
-        raise<std::runtime_error>(
-            "The specified plugin (%1%) doesn't exist or is not "
-            "of the correct format. dlopen() reported \"%2%\".",
-            resolved_path, dlerror()
+        raise<std::invalid_argument>(
+            "The given value type (%1%) doesn't "
+            "match the output's declared type (%2%).",
+            type, output.dm_port->second
             );
     }
-    
-    Plugins::value().insert(path);
+
+    return output;
 }
 
 
 
 //------------------------------------------------------------------------------
-// Add the specified component factory function to the set of available
-// components. Doing so requires instantiating the component in order to
-// obtain its type and version.
+// Find the output with the specified index and check that it is of the type
+// being emitted.
 //------------------------------------------------------------------------------
-void ComponentImpl::registerFactoryFunction(
-    const Component::FactoryFunction& function
+const ComponentImpl::Output& ComponentImpl::findOutput(
+    const OutputTable& outputs, const std::size_t& index, const Type& type
     )
 {
-    Component::Instance instance = function();
-
-    Factories::GuardType guard_factories(Factories::mutex());
-    
-    Factories::Type::iterator i = Factories::value().find(instance->getType());
-    if (i == Factories::value().end())
+    if ((index >= outputs.dm_outputs.size()) ||
+        (outputs.dm_outputs[index].dm_port->second != type))
     {
-        i = Factories::value().insert(
-            std::make_pair(instance->getType(), Factories::Type::mapped_type())
-            ).first;
+        raise<std::invalid_argument>(
+            "The given output handle (%1%) doesn't refer to "
+            "an output of this component.", index
+            );
     }
     
-    i->second.insert(std::make_pair(instance->getVersion(), function));
+    return outputs.dm_outputs[index];
 }
 
 
 
 //------------------------------------------------------------------------------
-// Construct and return the set of available component types.
 //------------------------------------------------------------------------------
-std::set<Type> ComponentImpl::getAvailableTypes()
+const ComponentImpl::Schema* ComponentImpl::emptySchema()
 {
-    Factories::GuardType guard_factories(Factories::mutex());
-
-    std::set<Type> available_types;
-    for (Factories::Type::const_iterator
-             i = Factories::value().begin(); i != Factories::value().end(); ++i)
-    {
-        available_types.insert(i->first);
-    }
-    
-    return available_types;
+    SchemaTable& table = schemaTable();
+    boost::mutex::scoped_lock guard_table(table.dm_mutex);
+    return &*table.dm_schemas.insert(Schema()).first;
 }
 
 
 
 //------------------------------------------------------------------------------
-// Construct and return the set of available versions of the given component
-// type.
+// Look up the cached extension first. Otherwise build the extended schema and
+// intern it, so that extending different schemas to the same set of ports, or
+// declaring the same ports in a different order, still yields a single schema.
 //------------------------------------------------------------------------------
-std::set<Version> ComponentImpl::getAvailableVersions(const Type& type)
+const ComponentImpl::Schema* ComponentImpl::extendSchema(
+    const Schema* schema, const std::string& name, const Type& type
+    )
 {
-    Factories::GuardType guard_factories(Factories::mutex());
+    SchemaTable& table = schemaTable();
+    boost::mutex::scoped_lock guard_table(table.dm_mutex);
 
-    Factories::Type::const_iterator i = Factories::value().find(type);
-    if (i == Factories::value().end())
+    std::pair<const Schema*, std::pair<std::string, Type> > key(
+        schema, std::make_pair(name, type)
+        );
+    
+    std::map<
+        std::pair<const Schema*, std::pair<std::string, Type> >,
+        const Schema*
+        >::const_iterator i = table.dm_extensions.find(key);
+    if (i != table.dm_extensions.end())
     {
-        raise<std::runtime_error>(
-            "There are no available versions of "
-            "of the given component type (%1%).",
-            type
-            );
+        return i->second;
     }
 
-    std::set<Version> available_versions;
-    for (Factories::Type::mapped_type::const_iterator
-             j = i->second.begin(); j != i->second.end(); ++j)
-    {
-        available_versions.insert(j->first);
-    }
-    
-    return available_versions;
+    Schema extended(*schema);
+    extended.insert(std::make_pair(name, type));
+
+    const Schema* interned = &*table.dm_schemas.insert(extended).first;
+    table.dm_extensions.insert(std::make_pair(key, interned));
+    return interned;
 }
 
 
 
 //------------------------------------------------------------------------------
-// Use the set of available components to find the component factory function
-// corresponding to the specified component type and version, then instantiate
-// the component and return it.
+// Count the specified value (or batch) emitted on the given output, and then
+// take a reference to the output's current list of connections. The list is
+// immutable, and the reference keeps it alive after the caller leaves its
+// epoch critical section, even if the output is reconnected in the meantime.
 //------------------------------------------------------------------------------
-Component::Instance ComponentImpl::instantiate(
-    const Type& type,
-    const boost::optional<Version>& version
+template <typename V>
+boost::shared_ptr<const ComponentImpl::TargetList> ComponentImpl::getTargets(
+    const Output& output, const V& value
     )
 {
-    Factories::GuardType guard_factories(Factories::mutex());
-
-    Factories::Type::const_iterator i = Factories::value().find(type);
-    if (i == Factories::value().end())
+    if (collecting_statistics.load(boost::memory_order_relaxed))
     {
-        raise<std::runtime_error>(
-            "There is no factory function registered "
-            "for the specified component type (%1%).",
-            type
+        output.dm_counters->dm_values.fetch_add(
+            countOf(value), boost::memory_order_relaxed
             );
-    }
-
-    if (!version)
-    {
-        return i->second.rbegin()->second();
-    }
-
-    Factories::Type::mapped_type::const_iterator j = 
-        i->second.find(version.get());
-
-    if (j == i->second.end())
-    {
-        raise<std::runtime_error>(
-            "There is no factory function registered "
-            "for the specified component version (%1%).",
-            *version
+        output.dm_counters->dm_emissions.fetch_add(
+            1, boost::memory_order_relaxed
             );
     }
-    
-    return j->second();
+
+    return output.dm_targets;
 }
 
 
 
 //------------------------------------------------------------------------------
-// Check the validity of the specified connection and then add it to the
-// output component's connections.
+// Pass the specified value (or batch) to each of the given component inputs.
+// Each input component is locked for the duration of the call to its handler
+// so that it can't be destroyed out from under the handler. That also keeps
+// the input's handler and counters, which are owned by its component, alive.
+// Input components which have already been (or are being) destroyed are simply
+// skipped. Inputs that are invoked asynchronously receive the value via their
+// component's mailbox.
 //------------------------------------------------------------------------------
-void ComponentImpl::connect(Component::Instance output_instance,
-                            const std::string& output_name,
-                            Component::Instance input_instance,
-                            const std::string& input_name)
+template <typename V>
+void ComponentImpl::dispatch(const TargetList* targets, const V& value)
 {
-    ComponentImpl& output_impl = *(output_instance->dm_impl);
-    ComponentImpl& input_impl = *(input_instance->dm_impl);
-
-    boost::unique_lock<boost::shared_mutex> guard_output(output_impl.dm_mutex);
-
-    boost::shared_ptr<boost::shared_lock<boost::shared_mutex> > guard_input;
-    if (input_instance->dm_impl != output_instance->dm_impl)
-    {
-        guard_input.reset(
-            new boost::shared_lock<boost::shared_mutex>(input_impl.dm_mutex)
-            );
-    }
-    
-    if (output_impl.dm_outputs.find(output_name) == 
-        output_impl.dm_outputs.end())
-    {
-        raise<std::runtime_error>(
-            "The requested output (%1%) doesn't exist.", output_name
-            );
-    }
-    
-    if (input_impl.dm_inputs.find(input_name) ==
-        input_impl.dm_inputs.end())
+    if (targets == NULL)
     {
-        raise<std::runtime_error>(
-            "The requested input (%1%) doesn't exist.", input_name
-            );
+        return;
     }
     
-    if (output_impl.dm_outputs.find(output_name)->second !=
-        input_impl.dm_inputs.find(input_name)->second)
-    {
-        raise<std::runtime_error>(
-            "The requested output (%1%) and input "
-            "(%2%) are not of compatible types.",
-            output_name, input_name
-            );
-    }
-
-    const ConnectionMap::const_iterator i_begin =
-        output_impl.dm_connections.lower_bound(output_name);
-    const ConnectionMap::const_iterator i_end =
-        output_impl.dm_connections.upper_bound(output_name);
-
-    for (ConnectionMap::const_iterator i = i_begin; i != i_end; ++i)
+    for (TargetList::const_iterator
+             i = targets->begin(); i != targets->end(); ++i)
     {
-        Component::Instance i_instance = i->second.first.lock();
+        Component::Instance instance = i->dm_instance.lock();
+        if (!instance)
+        {
+            continue;
+        }
 
-        if (i_instance && (i_instance == input_instance) &&
-            (i->second.second == input_name))
+        if (i->dm_asynchronous)
         {
-            raise<std::runtime_error>(
-                "The requested output (%1%) and input (%2%) "
-                "are already connected to each other.",
-                output_name, input_name
-                );
+            i->dm_impl->post(instance, *i, value);
+        }
+        else
+        {
+            invoke(*(i->dm_invoker), *(i->dm_counters), value);
         }
     }
-
-    output_impl.dm_connections.insert(
-        std::make_pair(output_name, std::make_pair(input_instance, input_name))
-        );
 }
 
 
 
 //------------------------------------------------------------------------------
-// Check the validity of the specified connection and then remove it from the
-// output component's connections.
+// Only read the clock when statistics are being collected or tracing is
+// enabled.
 //------------------------------------------------------------------------------
-void ComponentImpl::disconnect(Component::Instance output_instance,
-                               const std::string& output_name,
-                               Component::Instance input_instance,
-                               const std::string& input_name)
+template <typename V>
+void ComponentImpl::invoke(const Impl::Invoker& invoker,
+                           InputCounters& counters,
+                           const V& value)
 {
-    ComponentImpl& output_impl = *(output_instance->dm_impl);
-    ComponentImpl& input_impl = *(input_instance->dm_impl);
-
-    boost::unique_lock<boost::shared_mutex> guard_output(output_impl.dm_mutex);
+    const bool is_collecting =
+        collecting_statistics.load(boost::memory_order_relaxed);
+    const bool is_tracing = Trace::isEnabled();
 
-    boost::shared_ptr<boost::shared_lock<boost::shared_mutex> > guard_input;
-    if (input_instance->dm_impl != output_instance->dm_impl)
+    if (!is_collecting && !is_tracing)
     {
-        guard_input.reset(
-            new boost::shared_lock<boost::shared_mutex>(input_impl.dm_mutex)
-            );
+        invoker(value);
+        return;
     }
     
-    if (output_impl.dm_outputs.find(output_name) ==
-        output_impl.dm_outputs.end())
+    const boost::uint64_t start = Trace::now();
+    invoker(value);
+    const boost::uint64_t time = Trace::now() - start;
+
+    if (is_collecting)
     {
-        raise<std::runtime_error>(
-            "The requested output (%1%) doesn't exist.", output_name
-            );
+        counters.record(countOf(value), time);
     }
-    
-    if (input_impl.dm_inputs.find(input_name) ==
-        input_impl.dm_inputs.end())
+    if (is_tracing)
     {
-        raise<std::runtime_error>(
-            "The requested input (%1%) doesn't exist.", input_name
-            );
+        Trace::record(counters.dm_trace_category, counters.dm_trace_name,
+                      start, time);
     }
+}
+
 
-    const ConnectionMap::iterator i_begin =
-        output_impl.dm_connections.lower_bound(output_name);
-    const ConnectionMap::iterator i_end =
-        output_impl.dm_connections.upper_bound(output_name);
 
-    for (ConnectionMap::iterator i = i_begin; i != i_end; ++i)
+//------------------------------------------------------------------------------
+// Rebuild the connection list of each output that includes the given component
+// and publish the updated outputs. The caller must hold the topology lock as
+// well as this component's lock.
+//------------------------------------------------------------------------------
+void ComponentImpl::removeTargets(const ComponentImpl* impl)
+{
+    OutputTable updated(*dm_outputs.get());
+    bool changed = false;
+    
+    for (OutputTable::OutputList::iterator
+             i = updated.dm_outputs.begin(); i != updated.dm_outputs.end(); ++i)
     {
-        Component::Instance i_instance = i->second.first.lock();
+        if (!i->dm_targets)
+        {
+            continue;
+        }
 
-        if (i_instance && (i_instance == input_instance) &&
-            (i->second.second == input_name))
+        boost::shared_ptr<TargetList> targets(new TargetList());
+        for (TargetList::const_iterator
+                 j = i->dm_targets->begin(); j != i->dm_targets->end(); ++j)
         {
-            output_impl.dm_connections.erase(i);
-            return;
+            if (j->dm_impl != impl)
+            {
+                targets->push_back(*j);
+            }
+        }
+        
+        if (targets->size() != i->dm_targets->size())
+        {
+            i->dm_targets = targets->empty() ? 
+                boost::shared_ptr<const TargetList>() : targets;
+            if (targets->empty() && (i->dm_connected != NULL))
+            {
+                i->dm_connected->store(false);
+            }
+            changed = true;
         }
     }
-    
-    raise<std::runtime_error>(
-        "The requested output (%1%) and input "
-        "(%2%) are not connected to each other.",
-        output_name, input_name
-        );
+
+    if (changed)
+    {
+        dm_outputs.publish(new OutputTable(updated));
+    }
 }
 
 
 
 //------------------------------------------------------------------------------
+// Rebuild the connection list of each output that includes the given component
+// so that they reflect whether that component is currently asynchronous, and
+// publish the updated outputs. The caller must hold the topology lock as well
+// as this component's lock.
 //------------------------------------------------------------------------------
-ComponentImpl::ComponentImpl(const Type& type, const Version& version) :
-    dm_mutex(),
-    dm_type(type),
-    dm_version(version),
-    dm_inputs(),
-    dm_outputs(),
-    dm_handlers(),
-    dm_connections()
+void ComponentImpl::updateTargets(const ComponentImpl* impl)
 {
-}
-
+    OutputTable updated(*dm_outputs.get());
+    
+    for (OutputTable::OutputList::iterator
+             i = updated.dm_outputs.begin(); i != updated.dm_outputs.end(); ++i)
+    {
+        if (!i->dm_targets)
+        {
+            continue;
+        }
 
+        boost::shared_ptr<TargetList> targets(new TargetList(*i->dm_targets));
+        for (TargetList::iterator j = targets->begin(); j != targets->end(); ++j)
+        {
+            if (j->dm_impl == impl)
+            {
+                j->dm_asynchronous = 
+                    j->dm_asynchronous_connection || impl->dm_asynchronous;
+            }
+        }
+        i->dm_targets = targets;
+    }
 
-//------------------------------------------------------------------------------
-//------------------------------------------------------------------------------
-ComponentImpl::~ComponentImpl()
-{
+    dm_outputs.publish(new OutputTable(updated));
 }
 
 
 
 //------------------------------------------------------------------------------
+// Retain the value, so that it outlives the emission, and post it.
 //------------------------------------------------------------------------------
-std::string ComponentImpl::getBuildString() const
+void ComponentImpl::post(const Component::Instance& instance,
+                         const Target& target,
+                         const Impl::Value& value)
 {
-#if defined(__GNUC__)
-    return boost::str(
-        boost::format("Built by GCC %1%.%2%.%3% at %4% on %5%.")
-        % __GNUC__ % __GNUC_MINOR__ % __GNUC_PATCHLEVEL__ % __TIME__ % __DATE__
-        );    
-#else
-    return boost::str(
-        boost::format("Built by an unidentified compiler at %1% on %2%.")
-        % __TIME__ % __DATE__
-        );
-#endif
+    Message message = {
+        target.dm_invoker, target.dm_counters, value.retain(), Impl::Batch()
+        };
+    post(instance, message);
 }
 
 
 
 //------------------------------------------------------------------------------
+// Retain the batch, so that it outlives the emission, and post it intact.
 //------------------------------------------------------------------------------
-Type ComponentImpl::getType() const
+void ComponentImpl::post(const Component::Instance& instance,
+                         const Target& target,
+                         const Impl::Batch& batch)
 {
-    return dm_type;
+    Message message = {
+        target.dm_invoker, target.dm_counters, Impl::Value(), batch.retain()
+        };
+    post(instance, message);
 }
 
 
 
 //------------------------------------------------------------------------------
+// Add the message to the back of the mailbox. Queue a task to drain the mailbox
+// unless one is already queued. The task refers to this component weakly so
+// that it doesn't keep components alive.
 //------------------------------------------------------------------------------
-Version ComponentImpl::getVersion() const
+void ComponentImpl::post(const Component::Instance& instance,
+                         const Message& message)
 {
-    return dm_version;
+    {
+        boost::mutex::scoped_lock guard_mailbox(dm_mailbox_mutex);
+        dm_mailbox.push_back(message);
+        if (dm_mailbox_scheduled)
+        {
+            return;
+        }
+        dm_mailbox_scheduled = true;
+    }
+    
+    Executor::instance().submit(boost::bind(
+        &ComponentImpl::drain, boost::weak_ptr<Component>(instance)
+        ));
 }
 
 
 
 //------------------------------------------------------------------------------
+// Pass the values in the mailbox, in the order they were received, to their
+// handler functions. Since only one drain of any given mailbox is ever queued
+// at once, a component's handlers are never invoked concurrently and ordering
+// is preserved. After handling a bounded number of values, the drain of this
+// mailbox is queued again in order to give other components a turn. Exceptions
+// thrown by the handlers are reported and never escape, since the mailbox would
+// otherwise remain scheduled with no drain queued.
 //------------------------------------------------------------------------------
-std::map<std::string, Type> ComponentImpl::getInputs() const
+void ComponentImpl::drain(const boost::weak_ptr<Component>& instance)
 {
-    boost::shared_lock<boost::shared_mutex> guard_this(dm_mutex);
-    return dm_inputs;
-}
+    Component::Instance locked_instance = instance.lock();
+    if (!locked_instance)
+    {
+        return;
+    }
 
+    ComponentImpl& impl = *(locked_instance->dm_impl);
 
+    for (std::size_t n = 0; n < kMailboxDrainLimit; ++n)
+    {
+        Message message;
+        
+        {
+            boost::mutex::scoped_lock guard_mailbox(impl.dm_mailbox_mutex);
+            if (impl.dm_mailbox.empty())
+            {
+                impl.dm_mailbox_scheduled = false;
+                return;
+            }
+            message = impl.dm_mailbox.front();
+            impl.dm_mailbox.pop_front();
+        }
 
-//------------------------------------------------------------------------------
-//------------------------------------------------------------------------------
-std::map<std::string, Type> ComponentImpl::getOutputs() const
-{
-    boost::shared_lock<boost::shared_mutex> guard_this(dm_mutex);
-    return dm_outputs;
+        try
+        {
+            if (message.dm_batch.empty())
+            {
+                invoke(*(message.dm_invoker), *(message.dm_counters),
+                       message.dm_value);
+            }
+            else
+            {
+                invoke(*(message.dm_invoker), *(message.dm_counters),
+                       message.dm_batch);
+            }
+        }
+        catch (const std::exception& error)
+        {
+            std::cerr << "[CBTF " << boost::this_thread::get_id() << "] "
+                      << "EXCEPTION in asynchronous handler of component ("
+                      << impl.dm_type << "): " << error.what() << std::endl;
+        }
+        catch (...)
+        {
+            std::cerr << "[CBTF " << boost::this_thread::get_id() << "] "
+                      << "EXCEPTION in asynchronous handler of component ("
+                      << impl.dm_type << "): unknown exception" << std::endl;
+        }
+    }
+    
+    Executor::instance().submit(boost::bind(&ComponentImpl::drain, instance));
 }
 
 
 
 //------------------------------------------------------------------------------
-// Add the specified input to this component's inputs.
 //------------------------------------------------------------------------------
-void ComponentImpl::declareInputImpl(
-    const std::string& name,
-    const Type& type,
-    const boost::shared_ptr<Impl::Invoker>& handler
-    )
+ComponentImpl::InputCounters::InputCounters(const Type& type,
+                                            const std::string& name) :
+    dm_values(0),
+    dm_invocations(0),
+    dm_time(0),
+    dm_trace_category(Trace::intern(type)),
+    dm_trace_name(Trace::intern(name))
 {
-    boost::unique_lock<boost::shared_mutex> guard_this(dm_mutex);
-
-    if (dm_inputs.find(name) != dm_inputs.end())
+    for (std::size_t b = 0; b < Statistics::kHistogramBuckets; ++b)
     {
-        raise<std::invalid_argument>(
-            "An input has already been declared with the given name (%1%).",
-            name
-            );
+        dm_histogram[b].store(0);
     }
-
-    dm_inputs.insert(std::make_pair(name, type));
-    dm_handlers.insert(std::make_pair(name, handler));
 }
 
 
 
 //------------------------------------------------------------------------------
-// Add the specified output to this component's outputs.
+// Find the histogram bucket from the position of the most significant bit set
+// in the time taken by the invocation.
 //------------------------------------------------------------------------------
-void ComponentImpl::declareOutputImpl(const std::string& name, const Type& type)
+void ComponentImpl::InputCounters::record(const std::size_t& values,
+                                          const boost::uint64_t& time)
 {
-    boost::unique_lock<boost::shared_mutex> guard_this(dm_mutex);
-
-    if (dm_outputs.find(name) != dm_outputs.end())
+    std::size_t bucket = 0;
+    for (boost::uint64_t t = time;
+         (t > 1) && (bucket < (Statistics::kHistogramBuckets - 1));
+         t >>= 1)
     {
-        raise<std::invalid_argument>(
-            "An output has already been declared with the given name (%1%).",
-            name
-            );
+        ++bucket;
     }
-
-    dm_outputs.insert(std::make_pair(name, type));
+    
+    dm_values.fetch_add(values, boost::memory_order_relaxed);
+    dm_invocations.fetch_add(1, boost::memory_order_relaxed);
+    dm_time.fetch_add(time, boost::memory_order_relaxed);
+    dm_histogram[bucket].fetch_add(1, boost::memory_order_relaxed);
 }
 
 
 
 //------------------------------------------------------------------------------
-// Pass the specified output value to each of the component inputs to which
-// the given output is connected.
 //------------------------------------------------------------------------------
-void ComponentImpl::emitOutputImpl(const std::string& name, const Type& type,
-                                   const boost::any& value)
+ComponentImpl::OutputCounters::OutputCounters() :
+    dm_values(0),
+    dm_emissions(0)
 {
-    boost::shared_lock<boost::shared_mutex> guard_this(dm_mutex);
-
-    if (dm_outputs.find(name) == dm_outputs.end())
-    {
-        raise<std::invalid_argument>(
-            "The requested output (%1%) wasn't declared.", name
-            );
-    }
-    if (dm_outputs.find(name)->second != type)
-    {
-        raise<std::invalid_argument>(
-            "The given value type (%1%) doesn't "
-            "match the output's declared type (%2%).",
-            type, dm_outputs.find(name)->second
-            );
-    }
-    
-    const ConnectionMap::const_iterator i_begin =
-        dm_connections.lower_bound(name);
-    const ConnectionMap::const_iterator i_end =
-        dm_connections.upper_bound(name);
-    
-    for (ConnectionMap::const_iterator i = i_begin; i != i_end; ++i)
-    {
-        Component::Instance i_instance = i->second.first.lock();
-        if (!i_instance)
-        {
-            continue;
-        }
-
-        const ComponentImpl& input_impl = *(i_instance->dm_impl);
-        const std::string& input_name = i->second.second;
-
-        BOOST_ASSERT(input_impl.dm_inputs.find(input_name) !=
-                     input_impl.dm_inputs.end());
-        BOOST_ASSERT(input_impl.dm_inputs.find(input_name)->second == type);
-        
-        const HandlerMap::const_iterator j = 
-            input_impl.dm_handlers.find(input_name);
-        if (j != input_impl.dm_handlers.end())
-        {
-            (*(j->second))(value);
-        }
-    }
 }
@@ -20,20 +20,32 @@
 
 #pragma once
 
-#include <boost/any.hpp>
+#include <boost/atomic.hpp>
+#include <boost/cstdint.hpp>
 #include <boost/filesystem.hpp>
 #include <boost/noncopyable.hpp>
 #include <boost/optional.hpp>
 #include <boost/shared_ptr.hpp>
-#include <boost/thread/shared_mutex.hpp>
+#include <boost/thread/mutex.hpp>
 #include <boost/weak_ptr.hpp>
 #include <KrellInstitute/CBTF/Component.hpp>
+#include <KrellInstitute/CBTF/Impl/Batch.hpp>
+#include <KrellInstitute/CBTF/Impl/Epoch.hpp>
 #include <KrellInstitute/CBTF/Impl/Invoker.hpp>
+#include <KrellInstitute/CBTF/Impl/Value.hpp>
+#include <KrellInstitute/CBTF/Statistics.hpp>
+#include <KrellInstitute/CBTF/Trace.hpp>
 #include <KrellInstitute/CBTF/Type.hpp>
 #include <KrellInstitute/CBTF/Version.hpp>
+#include <cstddef>
+#include <deque>
 #include <map>
+#include <set>
 #include <string>
 #include <utility>
+#include <vector>
+
+#include "Arena.hpp"
 
 namespace KrellInstitute { namespace CBTF { namespace Impl {
 
@@ -50,18 +62,47 @@ namespace KrellInstitute { namespace CBTF { namespace Impl {
 
         /** Register a plugin providing one or more component types. */
         static void registerPlugin(const boost::filesystem::path& path);
+
+        /** Register several plugins, in parallel, at once. */
+        static void registerPlugins(
+            const std::vector<boost::filesystem::path>& paths,
+            const std::vector<boost::filesystem::path>& search_paths
+            );
+
+        /** Write the manifest of a plugin providing component types. */
+        static void writePluginManifest(const boost::filesystem::path& path);
         
         /** Register a factory function which instantiates components. */
         static void registerFactoryFunction(
             const Component::FactoryFunction& function
             );
 
+        /** Register a factory function along with its descriptor. */
+        static void registerFactoryFunction(
+            const Component::Descriptor& descriptor,
+            const Component::FactoryFunction& function
+            );
+
         /** Get the available component types. */
         static std::set<Type> getAvailableTypes();
 
         /** Get the available versions of the given component type. */
         static std::set<Version> getAvailableVersions(const Type& type);
 
+        /** Set the capacity of the pool of recycled instances of a type. */
+        static void setPoolCapacity(const Type& type,
+                                    const std::size_t& capacity);
+
+        /** Get the descriptor of the given component type. */
+        static Component::Descriptor getDescriptor(
+            const Type& type,
+            const boost::optional<Version>& version
+            );
+
+        /** Find the shortest chain of converters between two types. */
+        static std::vector<Type> findConverters(const Type& from,
+                                                const Type& to);
+
         /** Instantiate a new component of the given type. */
         static Component::Instance instantiate(
             const Type& type,
@@ -72,7 +113,8 @@ namespace KrellInstitute { namespace CBTF { namespace Impl {
         static void connect(Component::Instance output_instance,
                             const std::string& output_name,
                             Component::Instance input_instance,
-                            const std::string& input_name);
+                            const std::string& input_name,
+                            const bool& asynchronous);
         
         /** Disconnect a component's output from a component's input. */
         static void disconnect(Component::Instance output_instance,
@@ -80,6 +122,31 @@ namespace KrellInstitute { namespace CBTF { namespace Impl {
                                Component::Instance input_instance,
                                const std::string& input_name);
         
+        /** Set whether a component receives its inputs asynchronously. */
+        static void setAsynchronous(Component::Instance instance,
+                                    const bool& asynchronous);
+
+        /** Set the number of threads used to run asynchronous components. */
+        static void setThreadPoolSize(const std::size_t& size);
+
+        /** Set whether statistics are collected. */
+        static void setStatisticsEnabled(const bool& enabled);
+
+        /** Recycle a released instance of a pooled component type. */
+        static void recycle(const Component::Instance& instance);
+        
+        /** Allocate a component's implementation from the current arena. */
+        static void* operator new(std::size_t size)
+        {
+            return Arena::allocateObject(size);
+        }
+
+        /** Deallocate a component's implementation. */
+        static void operator delete(void* ptr)
+        {
+            Arena::deallocateObject(ptr);
+        }
+        
         /** Construct a new component of the given type and version. */
         ComponentImpl(const Type& type, const Version& version);
         
@@ -96,42 +163,294 @@ namespace KrellInstitute { namespace CBTF { namespace Impl {
         Version getVersion() const;
 
         /** Get this component's inputs. */
-        std::map<std::string, Type> getInputs() const;
+        const std::map<std::string, Type>& getInputs() const;
 
         /** Get this component's outputs. */
-        std::map<std::string, Type> getOutputs() const;
+        const std::map<std::string, Type>& getOutputs() const;
+
+        /** Get the statistics of this component's inputs and outputs. */
+        Statistics getStatistics() const;
 
         /** Declare an input of this component. */
         void declareInputImpl(const std::string& name, const Type& type,
                               const boost::shared_ptr<Impl::Invoker>& handler);
 
         /** Declare an output of this component. */
-        void declareOutputImpl(const std::string& name, const Type& type);
+        std::size_t declareOutputImpl(const std::string& name,
+                                      const Type& type,
+                                      boost::atomic<bool>* connected = NULL);
         
         /** Emit an output of this component. */
         void emitOutputImpl(const std::string& name, const Type& type,
-                            const boost::any& value);
+                            const Impl::Value& value);
+
+        /** Emit an output of this component. */
+        void emitOutputImpl(const std::size_t& index, const Type& type,
+                            const Impl::Value& value);
+
+        /** Emit a batch of values on an output of this component. */
+        void emitOutputImpl(const std::string& name, const Type& type,
+                            const Impl::Batch& batch);
+
+        /** Emit a batch of values on an output of this component. */
+        void emitOutputImpl(const std::size_t& index, const Type& type,
+                            const Impl::Batch& batch);
         
     private:
 
         /**
-         * Type of associative container used to map a component's outputs to
-         * their connected component inputs.
+         * Type of associative container used to map the names of a component's
+         * inputs, or outputs, to their types. Schemas are interned, immutable,
+         * and never destroyed, so that every component declaring the same ports
+         * shares a single schema, and the per-component tables below can refer
+         * to the names and types in it rather than copying them.
+         */
+        typedef std::map<std::string, Type> Schema;
+
+        /** Ordering of port names referred to by their address. */
+        struct NameLess
+        {
+            bool operator()(const std::string* lhs,
+                            const std::string* rhs) const
+            {
+                return *lhs < *rhs;
+            }
+        };
+
+        /** Get the interned schema without any ports. */
+        static const Schema* emptySchema();
+        
+        /** Get the interned schema extending another one by one port. */
+        static const Schema* extendSchema(const Schema* schema,
+                                          const std::string& name,
+                                          const Type& type);
+        
+        /** Counters and trace labels of one of this component's inputs. */
+        struct InputCounters :
+            private boost::noncopyable
+        {
+            /** Construct the counters of the named input of a component. */
+            InputCounters(const Type& type, const std::string& name);
+            
+            /** Record the given invocation of the input's handler. */
+            void record(const std::size_t& values, const boost::uint64_t& time);
+            
+            /** Number of values received. */
+            boost::atomic<boost::uint64_t> dm_values;
+
+            /** Number of times the handler was invoked. */
+            boost::atomic<boost::uint64_t> dm_invocations;
+
+            /** Total time (in nanoseconds) spent inside the handler. */
+            boost::atomic<boost::uint64_t> dm_time;
+
+            /** Histogram of the time spent inside each handler invocation. */
+            boost::atomic<boost::uint64_t>
+                dm_histogram[Statistics::kHistogramBuckets];
+
+            /** Trace label of the type of the input's component. */
+            Trace::Label dm_trace_category;
+
+            /** Trace label of the input's name. */
+            Trace::Label dm_trace_name;
+        };
+
+        /** Statistics counters of one of this component's outputs. */
+        struct OutputCounters :
+            private boost::noncopyable
+        {
+            /** Default constructor. */
+            OutputCounters();
+            
+            /** Number of values emitted. */
+            boost::atomic<boost::uint64_t> dm_values;
+
+            /** Number of emissions. */
+            boost::atomic<boost::uint64_t> dm_emissions;
+        };
+        
+        /**
+         * Component input to which one of this component's outputs is
+         * connected, with the input's handler function already resolved.
+         */
+        struct Target
+        {
+            /** Component containing the input. */
+            boost::weak_ptr<Component> dm_instance;
+
+            /** Implementation details of that component. */
+            ComponentImpl* dm_impl;
+            
+            /** Name of the input (interned in that component's schema). */
+            const std::string* dm_name;
+            
+            /** Handler function for the input. */
+            const Impl::Invoker* dm_invoker;
+
+            /** Statistics counters of the input. */
+            InputCounters* dm_counters;
+            
+            /** Was this connection requested to be asynchronous? */
+            bool dm_asynchronous_connection;
+            
+            /**
+             * Is the input invoked asynchronously? True if either the connection
+             * or the input's component are asynchronous.
+             */
+            bool dm_asynchronous;
+        };
+
+        /**
+         * Type of sequential container used to list the component inputs to
+         * which an output is connected. Lists are immutable once constructed,
+         * and are replaced wholesale when connections are made or broken, so
+         * that emitting an output can walk the list without holding any lock.
          */
-        typedef std::multimap<
-            std::string, std::pair<boost::weak_ptr<Component>, std::string>
-            > ConnectionMap;
+        typedef std::vector<Target> TargetList;
+        
+        /** Input of this component. */
+        struct Input
+        {
+            /** Name and type of this input (interned in a schema). */
+            const Schema::value_type* dm_port;
+
+            /** Handler function for this input. */
+            boost::shared_ptr<Impl::Invoker> dm_handler;
+
+            /** Statistics counters of this input. */
+            boost::shared_ptr<InputCounters> dm_counters;
+        };
 
         /**
-         * Type of associative container used to map a component's inputs to
-         * their corresponding handler function.
+         * Type of associative container used to map the names of a component's
+         * inputs to the inputs themselves.
          */
         typedef std::map<
-            std::string, boost::shared_ptr<Impl::Invoker>
-            > HandlerMap;
+            const std::string*, Input, NameLess,
+            Impl::ArenaAllocator<std::pair<const std::string* const, Input> >
+            > InputTable;
+        
+        /** Output of this component. */
+        struct Output
+        {
+            /** Name and type of this output (interned in a schema). */
+            const Schema::value_type* dm_port;
+
+            /** Component inputs to which this output is connected. */
+            boost::shared_ptr<const TargetList> dm_targets;
+
+            /** Statistics counters of this output. */
+            boost::shared_ptr<OutputCounters> dm_counters;
+
+            /** Optional flag set once this output is connected. */
+            boost::atomic<bool>* dm_connected;
+        };
+
+        /** Outputs of this component (and their connections). */
+        struct OutputTable
+        {
+            /**
+             * Type of associative container used to map the names of the
+             * outputs to their index.
+             */
+            typedef std::map<
+                const std::string*, std::size_t, NameLess,
+                Impl::ArenaAllocator<
+                    std::pair<const std::string* const, std::size_t>
+                    >
+                > NameMap;
+
+            /** Type of sequential container used to list the outputs. */
+            typedef std::vector<Output, Impl::ArenaAllocator<Output> >
+                OutputList;
+            
+            /** Map of the names of the outputs to their index. */
+            NameMap dm_names;
+
+            /** Outputs, in the order they were declared. */
+            OutputList dm_outputs;
+        };
+        
+        /** Find an output being emitted and check the emitted type. */
+        static const Output& findOutput(const OutputTable& outputs,
+                                        const std::string& name,
+                                        const Type& type);
+
+        /** Find an output being emitted and check the emitted type. */
+        static const Output& findOutput(const OutputTable& outputs,
+                                        const std::size_t& index,
+                                        const Type& type);
+        
+        /** Count an emitted value (or batch) and get the connected inputs. */
+        template <typename V>
+        static boost::shared_ptr<const TargetList> getTargets(
+            const Output& output, const V& value
+            );
+        
+        /** Pass an emitted value (or batch) to each of the connected inputs. */
+        template <typename V>
+        static void dispatch(const TargetList* targets, const V& value);
+
+        /** Invoke a handler, recording the invocation's statistics. */
+        template <typename V>
+        static void invoke(const Impl::Invoker& invoker,
+                           InputCounters& counters,
+                           const V& value);
+
+        /** Remove all connections involving this component. */
+        void removeConnections();
+
+        /** Discard this component's connections and mailbox for reuse. */
+        void discardConnections();
+        
+        /** Remove all connections from this component to the given one. */
+        void removeTargets(const ComponentImpl* impl);
+
+        /** Update all connections from this component to the given one. */
+        void updateTargets(const ComponentImpl* impl);
+
+        /**
+         * Value, or batch of values, waiting along with the handler function
+         * to which it is to be passed, in the mailbox of a component receiving
+         * asynchronously.
+         */
+        struct Message
+        {
+            /** Handler function to which the value is to be passed. */
+            const Impl::Invoker* dm_invoker;
+
+            /** Statistics counters of the input receiving the value. */
+            InputCounters* dm_counters;
+
+            /** Value to be passed, unless this message holds a batch. */
+            Impl::Value dm_value;
+
+            /** Batch of values to be passed, if this message holds a batch. */
+            Impl::Batch dm_batch;
+        };
+        
+        /** Add a value to this component's mailbox. */
+        void post(const Component::Instance& instance,
+                  const Target& target,
+                  const Impl::Value& value);
 
-        /** Mutual exclusion lock for this component. */
-        mutable boost::shared_mutex dm_mutex;
+        /** Add a batch of values to this component's mailbox. */
+        void post(const Component::Instance& instance,
+                  const Target& target,
+                  const Impl::Batch& batch);
+
+        /** Add a message to this component's mailbox. */
+        void post(const Component::Instance& instance, const Message& message);
+
+        /** Pass the values in a component's mailbox to their handlers. */
+        static void drain(const boost::weak_ptr<Component>& instance);
+
+        /**
+         * Mutual exclusion lock serializing changes to this component's inputs
+         * and outputs. Never acquired when emitting an output, which instead
+         * reads the currently published snapshot of the outputs.
+         */
+        mutable boost::mutex dm_mutex;
         
         /** Type of this component. */
         const Type dm_type;
@@ -139,17 +458,40 @@ namespace KrellInstitute { namespace CBTF { namespace Impl {
         /** Version of this component. */
         const Version dm_version;
         
-        /** Inputs of this component. */
-        std::map<std::string, Type> dm_inputs;
+        /** Schema of this component's inputs. */
+        boost::atomic<const Schema*> dm_input_schema;
+
+        /** Schema of this component's outputs. */
+        boost::atomic<const Schema*> dm_output_schema;
         
-        /** Outputs of this component. */
-        std::map<std::string, Type> dm_outputs;
+        /** Inputs of this component. */
+        Impl::Snapshot<InputTable> dm_inputs;
         
-        /** Input handler functions of this component. */
-        HandlerMap dm_handlers;
+        /** Outputs of this component (and their connections). */
+        Impl::Snapshot<OutputTable> dm_outputs;
+
+        /**
+         * Components with an output connected to one of this component's
+         * inputs, listed once per such connection. Used to remove those
+         * connections when this component is destroyed. Guarded by the
+         * global topology lock rather than this component's lock.
+         */
+        std::multiset<ComponentImpl*> dm_upstream;
+
+        /**
+         * Flag indicating if this component receives its inputs asynchronously.
+         * Guarded by the global topology lock rather than this component's lock.
+         */
+        bool dm_asynchronous;
         
-        /** Connections emanating from this component. */
-        ConnectionMap dm_connections;
+        /** Mutual exclusion lock for this component's mailbox. */
+        boost::mutex dm_mailbox_mutex;
+
+        /** Values received asynchronously but not yet handled. */
+        std::deque<Message> dm_mailbox;
+
+        /** Flag indicating if draining of this component's mailbox is queued. */
+        bool dm_mailbox_scheduled;
         
     }; // class ComponentImpl
         
@@ -0,0 +1,272 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2026 Krell Institute. All Rights Reserved.
+//
+// This program is free software; you can redistribute it and/or modify it under
+// the terms of the GNU General Public License as published by the Free Software
+// Foundation; either version 2 of the License, or (at your option) any later
+// version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+// details.
+//
+// You should have received a copy of the GNU General Public License along with
+// this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+// Place, Suite 330, Boston, MA  02111-1307  USA
+////////////////////////////////////////////////////////////////////////////////
+
+/** @file Definition of the Epoch class. */
+
+#include <boost/cstdint.hpp>
+#include <boost/thread/locks.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/tss.hpp>
+#include <cstddef>
+#include <KrellInstitute/CBTF/Impl/Epoch.hpp>
+#include <limits>
+#include <vector>
+
+using namespace KrellInstitute::CBTF::Impl;
+
+
+
+/**
+ * Per-thread state of the readers. Records are allocated on a thread's first
+ * critical section, released when the thread exits, and then reused by later
+ * threads. They are never deleted, so that writers can always walk the list
+ * of records without any lock.
+ */
+struct Epoch::Record
+{
+    /**
+     * Global epoch observed when the thread entered its outermost critical
+     * section, or zero if the thread isn't currently in a critical section.
+     */
+    boost::atomic<boost::uint64_t> dm_epoch;
+
+    /** Nesting depth of the thread's critical sections. */
+    std::size_t dm_depth;
+
+    /** Flag indicating if this record is owned by a thread. */
+    boost::atomic<bool> dm_in_use;
+
+    /** Next record in the list of all records. */
+    Record* dm_next;
+
+    /**
+     * Padding ensuring that records of different threads never share a cache
+     * line, since each thread writes its own record on every critical section.
+     */
+    char dm_padding[64];
+};
+
+
+
+/** Anonymous namespace hiding implementation details. */
+namespace {
+
+    /** Object retired but not yet reclaimed. */
+    struct Retired
+    {
+        /** Global epoch at the time the object was retired. */
+        boost::uint64_t dm_epoch;
+
+        /** Function used to delete the object. */
+        void (*dm_reclaimer)(const void*);
+
+        /** Retired object. */
+        const void* dm_object;
+    };
+
+    /**
+     * Global state of the epoch-based reclamation. Deliberately never destroyed
+     * so that objects can still be retired during static C++ destruction.
+     */
+    struct State
+    {
+        /** Global epoch, incremented each time an object is retired. */
+        boost::atomic<boost::uint64_t> dm_epoch;
+
+        /** List of all the per-thread records. */
+        boost::atomic<Epoch::Record*> dm_records;
+
+        /** Mutual exclusion lock for the retired objects. */
+        boost::mutex dm_mutex;
+
+        /** Objects retired but not yet reclaimed. */
+        std::vector<Retired> dm_retired;
+
+        /** Default constructor. */
+        State() :
+            dm_epoch(1),
+            dm_records(NULL),
+            dm_mutex(),
+            dm_retired()
+        {
+        }
+    };
+
+    /** Access the global state of the epoch-based reclamation. */
+    State& state()
+    {
+        static State* the_state = new State();
+        return *the_state;
+    }
+
+    /**
+     * Cached copy of the calling thread's per-thread record. Looking up the
+     * thread-specific pointer is comparatively slow, and is needed only to
+     * release the record when the thread exits.
+     */
+    __thread Epoch::Record* cached_record = NULL;
+    
+    /** Release the per-thread record of an exiting thread for reuse. */
+    void releaseRecord(Epoch::Record* record)
+    {
+        cached_record = NULL;
+        record->dm_epoch.store(0);
+        record->dm_depth = 0;
+        record->dm_in_use.store(false);
+    }
+
+    /** Per-thread record of the calling thread. */
+    boost::thread_specific_ptr<Epoch::Record> current_record(releaseRecord);
+
+    /** Get the per-thread record of the calling thread, allocating one. */
+    Epoch::Record* getCurrentRecord()
+    {
+        Epoch::Record* record = cached_record;
+        if (record != NULL)
+        {
+            return record;
+        }
+        
+        record = current_record.get();
+        if (record != NULL)
+        {
+            cached_record = record;
+            return record;
+        }
+
+        State& the_state = state();
+
+        for (record = the_state.dm_records.load();
+             record != NULL;
+             record = record->dm_next)
+        {
+            bool in_use = false;
+            if (record->dm_in_use.compare_exchange_strong(in_use, true))
+            {
+                current_record.reset(record);
+                cached_record = record;
+                return record;
+            }
+        }
+
+        record = new Epoch::Record();
+        record->dm_epoch.store(0);
+        record->dm_depth = 0;
+        record->dm_in_use.store(true);
+        Epoch::Record* next = the_state.dm_records.load();
+        do
+        {
+            record->dm_next = next;
+        }
+        while (!the_state.dm_records.compare_exchange_weak(next, record));
+
+        current_record.reset(record);
+        cached_record = record;
+        return record;
+    }
+
+} // namespace <anonymous>
+
+
+
+//------------------------------------------------------------------------------
+// Only the outermost critical section records the global epoch. All of the
+// accesses involved are sequentially consistent, so a reader which observed
+// an epoch later than the one at which an object was retired is guaranteed
+// to have observed the object's replacement as well.
+//------------------------------------------------------------------------------
+Epoch::Guard::Guard() :
+    dm_record(getCurrentRecord())
+{
+    if (dm_record->dm_depth++ == 0)
+    {
+        dm_record->dm_epoch.store(state().dm_epoch.load());
+    }
+}
+
+
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+Epoch::Guard::~Guard()
+{
+    if (--dm_record->dm_depth == 0)
+    {
+        dm_record->dm_epoch.store(0, boost::memory_order_release);
+    }
+}
+
+
+
+//------------------------------------------------------------------------------
+// Stamp the object with the current global epoch while advancing that epoch.
+// Any reader still in a critical section entered at or before the stamped
+// epoch might be using the object, so it can't yet be deleted. Find the oldest
+// epoch among such readers and then delete every retired object (including,
+// possibly, this one) stamped before it. The deletion is done after releasing
+// the lock in case deleting an object retires others in turn.
+//------------------------------------------------------------------------------
+void Epoch::retireImpl(Reclaimer reclaimer, const void* object)
+{
+    State& the_state = state();
+
+    Retired retired = { the_state.dm_epoch.fetch_add(1), reclaimer, object };
+
+    std::vector<Retired> reclaimable;
+
+    {
+        boost::mutex::scoped_lock guard_state(the_state.dm_mutex);
+
+        the_state.dm_retired.push_back(retired);
+
+        boost::uint64_t oldest = std::numeric_limits<boost::uint64_t>::max();
+        for (Record* record = the_state.dm_records.load();
+             record != NULL;
+             record = record->dm_next)
+        {
+            const boost::uint64_t epoch = record->dm_epoch.load();
+            if ((epoch != 0) && (epoch < oldest))
+            {
+                oldest = epoch;
+            }
+        }
+
+        std::vector<Retired>::iterator i = the_state.dm_retired.begin();
+        for (std::vector<Retired>::iterator
+                 j = the_state.dm_retired.begin();
+             j != the_state.dm_retired.end();
+             ++j)
+        {
+            if (j->dm_epoch < oldest)
+            {
+                reclaimable.push_back(*j);
+            }
+            else
+            {
+                *i++ = *j;
+            }
+        }
+        the_state.dm_retired.erase(i, the_state.dm_retired.end());
+    }
+
+    for (std::vector<Retired>::const_iterator
+             i = reclaimable.begin(); i != reclaimable.end(); ++i)
+    {
+        (*(i->dm_reclaimer))(i->dm_object);
+    }
+}
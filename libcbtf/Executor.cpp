@@ -0,0 +1,329 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2010-2012 Krell Institute. All Rights Reserved.
+//
+// This program is free software; you can redistribute it and/or modify it under
+// the terms of the GNU General Public License as published by the Free Software
+// Foundation; either version 2 of the License, or (at your option) any later
+// version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+// details.
+//
+// You should have received a copy of the GNU General Public License along with
+// this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+// Place, Suite 330, Boston, MA  02111-1307  USA
+////////////////////////////////////////////////////////////////////////////////
+
+
+/** @file Definition of the Executor class. */
+
+#include <boost/bind.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/thread/locks.hpp>
+#include <boost/thread/tss.hpp>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+
+#include "Executor.hpp"
+#include "Raise.hpp"
+
+using namespace KrellInstitute::CBTF;
+using namespace KrellInstitute::CBTF::Impl;
+
+
+
+/** Anonymous namespace hiding implementation details. */
+namespace {
+
+    /** Index used to indicate that the calling thread isn't a worker. */
+    const std::size_t kNotAWorker = std::numeric_limits<std::size_t>::max();
+    
+    /** Index of the worker thread queue owned by the calling thread. */
+    boost::thread_specific_ptr<std::size_t> current_worker;
+
+    /** Get the index of the worker thread queue owned by the calling thread. */
+    std::size_t getCurrentWorker()
+    {
+        return (current_worker.get() == NULL) ? kNotAWorker : *current_worker;
+    }
+    
+    /** Get the default number of worker threads. */
+    std::size_t getDefaultSize()
+    {
+        const char* size = getenv("CBTF_THREAD_POOL_SIZE");
+        if (size != NULL)
+        {
+            try
+            {
+                std::size_t value = boost::lexical_cast<std::size_t>(size);
+                if (value > 0)
+                {
+                    return value;
+                }
+            }
+            catch (const boost::bad_lexical_cast&)
+            {
+            }
+        }
+        
+        const std::size_t value = boost::thread::hardware_concurrency();
+        return (value > 0) ? value : 1;
+    }
+    
+} // namespace <anonymous>
+
+
+
+//------------------------------------------------------------------------------
+// The thread pool is deliberately never destroyed so that worker threads are
+// not joined (or the pool destroyed out from under them) during static C++
+// destruction.
+//------------------------------------------------------------------------------
+Executor& Executor::instance()
+{
+    static Executor* the_instance = new Executor();
+    return *the_instance;
+}
+
+
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+std::size_t Executor::getSize() const
+{
+    boost::mutex::scoped_lock guard_this(dm_mutex);
+    return dm_size;
+}
+
+
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+void Executor::setSize(const std::size_t& size)
+{
+    boost::mutex::scoped_lock guard_this(dm_mutex);
+
+    if (size == 0)
+    {
+        raise<std::invalid_argument>(
+            "The thread pool size (%1%) must be at least one.", size
+            );
+    }
+    
+    if (dm_started && (size != dm_size))
+    {
+        raise<std::logic_error>(
+            "The thread pool size can't be changed once it is running."
+            );
+    }
+
+    dm_size = size;
+}
+
+
+
+//------------------------------------------------------------------------------
+// Add the task to the back of the calling worker thread's own queue or, when
+// called from any other thread, to one of the worker threads' queues in turn.
+// Then wake an idle worker thread, if there are any, to take the task.
+//------------------------------------------------------------------------------
+void Executor::submit(const Task& task)
+{
+    start();
+
+    std::size_t index = getCurrentWorker();
+    if (index == kNotAWorker)
+    {
+        index = dm_next.fetch_add(1) % dm_queues.size();
+    }
+
+    dm_pending.fetch_add(1);
+
+    {
+        Queue& queue = *dm_queues[index];
+        boost::mutex::scoped_lock guard_queue(queue.dm_mutex);
+        queue.dm_tasks.push_back(task);
+    }
+    
+    if (dm_idle.load() > 0)
+    {
+        boost::mutex::scoped_lock guard_this(dm_mutex);
+        dm_condition.notify_one();
+    }
+}
+
+
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+bool Executor::runPendingTask()
+{
+    if (!dm_started || (dm_pending.load() == 0))
+    {
+        return false;
+    }
+    
+    Task task;
+    if (!take(getCurrentWorker(), task))
+    {
+        return false;
+    }
+    
+    execute(task);
+    return true;
+}
+
+
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+Executor::Executor() :
+    dm_mutex(),
+    dm_condition(),
+    dm_size(getDefaultSize()),
+    dm_started(false),
+    dm_queues(),
+    dm_threads(),
+    dm_pending(0),
+    dm_idle(0),
+    dm_next(0)
+{
+}
+
+
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+void Executor::start()
+{
+    if (dm_started.load(boost::memory_order_acquire))
+    {
+        return;
+    }
+
+    boost::mutex::scoped_lock guard_this(dm_mutex);
+
+    if (dm_started.load(boost::memory_order_relaxed))
+    {
+        return;
+    }
+    
+    for (std::size_t i = 0; i < dm_size; ++i)
+    {
+        dm_queues.push_back(boost::shared_ptr<Queue>(new Queue()));
+    }
+    
+    for (std::size_t i = 0; i < dm_size; ++i)
+    {
+        dm_threads.create_thread(boost::bind(&Executor::work, this, i));
+    }
+
+    dm_started.store(true, boost::memory_order_release);
+}
+
+
+
+//------------------------------------------------------------------------------
+// Take a task from the back of the preferred queue if possible. Otherwise try
+// to steal one from the front of each of the other queues in turn.
+//------------------------------------------------------------------------------
+bool Executor::take(const std::size_t& preferred, Task& task)
+{
+    if (preferred != kNotAWorker)
+    {
+        Queue& queue = *dm_queues[preferred];
+        boost::mutex::scoped_lock guard_queue(queue.dm_mutex);
+        if (!queue.dm_tasks.empty())
+        {
+            task.swap(queue.dm_tasks.back());
+            queue.dm_tasks.pop_back();
+            dm_pending.fetch_sub(1);
+            return true;
+        }
+    }
+
+    const std::size_t start =
+        (preferred != kNotAWorker) ? preferred + 1 : dm_next.load();
+    
+    for (std::size_t i = 0; i < dm_queues.size(); ++i)
+    {
+        const std::size_t index = (start + i) % dm_queues.size();
+        if (index == preferred)
+        {
+            continue;
+        }
+
+        Queue& queue = *dm_queues[index];
+        boost::mutex::scoped_lock guard_queue(queue.dm_mutex);
+        if (!queue.dm_tasks.empty())
+        {
+            task.swap(queue.dm_tasks.front());
+            queue.dm_tasks.pop_front();
+            dm_pending.fetch_sub(1);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+
+//------------------------------------------------------------------------------
+// Tasks have nowhere to report exceptions, and letting one escape would
+// terminate the process, so report them on the standard error stream.
+//------------------------------------------------------------------------------
+void Executor::execute(const Task& task)
+{
+    try
+    {
+        task();
+    }
+    catch (const std::exception& error)
+    {
+        std::cerr << "[CBTF " << boost::this_thread::get_id() << "] "
+                  << "EXCEPTION: " << error.what() << std::endl;
+    }
+    catch (...)
+    {
+        std::cerr << "[CBTF " << boost::this_thread::get_id() << "] "
+                  << "EXCEPTION: unknown exception" << std::endl;
+    }
+}
+
+
+
+//------------------------------------------------------------------------------
+// Repeatedly take and execute tasks. Wait for more tasks to be submitted when
+// none are available. Announcing this thread as idle before checking for any
+// pending tasks, and doing both while holding the lock, ensures a submitting
+// thread either sees the idle thread (and wakes it) or the idle thread sees
+// the submitted task.
+//------------------------------------------------------------------------------
+void Executor::work(const std::size_t& index)
+{
+    current_worker.reset(new std::size_t(index));
+    
+    while (true)
+    {
+        Task task;
+        if (take(index, task))
+        {
+            execute(task);
+            continue;
+        }
+        
+        boost::mutex::scoped_lock guard_this(dm_mutex);
+        dm_idle.fetch_add(1);
+        while (dm_pending.load() == 0)
+        {
+            dm_condition.wait(guard_this);
+        }
+        dm_idle.fetch_sub(1);
+    }
+}
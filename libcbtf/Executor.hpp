@@ -0,0 +1,134 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2010-2012 Krell Institute. All Rights Reserved.
+//
+// This program is free software; you can redistribute it and/or modify it under
+// the terms of the GNU General Public License as published by the Free Software
+// Foundation; either version 2 of the License, or (at your option) any later
+// version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+// details.
+//
+// You should have received a copy of the GNU General Public License along with
+// this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+// Place, Suite 330, Boston, MA  02111-1307  USA
+////////////////////////////////////////////////////////////////////////////////
+
+
+/** @file Declaration of the Executor class. */
+
+#pragma once
+
+#include <boost/atomic.hpp>
+#include <boost/function.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+#include <cstddef>
+#include <deque>
+#include <vector>
+
+namespace KrellInstitute { namespace CBTF { namespace Impl {
+
+    /**
+     * Process-wide, work-stealing, thread pool used to run asynchronous work
+     * such as draining the mailboxes of asynchronous components. Each worker
+     * thread has its own queue of tasks. Tasks submitted by a worker are added
+     * to the back of its own queue, from which it also takes tasks, keeping
+     * related work on the same thread. Idle workers steal tasks from the front
+     * of the other workers' queues. Tasks submitted by any other thread are
+     * distributed among the workers' queues.
+     *
+     * The number of worker threads is taken from the CBTF_THREAD_POOL_SIZE
+     * environment variable, defaults to the number of hardware threads, and
+     * can be changed with setSize() until the pool is first used.
+     */
+    class Executor :
+        private boost::noncopyable
+    {
+
+    public:
+
+        /** Type of function executed by the thread pool. */
+        typedef boost::function<void ()> Task;
+        
+        /** Access the process-wide thread pool. */
+        static Executor& instance();
+
+        /** Get the number of worker threads. */
+        std::size_t getSize() const;
+        
+        /** Set the number of worker threads. */
+        void setSize(const std::size_t& size);
+
+        /** Submit a task to be executed by the thread pool. */
+        void submit(const Task& task);
+
+        /**
+         * Execute one of the pending tasks, if any, on the calling thread.
+         * Allows a thread waiting for submitted tasks to complete to help
+         * execute them rather than simply blocking.
+         */
+        bool runPendingTask();
+        
+    private:
+
+        /** Queue of tasks owned by one worker thread. */
+        struct Queue
+        {
+            /** Mutual exclusion lock for this queue. */
+            boost::mutex dm_mutex;
+            
+            /** Tasks in this queue. */
+            std::deque<Task> dm_tasks;
+        };
+        
+        /** Default constructor. */
+        Executor();
+
+        /** Start the worker threads if they haven't been started yet. */
+        void start();
+        
+        /** Take a task, preferring those in the specified queue. */
+        bool take(const std::size_t& preferred, Task& task);
+
+        /** Execute the specified task. */
+        void execute(const Task& task);
+        
+        /** Main loop of the worker thread with the specified index. */
+        void work(const std::size_t& index);
+        
+        /** Mutual exclusion lock for this thread pool. */
+        mutable boost::mutex dm_mutex;
+
+        /** Condition variable used to wake idle worker threads. */
+        boost::condition_variable dm_condition;
+        
+        /** Number of worker threads. */
+        std::size_t dm_size;
+
+        /** Flag indicating if the worker threads have been started. */
+        boost::atomic<bool> dm_started;
+        
+        /** Task queues of the worker threads. */
+        std::vector<boost::shared_ptr<Queue> > dm_queues;
+        
+        /** Worker threads. */
+        boost::thread_group dm_threads;
+
+        /** Number of tasks that are queued but not yet taken. */
+        boost::atomic<std::size_t> dm_pending;
+
+        /** Number of worker threads waiting for a task. */
+        boost::atomic<std::size_t> dm_idle;
+
+        /** Index of the queue receiving the next externally submitted task. */
+        boost::atomic<std::size_t> dm_next;
+        
+    }; // class Executor
+
+} } } // namespace KrellInstitute::CBTF::Impl
@@ -21,23 +21,43 @@
 #pragma once
 
 #include <boost/any.hpp>
+#include <boost/atomic.hpp>
+#include <boost/config.hpp>
 #include <boost/filesystem.hpp>
 #include <boost/function.hpp>
 #include <boost/noncopyable.hpp>
 #include <boost/optional.hpp>
+#include <boost/range/begin.hpp>
+#include <boost/range/empty.hpp>
+#include <boost/range/iterator_range.hpp>
+#include <boost/range/size.hpp>
+#include <boost/range/value_type.hpp>
 #include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/type_traits/is_lvalue_reference.hpp>
+#include <boost/utility/enable_if.hpp>
+#include <cstddef>
+#include <KrellInstitute/CBTF/Impl/Batch.hpp>
 #include <KrellInstitute/CBTF/Impl/Invoker.hpp>
 #include <KrellInstitute/CBTF/Impl/InvokerFor.hpp>
-#include <KrellInstitute/CBTF/Impl/InvokerForAny.hpp>
+#include <KrellInstitute/CBTF/Impl/InvokerForBatch.hpp>
+#include <KrellInstitute/CBTF/Impl/InvokerForValue.hpp>
+#include <KrellInstitute/CBTF/Impl/Value.hpp>
+#include <KrellInstitute/CBTF/Statistics.hpp>
 #include <KrellInstitute/CBTF/Type.hpp>
 #include <KrellInstitute/CBTF/Version.hpp>
+#include <limits>
 #include <map>
 #include <set>
 #include <string>
 #include <typeinfo>
+#include <vector>
 
 namespace KrellInstitute { namespace CBTF {
 
+    template <typename T> class Input;
+    template <typename T> class Output;
+    
     namespace Impl {
         class ComponentImpl;
         template <typename T> struct RegisterFactoryFunction;
@@ -52,6 +72,8 @@ namespace KrellInstitute { namespace CBTF {
         private boost::noncopyable
     {
         friend class Impl::ComponentImpl;
+        template <typename T> friend class Input;
+        template <typename T> friend class Output;
         template <typename T> friend struct Impl::RegisterFactoryFunction;
         
     public:
@@ -65,6 +87,71 @@ namespace KrellInstitute { namespace CBTF {
          * @sa http://en.wikipedia.org/wiki/Factory_function
          */
         typedef boost::function<Instance ()> FactoryFunction;
+
+        /**
+         * Pre-resolved handle to one of a component's outputs. Returned when a
+         * derived class declares an output and subsequently used to emit that
+         * output without looking it up by name. A handle is only meaningful to
+         * the component instance that declared the output.
+         *
+         * @tparam T    Type of the output.
+         */
+        template <typename T>
+        class OutputPort
+        {
+            friend class Component;
+            
+        public:
+
+            /** Construct a handle that doesn't refer to any output. */
+            OutputPort() :
+                dm_index(std::numeric_limits<std::size_t>::max())
+            {
+            }
+            
+        private:
+
+            /** Construct a handle referring to the output with this index. */
+            explicit OutputPort(const std::size_t& index) :
+                dm_index(index)
+            {
+            }
+            
+            /** Index of the output within its component. */
+            std::size_t dm_index;
+            
+        }; // class OutputPort<T>
+
+        /**
+         * Description of a component type and version that is known without
+         * instantiating the component. Registering a factory function along
+         * with its descriptor lets the factory function be registered without
+         * building a component just to learn its type and version.
+         */
+        struct Descriptor
+        {
+            /** Type of the component. */
+            Type dm_type;
+
+            /** Version of the component. */
+            Version dm_version;
+
+            /** Names of the component's inputs. */
+            std::set<std::string> dm_inputs;
+
+            /** Names of the component's outputs. */
+            std::set<std::string> dm_outputs;
+
+            /** Construct a descriptor of a component without any ports. */
+            Descriptor(const Type& type, const Version& version) :
+                dm_type(type),
+                dm_version(version),
+                dm_inputs(),
+                dm_outputs()
+            {
+            }
+
+        }; // struct Descriptor
         
         /**
          * Register a plugin providing one or more component types. By default
@@ -72,12 +159,58 @@ namespace KrellInstitute { namespace CBTF {
          * are available. The client is responsible for finding and registering
          * plugins containing any additional component types that are required.
          *
+         * If the plugin has an up-to-date manifest, as written by
+         * writePluginManifest(), the component types it lists are registered
+         * without loading the plugin. The plugin is then only loaded when one
+         * of them is first instantiated.
+         *
          * @param path    Path of the plugin to be registered.
          *
          * @throw std::runtime_error    The specified plugin doesn't exist
          *                              or is not of the correct format.
          */
         static void registerPlugin(const boost::filesystem::path& path);
+
+        /**
+         * Register several plugins providing one or more component types. The
+         * plugins are resolved, and then registered or loaded, in parallel by
+         * the thread pool. Each plugin is resolved against the given search
+         * paths before the usual plugin search paths.
+         *
+         * @param paths           Paths of the plugins to be registered.
+         * @param search_paths    Additional search paths used to resolve
+         *                        the plugins.
+         *
+         * @throw std::runtime_error    One of the specified plugins doesn't
+         *                              exist or is not of the correct format.
+         *                              The others are still registered.
+         *
+         * @note    Plugins are loaded with RTLD_NOW unless the environment
+         *          variable CBTF_PLUGIN_LAZY_BINDING is set, in which case
+         *          they are loaded with RTLD_LAZY. Setting CBTF_PLUGIN_TIMING
+         *          writes the time taken to resolve and to register or load
+         *          each plugin to the standard error stream.
+         */
+        static void registerPlugins(
+            const std::vector<boost::filesystem::path>& paths,
+            const std::vector<boost::filesystem::path>& search_paths =
+                std::vector<boost::filesystem::path>()
+            );
+
+        /**
+         * Write the manifest of a plugin providing one or more component types.
+         * The plugin is loaded, and the type, version, and port names of each
+         * component type it provides are written alongside the plugin, with
+         * ".manifest" appended to its name. Usually invoked at build or install
+         * time via the "cbtf-manifest" tool.
+         *
+         * @param path    Path of the plugin whose manifest is to be written.
+         *
+         * @throw std::runtime_error    The specified plugin doesn't exist
+         *                              or is not of the correct format,
+         *                              or its manifest couldn't be written.
+         */
+        static void writePluginManifest(const boost::filesystem::path& path);
         
         /**
          * Get the available component types. All available component types are
@@ -101,6 +234,43 @@ namespace KrellInstitute { namespace CBTF {
          */
         static std::set<Version> getAvailableVersions(const Type& type);
 
+        /**
+         * Get the descriptor of the given component type. The component
+         * version can optionally be specified, otherwise the descriptor of
+         * the most recent version of the component is returned. No component
+         * is instantiated unless its factory function was registered without
+         * a descriptor, and even then only once.
+         *
+         * @param type       Type of component to be described.
+         * @param version    Optional version of component to be described.
+         * @return           Descriptor of that component type and version.
+         *
+         * @throw std::runtime_error    There is no factory function
+         *                              registered for the specified
+         *                              component type or version.
+         */
+        static Descriptor getDescriptor(
+            const Type& type,
+            const boost::optional<Version>& version = boost::optional<Version>()
+            );
+
+        /**
+         * Find the shortest chain of converters between two types. Converters
+         * are component types whose name contains "Convert", and which have a
+         * single input and a single output. Each is assumed to convert values
+         * of its input's type into values of its output's type. Converters are
+         * indexed as they are registered, and each is instantiated only once,
+         * when converters are next searched for, to learn its port types.
+         *
+         * @param from    Type of the values to be converted.
+         * @param to      Type into which the values are to be converted.
+         * @return        Types of the converters, in the order in which they
+         *                are to be connected, or an empty list if there is no
+         *                chain of converters between the given types.
+         */
+        static std::vector<Type> findConverters(const Type& from,
+                                                const Type& to);
+
         /**
          * Instantiate a new component of the given type. The component version
          * to be instantiated can optionally be specified, otherwise an instance
@@ -121,12 +291,18 @@ namespace KrellInstitute { namespace CBTF {
         
         /**
          * Connect a component's output to a component's input. Values emitted
-         * on the output are directly conveyed to the input.
+         * on the output are directly conveyed to the input. By default they are
+         * conveyed synchronously, with the input's handler being invoked by the
+         * emitting thread. An asynchronous connection instead conveys them via
+         * the input component's mailbox, from which they are later passed, in
+         * the order they were emitted, to the handler by the thread pool.
          *
          * @param output_instance    Component with output being connected.
          * @param output_name        Name of output being connected.
          * @param input_instance     Component with input being connected.
          * @param input_name         Name of input being connected.
+         * @param asynchronous       Boolean "true" if the connection is to
+         *                           be asynchronous, or "false" otherwise.
          *
          * @throw std::runtime_error    The requested input or output
          *                              doesn't exist, they are not of
@@ -137,7 +313,8 @@ namespace KrellInstitute { namespace CBTF {
         static void connect(Component::Instance output_instance,
                             const std::string& output_name,
                             Component::Instance input_instance,
-                            const std::string& input_name);
+                            const std::string& input_name,
+                            const bool& asynchronous = false);
         
         /**
          * Disconnect a component's output from a component's input. Values
@@ -157,6 +334,64 @@ namespace KrellInstitute { namespace CBTF {
                                Component::Instance input_instance,
                                const std::string& input_name);
         
+        /**
+         * Set whether a component receives all of its inputs asynchronously.
+         * Values conveyed to an asynchronous component are placed in its
+         * mailbox. The thread pool then passes them to the component's input
+         * handlers, in the order they were received, one at a time. Thus the
+         * handlers of an asynchronous component are never invoked concurrently,
+         * but are invoked concurrently with the components that emitted them.
+         *
+         * @param instance        Component to be modified.
+         * @param asynchronous    Boolean "true" if the component is to be
+         *                        asynchronous, or "false" otherwise.
+         */
+        static void setAsynchronous(Component::Instance instance,
+                                    const bool& asynchronous);
+
+        /**
+         * Set the number of threads in the thread pool used to invoke the input
+         * handlers of asynchronous components and connections. Defaults to the
+         * value of the CBTF_THREAD_POOL_SIZE environment variable if it is set,
+         * or otherwise to the number of hardware threads.
+         *
+         * @param size    Number of threads in the thread pool.
+         *
+         * @throw std::invalid_argument    The specified number of threads
+         *                                 is zero.
+         * @throw std::logic_error         The thread pool is already running
+         *                                 with a different number of threads.
+         */
+        static void setThreadPoolSize(const std::size_t& size);
+
+        /**
+         * Enable or disable the collection of statistics for all components.
+         * Collection is disabled by default unless the CBTF_STATISTICS
+         * environment variable is set.
+         *
+         * @param enabled    Boolean "true" if statistics are to be collected,
+         *                   or "false" otherwise.
+         *
+         * @sa Statistics
+         */
+        static void setStatisticsEnabled(const bool& enabled);
+
+        /**
+         * Set the capacity of the pool of recycled instances of the given
+         * component type. By default instances aren't pooled. When pooling
+         * is enabled, a released instance whose reset() succeeds is kept in
+         * the pool, with its inputs and outputs still declared but all of
+         * its connections removed, and is handed out again by instantiate()
+         * rather than constructing a new instance.
+         *
+         * @param type        Type of component to be pooled.
+         * @param capacity    Maximum number of pooled instances of each
+         *                    version of that type, or zero to disable
+         *                    pooling and discard any pooled instances.
+         */
+        static void setPoolCapacity(const Type& type,
+                                    const std::size_t& capacity);
+        
         /** Destructor. */
         virtual ~Component();
         
@@ -193,8 +428,13 @@ namespace KrellInstitute { namespace CBTF {
          * @return    Map of names of this component's inputs to their types.
          *
          * @note    An empty map is returned if the component has no inputs.
+         *
+         * @note    The returned map is shared by every component declaring the
+         *          same inputs, and is never destroyed, so it can be held without
+         *          copying it. Declaring another port doesn't modify the map,
+         *          but does cause subsequent calls to return a different one.
          */
-        std::map<std::string, Type> getInputs() const;
+        const std::map<std::string, Type>& getInputs() const;
 
         /** 
          * Get this component's outputs.
@@ -202,13 +442,33 @@ namespace KrellInstitute { namespace CBTF {
          * @return    Map of names of this component's outputs to their types.
          *
          * @note    An empty map is returned if the component has no outputs.
+         *
+         * @note    The returned map is shared by every component declaring the
+         *          same outputs, and is never destroyed, so it can be held without
+         *          copying it. Declaring another port doesn't modify the map,
+         *          but does cause subsequent calls to return a different one.
+         */
+        const std::map<std::string, Type>& getOutputs() const;
+
+        /**
+         * Get this component's statistics.
+         *
+         * @return    Statistics of this component's inputs and outputs, as
+         *            collected so far.
+         *
+         * @note    Statistics are only gathered while their collection is
+         *          enabled. All of the counters are zero otherwise.
          */
-        std::map<std::string, Type> getOutputs() const;
+        Statistics getStatistics() const;
         
     protected:
 
         /**
-         * Register a factory function which instantiates components.
+         * Register a factory function which instantiates components. The type
+         * and version of the components it instantiates aren't known until it
+         * is first called. It is called once, to learn them, the first time
+         * the available components are queried or any component is
+         * instantiated.
          *
          * @param function    Factory function to be registered.
          *
@@ -222,6 +482,34 @@ namespace KrellInstitute { namespace CBTF {
         static void registerFactoryFunction(
             const Component::FactoryFunction& function
             );
+
+        /**
+         * Register a factory function which instantiates components of the
+         * described type and version. The factory function isn't called until
+         * such a component is actually instantiated.
+         *
+         * @param descriptor    Descriptor of the components instantiated by
+         *                      the factory function.
+         * @param function      Factory function to be registered.
+         *
+         * @note    Attempts to register two factory functions instantiating
+         *          components of the same type and version are silently
+         *          ignored, for the same reason as above.
+         */
+        static void registerFactoryFunction(
+            const Descriptor& descriptor,
+            const Component::FactoryFunction& function
+            );
+        
+        /**
+         * Reset a component instance so that it can be recycled. Allows a
+         * derived class to reset the instances of the components it contains.
+         *
+         * @param instance    Instance to be reset.
+         * @return            Boolean "true" if the instance was reset, or
+         *                    "false" if it cannot be recycled.
+         */
+        static bool resetComponent(const Instance& instance);
         
         /**
          * Construct a new component of the given type and version. Called from
@@ -232,6 +520,20 @@ namespace KrellInstitute { namespace CBTF {
          */
         Component(const Type& type, const Version& version);
 
+        /**
+         * Reset this component to the state it had when first constructed, so
+         * that it can be recycled. Called when an instance of a pooled type is
+         * released, after all of its connections have been removed. Derived
+         * classes supporting recycling override this to discard any state
+         * left over from the instance's previous use. Declared inputs and
+         * outputs are kept, and must not be declared again.
+         *
+         * @return    Boolean "true" if this component was reset, or "false"
+         *            if it cannot be recycled and is to be destroyed. The
+         *            default implementation always returns "false".
+         */
+        virtual bool reset();
+
         /**
          * Declare an input of this component. Called from the constructor of
          * a derived class to declare one of the component's inputs.
@@ -249,7 +551,7 @@ namespace KrellInstitute { namespace CBTF {
                           const boost::function<void (const T&)>& handler)
         {
             declareInputImpl(
-                name, Type(typeid(T)),
+                name, Type::of<T>(),
                 boost::shared_ptr<Impl::Invoker>(
                     new Impl::InvokerFor<T>(handler)
                     )
@@ -260,41 +562,107 @@ namespace KrellInstitute { namespace CBTF {
          * Declare an input of this component. Called from the constructor of
          * a derived class to declare one of the component's inputs.
          *
-         * @tparam T         Type of the input being declared.
          * @param name       Name of the input being declared.
+         * @param type       Type of the input being declared.
          * @param handler    Handler function to be called when receiving a
          *                   new value on this input.
          *
          * @throw std::invalid_argument    An input has already been
          *                                 declared with the given name.
+         *
+         * @note    Handler functions accepting a boost::any instead of an
+         *          Impl::Value may also be used, at the cost of the value
+         *          being copied into a boost::any on every invocation.
          */
         void declareInput(
             const std::string& name, const Type& type,
-            const boost::function<void (const boost::any&)>& handler
+            const boost::function<void (const Impl::Value&)>& handler
             )
         {
             declareInputImpl(
                 name, type,
                 boost::shared_ptr<Impl::Invoker>(
-                    new Impl::InvokerForAny(handler)
+                    new Impl::InvokerForValue(handler)
                     )
                 );
         }
 
+        /**
+         * Declare an input of this component whose handler accepts batches of
+         * values. Called from the constructor of a derived class to declare
+         * one of the component's inputs. Batches emitted by a connected output
+         * are passed to the handler intact, while single values are passed as
+         * a batch containing only that value.
+         *
+         * @tparam T         Type of the input being declared.
+         * @param name       Name of the input being declared.
+         * @param handler    Handler function to be called when receiving a
+         *                   new batch of values on this input. The values
+         *                   are only valid for the duration of the call.
+         *
+         * @throw std::invalid_argument    An input has already been
+         *                                 declared with the given name.
+         */
+        template <typename T>
+        void declareInputBatch(
+            const std::string& name,
+            const boost::function<
+                void (const boost::iterator_range<const T*>&)
+                >& handler
+            )
+        {
+            declareInputImpl(
+                name, Type::of<T>(),
+                boost::shared_ptr<Impl::Invoker>(
+                    new Impl::InvokerForBatch<T>(handler)
+                    )
+                );
+        }
+
+        /**
+         * Declare an input of this component. Called from the constructor of
+         * a derived class to declare one of the component's inputs.
+         *
+         * @param name             Name of the input being declared.
+         * @param type             Type of the input being declared.
+         * @param handler          Handler function to be called when
+         *                         receiving a new value on this input.
+         * @param batch_handler    Handler function to be called when
+         *                         receiving a new batch of values on
+         *                         this input.
+         *
+         * @throw std::invalid_argument    An input has already been
+         *                                 declared with the given name.
+         */
+        void declareInput(
+            const std::string& name, const Type& type,
+            const boost::function<void (const Impl::Value&)>& handler,
+            const boost::function<void (const Impl::Batch&)>& batch_handler
+            )
+        {
+            declareInputImpl(
+                name, type,
+                boost::shared_ptr<Impl::Invoker>(
+                    new Impl::InvokerForValue(handler, batch_handler)
+                    )
+                );
+        }
+        
         /**
          * Declare an output of this component. Called from the constructor of
          * a derived class to declare one of the component's outputs.
          *
          * @tparam T      Type of the output being declared.
          * @param name    Name of the output being declared.
+         * @return        Handle that can be used to emit this output.
          *
          * @throw std::invalid_argument    An output has already been
          *                                 declared with the given name.
          */
         template <typename T>
-        void declareOutput(const std::string& name)
+        OutputPort<T> declareOutput(const std::string& name)
         {
-            declareOutputImpl(name, Type(typeid(T)));
+            return OutputPort<T>(declareOutputImpl(name, Type::of<T>()));
         }
 
         /**
@@ -327,9 +695,53 @@ namespace KrellInstitute { namespace CBTF {
         template <typename T>
         void emitOutput(const std::string& name, const T& value)
         {
-            emitOutputImpl(name, Type(typeid(T)), boost::any(value));
+            emitOutputImpl(name, Type::of<T>(), Impl::Value::borrow(value));
         }
 
+#if !defined(BOOST_NO_CXX11_RVALUE_REFERENCES)
+        /**
+         * Emit an output of this component. Called by a derived class to emit
+         * one of the component's outputs. The value is moved, rather than
+         * copied, should any of the connected inputs need to retain it.
+         *
+         * @tparam T       Type of the value being emitted.
+         * @param name     Name of the output being emitted.
+         * @param value    Value being emitted.
+         *
+         * @throw std::invalid_argument    The requested output wasn't declared
+         *                                 or the given value type doesn't match
+         *                                 the output's declared type.
+         */
+        template <typename T>
+        typename boost::disable_if<boost::is_lvalue_reference<T> >::type
+        emitOutput(const std::string& name, T&& value)
+        {
+            emitOutputImpl(
+                name, Type::of<T>(), Impl::Value::borrowMovable(value)
+                );
+        }
+#endif
+
+        /**
+         * Emit an output of this component. Called by a derived class to emit
+         * one of the component's outputs. The value is shared, rather than
+         * copied, should any of the connected inputs need to retain it.
+         *
+         * @tparam T       Type of the value being emitted.
+         * @param name     Name of the output being emitted.
+         * @param value    Shared, immutable, value being emitted.
+         *
+         * @throw std::invalid_argument    The requested output wasn't declared
+         *                                 or the given value type doesn't match
+         *                                 the output's declared type.
+         */
+        template <typename T>
+        void emitOutputShared(const std::string& name,
+                              const boost::shared_ptr<const T>& value)
+        {
+            emitOutputImpl(name, Type::of<T>(), Impl::Value::share(value));
+        }
+        
         /**
          * Emit an output of this component. Called by a derived class to emit
          * one of the component's outputs.
@@ -344,22 +756,209 @@ namespace KrellInstitute { namespace CBTF {
          */
         void emitOutput(const std::string& name, const Type& type,
                         const boost::any& value)
+        {
+            emitOutputImpl(name, type, Impl::Value(value));
+        }
+
+        /**
+         * Emit an output of this component. Called by a derived class to emit
+         * one of the component's outputs.
+         *
+         * @param name     Name of the output being emitted.
+         * @param type     Type of the value being emitted.
+         * @param value    Value being emitted.
+         *
+         * @throw std::invalid_argument    The requested output wasn't declared
+         *                                 or the given value type doesn't match
+         *                                 the output's declared type.
+         */
+        void emitOutput(const std::string& name, const Type& type,
+                        const Impl::Value& value)
         {
             emitOutputImpl(name, type, value);
         }
         
+        /**
+         * Emit an output of this component. Called by a derived class to emit
+         * one of the component's outputs. Unlike emitting an output by name,
+         * no lookup of the output or of the connected inputs is necessary.
+         *
+         * @tparam T       Type of the value being emitted.
+         * @param port     Handle of the output being emitted.
+         * @param value    Value being emitted.
+         *
+         * @throw std::invalid_argument    The given handle doesn't refer to
+         *                                 an output of this component.
+         */
+        template <typename T>
+        void emitOutput(const OutputPort<T>& port, const T& value)
+        {
+            emitOutputImpl(
+                port.dm_index, Type::of<T>(), Impl::Value::borrow(value)
+                );
+        }
+
+#if !defined(BOOST_NO_CXX11_RVALUE_REFERENCES)
+        /**
+         * Emit an output of this component. Called by a derived class to emit
+         * one of the component's outputs. The value is moved, rather than
+         * copied, should any of the connected inputs need to retain it.
+         *
+         * @tparam T       Type of the value being emitted.
+         * @param port     Handle of the output being emitted.
+         * @param value    Value being emitted.
+         *
+         * @throw std::invalid_argument    The given handle doesn't refer to
+         *                                 an output of this component.
+         */
+        template <typename T>
+        void emitOutput(const OutputPort<T>& port, T&& value)
+        {
+            emitOutputImpl(
+                port.dm_index, Type::of<T>(), Impl::Value::borrowMovable(value)
+                );
+        }
+#endif
+
+        /**
+         * Emit an output of this component. Called by a derived class to emit
+         * one of the component's outputs. The value is shared, rather than
+         * copied, should any of the connected inputs need to retain it.
+         *
+         * @tparam T       Type of the value being emitted.
+         * @param port     Handle of the output being emitted.
+         * @param value    Shared, immutable, value being emitted.
+         *
+         * @throw std::invalid_argument    The given handle doesn't refer to
+         *                                 an output of this component.
+         */
+        template <typename T>
+        void emitOutputShared(const OutputPort<T>& port,
+                              const boost::shared_ptr<const T>& value)
+        {
+            emitOutputImpl(
+                port.dm_index, Type::of<T>(), Impl::Value::share(value)
+                );
+        }
+        
+        /**
+         * Emit a batch of values on an output of this component. Called by a
+         * derived class to emit many values of one of the component's outputs
+         * at once. The output is only looked up, and its connections walked,
+         * once per batch. Inputs with a batch handler receive the batch intact
+         * while the batch is unrolled for all other inputs.
+         *
+         * @tparam Range    Type of the contiguous range (such as std::vector
+         *                  or boost::iterator_range<const T*>) of values
+         *                  being emitted.
+         * @param name      Name of the output being emitted.
+         * @param values    Values being emitted.
+         *
+         * @throw std::invalid_argument    The requested output wasn't declared
+         *                                 or the given value type doesn't match
+         *                                 the output's declared type.
+         */
+        template <typename Range>
+        void emitOutputBatch(const std::string& name, const Range& values)
+        {
+            typedef typename boost::range_value<Range>::type T;
+            emitOutputImpl(name, Type::of<T>(), borrowBatch<T>(values));
+        }
+        
+        /**
+         * Emit a batch of values on an output of this component. Called by a
+         * derived class to emit many values of one of the component's outputs
+         * at once.
+         *
+         * @param name     Name of the output being emitted.
+         * @param type     Type of the values being emitted.
+         * @param batch    Batch of values being emitted.
+         *
+         * @throw std::invalid_argument    The requested output wasn't declared
+         *                                 or the given value type doesn't match
+         *                                 the output's declared type.
+         */
+        void emitOutputBatch(const std::string& name, const Type& type,
+                             const Impl::Batch& batch)
+        {
+            emitOutputImpl(name, type, batch);
+        }
+
+        /**
+         * Emit a batch of values on an output of this component. Called by a
+         * derived class to emit many values of one of the component's outputs
+         * at once.
+         *
+         * @tparam T        Type of the values being emitted.
+         * @tparam Range    Type of the contiguous range (such as std::vector
+         *                  or boost::iterator_range<const T*>) of values
+         *                  being emitted.
+         * @param port      Handle of the output being emitted.
+         * @param values    Values being emitted.
+         *
+         * @throw std::invalid_argument    The given handle doesn't refer to
+         *                                 an output of this component.
+         */
+        template <typename T, typename Range>
+        void emitOutputBatch(const OutputPort<T>& port, const Range& values)
+        {
+            emitOutputImpl(
+                port.dm_index, Type::of<T>(), borrowBatch<T>(values)
+                );
+        }
+        
     private:
 
+        /** Construct a batch borrowing the values of a contiguous range. */
+        template <typename T, typename Range>
+        static Impl::Batch borrowBatch(const Range& values)
+        {
+            if (boost::empty(values))
+            {
+                return Impl::Batch();
+            }
+            return Impl::Batch::borrow<T>(
+                &*boost::begin(values), boost::size(values)
+                );
+        }
+        
         /** Declare an input of this component. */
         void declareInputImpl(const std::string& name, const Type& type,
                               const boost::shared_ptr<Impl::Invoker>& handler);
 
         /** Declare an output of this component. */
-        void declareOutputImpl(const std::string& name, const Type& type);
+        std::size_t declareOutputImpl(const std::string& name,
+                                      const Type& type);
+
+        /**
+         * Declare an output of this component along with a flag that is set
+         * once the output is connected by name.
+         */
+        std::size_t declareOutputImpl(const std::string& name,
+                                      const Type& type,
+                                      boost::atomic<bool>& connected);
+
+        /**
+         * Access the mutual exclusion lock serializing changes to the direct
+         * connections between statically typed outputs and inputs.
+         */
+        static boost::mutex& directConnections();
+
+        /** Emit an output of this component. */
+        void emitOutputImpl(const std::string& name, const Type& type,
+                            const Impl::Value& value);
 
         /** Emit an output of this component. */
+        void emitOutputImpl(const std::size_t& index, const Type& type,
+                            const Impl::Value& value);
+
+        /** Emit a batch of values on an output of this component. */
         void emitOutputImpl(const std::string& name, const Type& type,
-                            const boost::any& value);
+                            const Impl::Batch& batch);
+
+        /** Emit a batch of values on an output of this component. */
+        void emitOutputImpl(const std::size_t& index, const Type& type,
+                            const Impl::Batch& batch);
         
         /**
          * Opaque pointer to this object's internal implementation details.
@@ -374,12 +973,60 @@ namespace KrellInstitute { namespace CBTF {
         
 } } // namespace KrellInstitute::CBTF
 
+namespace KrellInstitute { namespace CBTF { namespace Impl {
+
+    /**
+     * Type that only exists for a pointer to a component type's static
+     * describe() member function, allowing its presence to be detected.
+     */
+    template <Component::Descriptor (*)()>
+    struct __attribute__ ((visibility ("hidden"))) DescribeFunction
+    {
+    };
+    
+    /**
+     * Get the descriptor of a component type that provides a public, static,
+     * describe() member function returning its descriptor.
+     *
+     * @tparam T    Type (class) of the component.
+     * @return      Descriptor of that component type.
+     */
+    template <typename T>
+    boost::optional<Component::Descriptor> describe(
+        DescribeFunction<&T::describe>*
+        )
+    {
+        return T::describe();
+    }
+
+    /**
+     * Get the descriptor of a component type that doesn't provide a describe()
+     * member function.
+     *
+     * @tparam T    Type (class) of the component.
+     * @return      Nothing, since the descriptor isn't known.
+     */
+    template <typename T>
+    boost::optional<Component::Descriptor> describe(...)
+    {
+        return boost::none;
+    }
+
+} } } // namespace KrellInstitute::CBTF::Impl
+
 /**
  * Macro definition that generates a statically initialized C++ structure
  * registering the factory function for the specified component type. The
  * factory function is assumed to be named "factoryFunction" and to be a
  * static method of the component type (class).
  *
+ * When the component type also has a public, static, method named "describe"
+ * returning its Component::Descriptor, the factory function is registered
+ * along with that descriptor, and no component is ever instantiated merely to
+ * register it. Otherwise the factory function is called once, the first time
+ * the available components are queried or any component is instantiated, in
+ * order to learn the version and ports of the component type.
+ *
  * @param type    Type (class name) of the component to be registered.
  */
 #define KRELL_INSTITUTE_CBTF_REGISTER_FACTORY_FUNCTION(type)                   \
@@ -391,9 +1038,20 @@ namespace KrellInstitute { namespace CBTF {
         {                                                                      \
             RegisterFactoryFunction()                                          \
             {                                                                  \
-                KrellInstitute::CBTF::Component::registerFactoryFunction(      \
-                    type::factoryFunction                                      \
-                    );                                                         \
+                boost::optional<Component::Descriptor> descriptor =            \
+                    describe<type>(0);                                         \
+                if (descriptor)                                                \
+                {                                                              \
+                    Component::registerFactoryFunction(                        \
+                        *descriptor, type::factoryFunction                     \
+                        );                                                     \
+                }                                                              \
+                else                                                           \
+                {                                                              \
+                    Component::registerFactoryFunction(                        \
+                        type::factoryFunction                                  \
+                        );                                                     \
+                }                                                              \
             }                                                                  \
             static RegisterFactoryFunction instance;                           \
         };                                                                     \
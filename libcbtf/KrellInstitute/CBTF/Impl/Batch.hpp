@@ -0,0 +1,213 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2026 Krell Institute. All Rights Reserved.
+//
+// This program is free software; you can redistribute it and/or modify it under
+// the terms of the GNU General Public License as published by the Free Software
+// Foundation; either version 2 of the License, or (at your option) any later
+// version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+// details.
+//
+// You should have received a copy of the GNU General Public License along with
+// this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+// Place, Suite 330, Boston, MA  02111-1307  USA
+////////////////////////////////////////////////////////////////////////////////
+
+/** @file Declaration and definition of the Batch class. */
+
+#pragma once
+
+#include <boost/shared_ptr.hpp>
+#include <cstddef>
+#include <KrellInstitute/CBTF/Impl/Value.hpp>
+#include <vector>
+
+namespace KrellInstitute { namespace CBTF { namespace Impl {
+
+    /**
+     * Type-erased batch of values, stored contiguously, conveyed from a
+     * component's output to the inputs connected to it in a single emission.
+     * Inputs with a batch handler receive the whole batch at once. The batch
+     * is unrolled, one value at a time, for inputs with any other handler.
+     *
+     * Like a Value, a batch usually just borrows the emitted values, which
+     * only remain valid until the emission returns. Anything needing them
+     * beyond that point must call retain(), which copies them onto the heap
+     * the first time it is called, and shares that copy with all subsequent
+     * retainers.
+     *
+     * @note    As is the case for Value, the type of the values isn't checked
+     *          by get(). The framework checks types when components are
+     *          connected and when batches are emitted.
+     */
+    class Batch
+    {
+
+    public:
+
+        /**
+         * Construct a batch that borrows the specified values.
+         *
+         * @tparam T        Type of the values.
+         * @param values    Pointer to the first of the values to be borrowed.
+         * @param size      Number of values to be borrowed.
+         * @return          Batch borrowing those values.
+         */
+        template <typename T>
+        static Batch borrow(const T* values, const std::size_t& size)
+        {
+            return Batch(&Operations::For<T>::instance, values, size);
+        }
+
+        /** Construct an empty batch. */
+        Batch() :
+            dm_operations(NULL),
+            dm_values(NULL),
+            dm_size(0),
+            dm_owner()
+        {
+        }
+
+        /**
+         * Is this batch empty?
+         *
+         * @return    Boolean "true" if this batch is empty, or "false"
+         *            otherwise.
+         */
+        bool empty() const
+        {
+            return dm_size == 0;
+        }
+
+        /**
+         * Get the number of values in this batch.
+         *
+         * @return    Number of values in this batch.
+         */
+        std::size_t size() const
+        {
+            return dm_size;
+        }
+
+        /**
+         * Get the values of this batch.
+         *
+         * @tparam T    Type of the values.
+         * @return      Pointer to the first value, or null if this batch
+         *              is empty.
+         */
+        template <typename T>
+        const T* get() const
+        {
+            return static_cast<const T*>(dm_values);
+        }
+
+        /**
+         * Get one of the values of this batch.
+         *
+         * @param index    Index of the value.
+         * @return         Value borrowing that value from this batch.
+         */
+        Value operator[](const std::size_t& index) const
+        {
+            return dm_operations->element(dm_values, index);
+        }
+
+        /**
+         * Get a batch that shares ownership of the values of this batch, and
+         * that thus remains valid after the emission of this batch has
+         * returned.
+         *
+         * @return    Batch sharing ownership of the values.
+         */
+        Batch retain() const
+        {
+            if (!dm_owner && (dm_size > 0))
+            {
+                dm_owner = dm_operations->share(dm_values, dm_size);
+                dm_values = dm_operations->first(dm_owner.get());
+            }
+            return *this;
+        }
+
+    private:
+
+        /**
+         * Table of the operations, for one particular value type, needed by a
+         * batch. Allows batches to manipulate the values without knowing their
+         * type.
+         */
+        struct Operations
+        {
+            /** Get a value borrowing the value with the specified index. */
+            Value (*element)(const void* values, std::size_t index);
+
+            /** Copy values onto the heap, as a std::vector. */
+            boost::shared_ptr<const void> (*share)(const void* values,
+                                                   std::size_t size);
+
+            /** Get the first value in a std::vector. */
+            const void* (*first)(const void* vector);
+
+            /** Table of operations for the template-specified type. */
+            template <typename T>
+            struct For
+            {
+                static Value element(const void* values, std::size_t index)
+                {
+                    return Value::borrow(static_cast<const T*>(values)[index]);
+                }
+
+                static boost::shared_ptr<const void> share(const void* values,
+                                                           std::size_t size)
+                {
+                    const T* first = static_cast<const T*>(values);
+                    return boost::shared_ptr<const void>(
+                        new std::vector<T>(first, first + size)
+                        );
+                }
+
+                static const void* first(const void* vector)
+                {
+                    return &static_cast<const std::vector<T>*>(vector)->front();
+                }
+
+                static const Operations instance;
+            };
+        };
+
+        /** Construct a batch from its individual parts. */
+        Batch(const Operations* operations, const void* values,
+              const std::size_t& size) :
+            dm_operations(operations),
+            dm_values(values),
+            dm_size(size),
+            dm_owner()
+        {
+        }
+
+        /** Operations for the type of this batch's values. */
+        const Operations* dm_operations;
+
+        /** First of the values of this batch. */
+        mutable const void* dm_values;
+
+        /** Number of values in this batch. */
+        std::size_t dm_size;
+
+        /** Owner of this batch's values once they are retained. */
+        mutable boost::shared_ptr<const void> dm_owner;
+
+    }; // class Batch
+
+    template <typename T>
+    const Batch::Operations Batch::Operations::For<T>::instance = {
+        &Batch::Operations::For<T>::element,
+        &Batch::Operations::For<T>::share,
+        &Batch::Operations::For<T>::first
+    };
+
+} } } // namespace KrellInstitute::CBTF::Impl
@@ -0,0 +1,164 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2026 Krell Institute. All Rights Reserved.
+//
+// This program is free software; you can redistribute it and/or modify it under
+// the terms of the GNU General Public License as published by the Free Software
+// Foundation; either version 2 of the License, or (at your option) any later
+// version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+// details.
+//
+// You should have received a copy of the GNU General Public License along with
+// this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+// Place, Suite 330, Boston, MA  02111-1307  USA
+////////////////////////////////////////////////////////////////////////////////
+
+/** @file Declaration of the Epoch and Snapshot classes. */
+
+#pragma once
+
+#include <boost/atomic.hpp>
+#include <boost/noncopyable.hpp>
+
+namespace KrellInstitute { namespace CBTF { namespace Impl {
+
+    /**
+     * Epoch-based reclamation of objects shared with lock-free readers. A
+     * reader enters a critical section by constructing a Guard, and may then
+     * use any object it obtains, from a Snapshot or otherwise, until that
+     * Guard is destroyed. A writer that replaces such an object retires the
+     * old one rather than deleting it, and the old object is then deleted
+     * only once every reader that might still be using it has left its
+     * critical section.
+     *
+     * Readers never block, and only ever write to their own per-thread state,
+     * so concurrent readers don't contend with each other. Writers never block
+     * waiting for readers either; a retired object that can't yet be reclaimed
+     * is simply deleted by a later call to retire(). This allows a reader to
+     * modify the very structures that it is reading, from within its critical
+     * section, without deadlocking.
+     *
+     * @note    Reclamation happens only within retire(), never when a Guard is
+     *          destroyed, so that leaving a critical section stays cheap. An
+     *          object retired while some reader was within a critical section
+     *          therefore lingers, even after that reader has left, until the
+     *          next call to retire() by any thread. Readers should keep their
+     *          critical sections short, and in particular shouldn't call out
+     *          to arbitrary code (such as a component's input handlers) from
+     *          within one, since that delays the reclamation of every object
+     *          retired in the meantime.
+     */
+    class Epoch :
+        private boost::noncopyable
+    {
+
+    public:
+
+        /** Per-thread state of the readers. */
+        struct Record;
+
+        /**
+         * Reader critical section. Critical sections may be nested, in which
+         * case the outermost one determines what objects are protected.
+         */
+        class Guard :
+            private boost::noncopyable
+        {
+
+        public:
+
+            /** Enter a critical section. */
+            Guard();
+
+            /** Leave the critical section. */
+            ~Guard();
+
+        private:
+
+            /** Per-thread state of the calling thread. */
+            Record* dm_record;
+
+        }; // class Guard
+
+        /** Retire an object, deleting it once no reader can be using it. */
+        template <typename T>
+        static void retire(const T* object)
+        {
+            if (object != 0)
+            {
+                retireImpl(&destroy<T>, object);
+            }
+        }
+
+    private:
+
+        /** Type of function used to delete a retired object. */
+        typedef void (*Reclaimer)(const void*);
+
+        /** Delete an object of the specified type. */
+        template <typename T>
+        static void destroy(const void* object)
+        {
+            delete static_cast<const T*>(object);
+        }
+
+        /** Retire an object, deleting it once no reader can be using it. */
+        static void retireImpl(Reclaimer reclaimer, const void* object);
+
+    }; // class Epoch
+
+    /**
+     * Immutable snapshot of some object, published through an atomic pointer.
+     * Readers obtain the current snapshot without taking any lock, and may use
+     * it until they leave their Epoch critical section. Writers, which must be
+     * serialized by the caller, build an updated copy of the object and then
+     * publish it, retiring the previous snapshot.
+     *
+     * @tparam T    Type of object being published.
+     */
+    template <typename T>
+    class Snapshot :
+        private boost::noncopyable
+    {
+
+    public:
+
+        /** Construct a snapshot publishing the given object. */
+        explicit Snapshot(const T* object) :
+            dm_current(object)
+        {
+        }
+
+        /** Destructor. */
+        ~Snapshot()
+        {
+            Epoch::retire(dm_current.load());
+        }
+
+        /**
+         * Get the current object. The caller must be within an Epoch critical
+         * section for as long as it uses the returned object, unless it is the
+         * (only) writer.
+         */
+        const T* get() const
+        {
+            return dm_current.load();
+        }
+
+        /** Publish the given object, retiring the previous one. */
+        void publish(const T* object)
+        {
+            Epoch::retire(dm_current.exchange(object));
+        }
+
+    private:
+
+        /** Currently published object. */
+        boost::atomic<const T*> dm_current;
+
+    }; // class Snapshot
+
+} } } // namespace KrellInstitute::CBTF::Impl
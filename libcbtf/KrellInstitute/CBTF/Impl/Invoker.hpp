@@ -20,7 +20,9 @@
 
 #pragma once
 
-#include <boost/any.hpp>
+#include <cstddef>
+#include <KrellInstitute/CBTF/Impl/Batch.hpp>
+#include <KrellInstitute/CBTF/Impl/Value.hpp>
 
 namespace KrellInstitute { namespace CBTF { namespace Impl {
 
@@ -31,12 +33,44 @@ namespace KrellInstitute { namespace CBTF { namespace Impl {
      */
     struct Invoker
     {
+        /**
+         * Allocate memory for an invoker. Invokers created while a component
+         * network is being constructed are allocated from that network's
+         * arena, alongside the rest of its components' implementation.
+         *
+         * @param size    Size (in bytes) of the invoker.
+         * @return        Allocated memory.
+         */
+        static void* operator new(std::size_t size);
+
+        /**
+         * Deallocate memory for an invoker.
+         *
+         * @param ptr    Memory to be deallocated.
+         */
+        static void operator delete(void* ptr);
+
         /**
          * Invoke the handler with the specified value.
          *
          * @param value    Value to pass to the handler.
          */
-        virtual void operator()(const boost::any& value) const = 0;
+        virtual void operator()(const Value& value) const = 0;
+
+        /**
+         * Invoke the handler with the specified batch of values. By default
+         * the handler is invoked once for each value in the batch. Invokers
+         * whose handler accepts a whole batch override this.
+         *
+         * @param batch    Batch of values to pass to the handler.
+         */
+        virtual void operator()(const Batch& batch) const
+        {
+            for (std::size_t i = 0; i < batch.size(); ++i)
+            {
+                (*this)(batch[i]);
+            }
+        }
     };
 
 } } } // namespace KrellInstitute::CBTF::Impl
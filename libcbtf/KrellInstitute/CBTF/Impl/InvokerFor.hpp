@@ -20,16 +20,16 @@
 
 #pragma once
 
-#include <boost/any.hpp>
 #include <boost/function.hpp>
 #include <KrellInstitute/CBTF/Impl/Invoker.hpp>
+#include <KrellInstitute/CBTF/Impl/Value.hpp>
 
 namespace KrellInstitute { namespace CBTF { namespace Impl {
 
     /**
      * Concrete implementation of the Invoker abstract base class for a
-     * value of the template-specified type. Converts between a boost::any
-     * and a typed value that can actually be passed into the handler.
+     * value of the template-specified type. Converts between a Value and
+     * a typed value that can actually be passed into the handler.
      *
      * @tparam T    Type of the value being passed.
      */
@@ -53,8 +53,9 @@ namespace KrellInstitute { namespace CBTF { namespace Impl {
          *
          * @param value    Value to pass to the handler.
          *
-         * @note    It would be better to use boost::any_cast below instead of
-         *          boost::unsafe_any_cast. Unfortunately boost::any_cast uses
+         * @note    It would be better for Value::get() to check the type, as
+         *          boost::any_cast does, rather than behaving like boost::
+         *          unsafe_any_cast. Unfortunately boost::any_cast uses
          *          (as of Boost 1.40 anyway) direct equality comparisons of
          *          typeinfo objects. Doing so is not supported across shared
          *          library boundaries by GCC, and packaging components into
@@ -64,10 +65,9 @@ namespace KrellInstitute { namespace CBTF { namespace Impl {
          *
          * @sa http://gcc.gnu.org/faq.html#dso
          */
-        virtual void operator()(const boost::any& value) const
+        virtual void operator()(const Value& value) const
         {
-            // dm_handler(boost::any_cast<T>(value));
-            dm_handler(*boost::unsafe_any_cast<T>(&value));
+            dm_handler(*value.get<T>());
         }
 
         /** Handler being invoked. */
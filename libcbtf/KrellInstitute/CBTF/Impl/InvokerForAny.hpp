@@ -23,12 +23,16 @@
 #include <boost/any.hpp>
 #include <boost/function.hpp>
 #include <KrellInstitute/CBTF/Impl/Invoker.hpp>
+#include <KrellInstitute/CBTF/Impl/Value.hpp>
 
 namespace KrellInstitute { namespace CBTF { namespace Impl {
 
     /**
      * Concrete implementation of the Invoker abstract base class for a value
-     * of any type. Simply passes the value straight through to the handler.
+     * of any type. Converts the value to a boost::any, which requires copying
+     * it, before passing it to the handler.
+     *
+     * @sa InvokerForValue
      */
     struct InvokerForAny :
         public Invoker
@@ -51,9 +55,9 @@ namespace KrellInstitute { namespace CBTF { namespace Impl {
          *
          * @param value    Value to pass to the handler.
          */
-        virtual void operator()(const boost::any& value) const
+        virtual void operator()(const Value& value) const
         {
-            dm_handler(value);
+            dm_handler(value.toAny());
         }
 
         /** Handler being invoked. */
@@ -0,0 +1,91 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2026 Krell Institute. All Rights Reserved.
+//
+// This program is free software; you can redistribute it and/or modify it under
+// the terms of the GNU General Public License as published by the Free Software
+// Foundation; either version 2 of the License, or (at your option) any later
+// version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+// details.
+//
+// You should have received a copy of the GNU General Public License along with
+// this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+// Place, Suite 330, Boston, MA  02111-1307  USA
+////////////////////////////////////////////////////////////////////////////////
+
+/** @file Declaration and definition of the InvokerForBatch functor. */
+
+#pragma once
+
+#include <boost/function.hpp>
+#include <boost/range/iterator_range.hpp>
+#include <KrellInstitute/CBTF/Impl/Batch.hpp>
+#include <KrellInstitute/CBTF/Impl/Invoker.hpp>
+#include <KrellInstitute/CBTF/Impl/Value.hpp>
+
+namespace KrellInstitute { namespace CBTF { namespace Impl {
+
+    /**
+     * Concrete implementation of the Invoker abstract base class for a batch
+     * handler of values of the template-specified type. Passes batches intact
+     * to the handler as a contiguous range, and passes single values as a
+     * range containing only that value.
+     *
+     * @tparam T    Type of the values being passed.
+     *
+     * @sa InvokerFor
+     */
+    template <typename T>
+    struct InvokerForBatch :
+        public Invoker
+    {
+        /**
+         * Construct an invoker for the specified handler function.
+         *
+         * @param handler    Handler being invoked.
+         */
+        InvokerForBatch(
+            const boost::function<
+                void (const boost::iterator_range<const T*>&)
+                >& handler
+            ) :
+            Invoker(),
+            dm_handler(handler)
+        {
+        }
+
+        /**
+         * Invoke the handler with the specified value.
+         *
+         * @param value    Value to pass to the handler.
+         */
+        virtual void operator()(const Value& value) const
+        {
+            const T* first = value.get<T>();
+            dm_handler(boost::iterator_range<const T*>(first, first + 1));
+        }
+
+        /**
+         * Invoke the handler with the specified batch of values.
+         *
+         * @param batch    Batch of values to pass to the handler.
+         */
+        virtual void operator()(const Batch& batch) const
+        {
+            const T* first = batch.get<T>();
+            dm_handler(
+                boost::iterator_range<const T*>(first, first + batch.size())
+                );
+        }
+
+        /** Handler being invoked. */
+        const boost::function<
+            void (const boost::iterator_range<const T*>&)
+            > dm_handler;
+
+    }; // struct InvokerForBatch<T>
+
+} } } // namespace KrellInstitute::CBTF::Impl
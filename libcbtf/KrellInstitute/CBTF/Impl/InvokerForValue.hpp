@@ -0,0 +1,104 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2026 Krell Institute. All Rights Reserved.
+//
+// This program is free software; you can redistribute it and/or modify it under
+// the terms of the GNU General Public License as published by the Free Software
+// Foundation; either version 2 of the License, or (at your option) any later
+// version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+// details.
+//
+// You should have received a copy of the GNU General Public License along with
+// this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+// Place, Suite 330, Boston, MA  02111-1307  USA
+////////////////////////////////////////////////////////////////////////////////
+
+/** @file Declaration and definition of the InvokerForValue functor. */
+
+#pragma once
+
+#include <boost/function.hpp>
+#include <KrellInstitute/CBTF/Impl/Batch.hpp>
+#include <KrellInstitute/CBTF/Impl/Invoker.hpp>
+#include <KrellInstitute/CBTF/Impl/Value.hpp>
+
+namespace KrellInstitute { namespace CBTF { namespace Impl {
+
+    /**
+     * Concrete implementation of the Invoker abstract base class for a value
+     * of any type. Simply passes the value straight through to the handler.
+     * Batches of values are passed straight through to the batch handler, if
+     * there is one, or are otherwise unrolled.
+     */
+    struct InvokerForValue :
+        public Invoker
+    {
+        /**
+         * Construct an invoker for the specified handler function.
+         *
+         * @param handler    Handler being invoked.
+         */
+        InvokerForValue(
+            const boost::function<void (const Value&)>& handler
+            ) :
+            Invoker(),
+            dm_handler(handler),
+            dm_batch_handler()
+        {
+        }
+
+        /**
+         * Construct an invoker for the specified handler functions.
+         *
+         * @param handler          Handler being invoked for single values.
+         * @param batch_handler    Handler being invoked for batches of values.
+         */
+        InvokerForValue(
+            const boost::function<void (const Value&)>& handler,
+            const boost::function<void (const Batch&)>& batch_handler
+            ) :
+            Invoker(),
+            dm_handler(handler),
+            dm_batch_handler(batch_handler)
+        {
+        }
+        
+        /**
+         * Invoke the handler with the specified value.
+         *
+         * @param value    Value to pass to the handler.
+         */
+        virtual void operator()(const Value& value) const
+        {
+            dm_handler(value);
+        }
+
+        /**
+         * Invoke the handler with the specified batch of values.
+         *
+         * @param batch    Batch of values to pass to the handler.
+         */
+        virtual void operator()(const Batch& batch) const
+        {
+            if (dm_batch_handler)
+            {
+                dm_batch_handler(batch);
+            }
+            else
+            {
+                Invoker::operator()(batch);
+            }
+        }
+        
+        /** Handler being invoked for single values. */
+        const boost::function<void (const Value&)> dm_handler;
+
+        /** Handler (if any) being invoked for batches of values. */
+        const boost::function<void (const Batch&)> dm_batch_handler;
+
+    }; // struct InvokerForValue
+
+} } } // namespace KrellInstitute::CBTF::Impl
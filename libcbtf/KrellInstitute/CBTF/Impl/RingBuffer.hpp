@@ -0,0 +1,149 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2026 Krell Institute. All Rights Reserved.
+//
+// This program is free software; you can redistribute it and/or modify it under
+// the terms of the GNU General Public License as published by the Free Software
+// Foundation; either version 2 of the License, or (at your option) any later
+// version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+// details.
+//
+// You should have received a copy of the GNU General Public License along with
+// this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+// Place, Suite 330, Boston, MA  02111-1307  USA
+////////////////////////////////////////////////////////////////////////////////
+
+/** @file Declaration and definition of the RingBuffer class. */
+
+#pragma once
+
+#include <boost/atomic.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/none.hpp>
+#include <boost/optional.hpp>
+#include <cstddef>
+#include <vector>
+
+namespace KrellInstitute { namespace CBTF { namespace Impl {
+
+    /**
+     * Bounded, lock-free, single-producer/single-consumer queue. At most one
+     * thread at a time may push values, and at most one (possibly different)
+     * thread at a time may pop them. Neither ever blocks; a push into a full
+     * buffer, or a pop from an empty one, simply fails.
+     *
+     * @tparam T    Type of the values in the buffer.
+     */
+    template <typename T>
+    class RingBuffer :
+        private boost::noncopyable
+    {
+
+    public:
+
+        /**
+         * Construct an empty buffer.
+         *
+         * @param capacity    Maximum number of values in the buffer.
+         */
+        explicit RingBuffer(const std::size_t& capacity) :
+            dm_slots(capacity + 1),
+            dm_head(0),
+            dm_tail(0)
+        {
+        }
+
+        /**
+         * Push a value into this buffer. Called only by the producer.
+         *
+         * @param value    Value to be pushed.
+         * @return         Boolean "true" if the value was pushed, or "false"
+         *                 if this buffer was full.
+         */
+        bool tryPush(const T& value)
+        {
+            const std::size_t tail = dm_tail.load(boost::memory_order_relaxed);
+            if (next(tail) == dm_head.load(boost::memory_order_acquire))
+            {
+                return false;
+            }
+            dm_slots[tail] = value;
+            dm_tail.store(next(tail), boost::memory_order_release);
+            return true;
+        }
+
+        /**
+         * Pop the oldest value from this buffer. Called only by the consumer.
+         *
+         * @retval value    Value that was popped.
+         * @return          Boolean "true" if a value was popped, or "false"
+         *                  if this buffer was empty.
+         */
+        bool tryPop(boost::optional<T>& value)
+        {
+            const std::size_t head = dm_head.load(boost::memory_order_relaxed);
+            if (head == dm_tail.load(boost::memory_order_acquire))
+            {
+                return false;
+            }
+            value = boost::none;
+            value.swap(dm_slots[head]);
+            dm_head.store(next(head), boost::memory_order_release);
+            return true;
+        }
+
+        /**
+         * Pop all of the values from this buffer, oldest first, releasing
+         * their slots to the producer all at once. Called only by the
+         * consumer.
+         *
+         * @tparam OutputIterator    Type of output iterator.
+         * @param out                Output iterator receiving the values.
+         * @return                   Number of values that were popped.
+         */
+        template <typename OutputIterator>
+        std::size_t drain(OutputIterator out)
+        {
+            const std::size_t tail = dm_tail.load(boost::memory_order_acquire);
+            std::size_t count = 0;
+            for (std::size_t head = dm_head.load(boost::memory_order_relaxed);
+                 head != tail;
+                 head = next(head), ++count)
+            {
+                *out++ = *dm_slots[head];
+                dm_slots[head] = boost::none;
+            }
+            dm_head.store(tail, boost::memory_order_release);
+            return count;
+        }
+
+    private:
+
+        /** Get the index of the slot following the given one. */
+        std::size_t next(const std::size_t& index) const
+        {
+            return ((index + 1) == dm_slots.size()) ? 0 : (index + 1);
+        }
+
+        /**
+         * Slots holding the values. Slots are emptied as soon as their value
+         * is popped, and one slot is always left unused in order to tell a
+         * full buffer from an empty one.
+         */
+        std::vector<boost::optional<T> > dm_slots;
+
+        /** Index of the oldest value. Written only by the consumer. */
+        boost::atomic<std::size_t> dm_head;
+
+        /** Padding keeping the head and tail in separate cache lines. */
+        char dm_padding[64];
+
+        /** Index of the next free slot. Written only by the producer. */
+        boost::atomic<std::size_t> dm_tail;
+
+    }; // class RingBuffer<T>
+
+} } } // namespace KrellInstitute::CBTF::Impl
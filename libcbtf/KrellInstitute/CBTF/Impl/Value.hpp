@@ -0,0 +1,441 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2026 Krell Institute. All Rights Reserved.
+//
+// This program is free software; you can redistribute it and/or modify it under
+// the terms of the GNU General Public License as published by the Free Software
+// Foundation; either version 2 of the License, or (at your option) any later
+// version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+// details.
+//
+// You should have received a copy of the GNU General Public License along with
+// this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+// Place, Suite 330, Boston, MA  02111-1307  USA
+////////////////////////////////////////////////////////////////////////////////
+
+
+/** @file Declaration and definition of the Value class. */
+
+#pragma once
+
+#include <boost/any.hpp>
+#include <boost/config.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/type_traits/aligned_storage.hpp>
+#include <boost/type_traits/alignment_of.hpp>
+#include <boost/type_traits/has_trivial_copy.hpp>
+#include <boost/type_traits/has_trivial_destructor.hpp>
+#include <boost/type_traits/integral_constant.hpp>
+#include <cstddef>
+#include <new>
+
+#if !defined(BOOST_NO_CXX11_RVALUE_REFERENCES)
+#include <utility>
+#endif
+
+namespace KrellInstitute { namespace CBTF { namespace Impl {
+
+    /**
+     * Trait indicating whether copying objects of the template-specified type
+     * is cheap enough that a retained Value should hold its own copy of small
+     * objects, rather than sharing a single heap-allocated copy. True for any
+     * trivially copyable type. May be specialized for other types.
+     *
+     * @tparam T    Type of the object.
+     */
+    template <typename T>
+    struct IsCheaplyCopyable :
+        public boost::integral_constant<
+            bool,
+            boost::has_trivial_copy<T>::value &&
+            boost::has_trivial_destructor<T>::value
+            >
+    {
+    };
+
+    /** Shared pointers are cheaply copyable. */
+    template <typename T>
+    struct IsCheaplyCopyable<boost::shared_ptr<T> > :
+        public boost::true_type
+    {
+    };
+    
+    /**
+     * Type-erased value conveyed from a component's output to the inputs
+     * connected to it. Replaces boost::any on the emission path so that a
+     * value emitted once can reach every connected input, including those
+     * reached through mediators, without being copied.
+     *
+     * A value usually just borrows the emitted object, which only remains
+     * valid until the emission returns. Anything needing the value beyond
+     * that point must call retain(), which produces a value owning (or
+     * sharing ownership of) the object. Small, cheaply copyable, objects are
+     * copied into an internal buffer. Other objects are copied (or moved, if
+     * they were emitted as an rvalue) onto the heap the first time they are
+     * retained, and then shared with all subsequent retainers.
+     *
+     * @note    As is the case for boost::unsafe_any_cast, the type of the
+     *          object isn't checked by get(). The framework checks types
+     *          when components are connected and when values are emitted.
+     *
+     * @note    Retaining a borrowed value can relocate the object it refers
+     *          to. Pointers previously returned by get() must therefore not
+     *          be used after retain() has been called on the same value.
+     */
+    class Value
+    {
+
+    public:
+
+        /**
+         * Construct a value that borrows the specified object.
+         *
+         * @tparam T        Type of the object.
+         * @param object    Object to be borrowed.
+         * @return          Value borrowing that object.
+         */
+        template <typename T>
+        static Value borrow(const T& object)
+        {
+            return Value(kBorrowed, &Operations::For<T>::instance, &object);
+        }
+
+#if !defined(BOOST_NO_CXX11_RVALUE_REFERENCES)
+        /**
+         * Construct a value that borrows the specified object, which may be
+         * moved from (rather than copied) if the value is ever retained.
+         *
+         * @tparam T        Type of the object.
+         * @param object    Object to be borrowed.
+         * @return          Value borrowing that object.
+         */
+        template <typename T>
+        static Value borrowMovable(T& object)
+        {
+            return Value(kMovable, &Operations::For<T>::instance, &object);
+        }
+#endif
+
+        /**
+         * Construct a value sharing ownership of the specified object.
+         *
+         * @tparam T        Type of the object.
+         * @param object    Object to be shared.
+         * @return          Value sharing that object.
+         */
+        template <typename T>
+        static Value share(const boost::shared_ptr<const T>& object)
+        {
+            Value value(kShared, &Operations::For<T>::instance, object.get());
+            value.dm_owner = object;
+            return value;
+        }
+
+        /** Construct an empty value. */
+        Value() :
+            dm_mode(kEmpty),
+            dm_operations(NULL),
+            dm_object(NULL),
+            dm_owner()
+        {
+        }
+        
+        /**
+         * Construct a value that borrows the object within a boost::any.
+         *
+         * @param any    boost::any containing the object to be borrowed.
+         */
+        explicit Value(const boost::any& any) :
+            dm_mode(kAny),
+            dm_operations(NULL),
+            dm_object(&any),
+            dm_owner()
+        {
+        }
+
+        /**
+         * Construct a value from an existing value. A value borrowing its
+         * object is copied as another borrowing value.
+         *
+         * @param other    Value to be copied.
+         */
+        Value(const Value& other) :
+            dm_mode(other.dm_mode),
+            dm_operations(other.dm_operations),
+            dm_object(other.dm_object),
+            dm_owner(other.dm_owner)
+        {
+            if (dm_mode == kInline)
+            {
+                dm_operations->copy(other.dm_object, &dm_storage);
+                dm_object = &dm_storage;
+            }
+            else if (dm_mode == kMovable)
+            {
+                dm_mode = kBorrowed;
+            }
+        }
+        
+        /** Destructor. */
+        ~Value()
+        {
+            if (dm_mode == kInline)
+            {
+                dm_operations->destroy(&dm_storage);
+            }
+        }
+
+        /**
+         * Replace this value with a copy of another one.
+         *
+         * @param other    Value to be copied.
+         * @return         Resulting (this) value.
+         */
+        Value& operator=(const Value& other)
+        {
+            if (this != &other)
+            {
+                Value copy(other);
+                this->~Value();
+                new (this) Value(copy);
+            }
+            return *this;
+        }
+
+        /**
+         * Is this value empty?
+         *
+         * @return    Boolean "true" if this value is empty, or "false"
+         *            otherwise.
+         */
+        bool empty() const
+        {
+            return dm_mode == kEmpty;
+        }
+
+        /**
+         * Get the object of this value.
+         *
+         * @tparam T    Type of the object.
+         * @return      Pointer to the object, or null if this value is empty.
+         */
+        template <typename T>
+        const T* get() const
+        {
+            if (dm_mode == kAny)
+            {
+                return boost::unsafe_any_cast<T>(
+                    static_cast<const boost::any*>(dm_object)
+                    );
+            }
+            return static_cast<const T*>(dm_object);
+        }
+
+        /**
+         * Get a value that owns (or shares ownership of) the object of this
+         * value, and that thus remains valid after the emission of this value
+         * has returned.
+         *
+         * @return    Value owning the object.
+         */
+        Value retain() const
+        {
+            switch (dm_mode)
+            {
+
+            case kBorrowed:
+            case kMovable:
+                if (dm_operations->fits_inline)
+                {
+                    Value value(kInline, dm_operations, NULL);
+                    dm_operations->copy(dm_object, &value.dm_storage);
+                    value.dm_object = &value.dm_storage;
+                    return value;
+                }
+                dm_owner = (dm_mode == kMovable) ?
+                    dm_operations->share_moved(const_cast<void*>(dm_object)) :
+                    dm_operations->share(dm_object);
+                dm_object = dm_owner.get();
+                dm_mode = kShared;
+                return *this;
+
+            case kAny:
+                if (!dm_owner)
+                {
+                    dm_owner.reset(new boost::any(
+                        *static_cast<const boost::any*>(dm_object)
+                        ));
+                    dm_object = dm_owner.get();
+                }
+                return *this;
+
+            default:
+                return *this;
+                
+            }
+        }
+
+        /**
+         * Get a boost::any containing a copy of the object of this value.
+         * Provided for compatibility with handlers accepting a boost::any.
+         *
+         * @return    boost::any containing a copy of the object.
+         */
+        boost::any toAny() const
+        {
+            switch (dm_mode)
+            {
+            case kEmpty:
+                return boost::any();
+            case kAny:
+                return *static_cast<const boost::any*>(dm_object);
+            default:
+                return dm_operations->to_any(dm_object);
+            }
+        }
+        
+        /**
+         * Type conversion to a boost::any. Allows handlers accepting a
+         * boost::any to be used where a handler accepting a value is
+         * expected.
+         *
+         * @return    boost::any containing a copy of the object.
+         *
+         * @note    Explicit conversions, or conversions of non-const values,
+         *          will instead select boost::any's constructor and produce a
+         *          boost::any containing this value. Use toAny() instead.
+         */
+        operator boost::any() const
+        {
+            return toAny();
+        }
+        
+    private:
+
+        /** Enumeration of the ways a value can hold its object. */
+        enum Mode
+        {
+            kEmpty,     /**< There is no object. */
+            kBorrowed,  /**< Object is borrowed from the emitter. */
+            kMovable,   /**< Object is borrowed and can be moved from. */
+            kInline,    /**< Object is owned within the internal buffer. */
+            kShared,    /**< Object is shared via a shared pointer. */
+            kAny        /**< Object is within a boost::any. */
+        };
+        
+        /** Size of the internal buffer used for small objects. */
+        static const std::size_t kInlineSize = 3 * sizeof(void*);
+        
+        /** Type of the internal buffer used for small objects. */
+        typedef boost::aligned_storage<kInlineSize>::type Storage;
+        
+        /**
+         * Table of the operations, for one particular object type, needed by
+         * a value. Allows values to manipulate the object without knowing its
+         * type.
+         */
+        struct Operations
+        {
+            /** Can objects of this type be held in the internal buffer? */
+            bool fits_inline;
+            
+            /** Copy construct an object at the specified location. */
+            void (*copy)(const void* object, void* at);
+            
+            /** Destroy an object at the specified location. */
+            void (*destroy)(void* at);
+
+            /** Copy an object onto the heap. */
+            boost::shared_ptr<const void> (*share)(const void* object);
+
+            /** Move an object onto the heap. */
+            boost::shared_ptr<const void> (*share_moved)(void* object);
+
+            /** Copy an object into a boost::any. */
+            boost::any (*to_any)(const void* object);
+
+            /** Table of operations for the template-specified type. */
+            template <typename T>
+            struct For
+            {
+                static void copy(const void* object, void* at)
+                {
+                    new (at) T(*static_cast<const T*>(object));
+                }
+                
+                static void destroy(void* at)
+                {
+                    static_cast<T*>(at)->~T();
+                }
+
+                static boost::shared_ptr<const void> share(const void* object)
+                {
+                    return boost::shared_ptr<const void>(
+                        new T(*static_cast<const T*>(object))
+                        );
+                }
+
+                static boost::shared_ptr<const void> share_moved(void* object)
+                {
+#if !defined(BOOST_NO_CXX11_RVALUE_REFERENCES)
+                    return boost::shared_ptr<const void>(
+                        new T(std::move(*static_cast<T*>(object)))
+                        );
+#else
+                    return share(object);
+#endif
+                }
+                
+                static boost::any to_any(const void* object)
+                {
+                    return boost::any(*static_cast<const T*>(object));
+                }
+                
+                static const Operations instance;
+            };
+        };
+        
+        /** Construct a value from its individual parts. */
+        Value(const Mode& mode, const Operations* operations,
+              const void* object) :
+            dm_mode(mode),
+            dm_operations(operations),
+            dm_object(object),
+            dm_owner()
+        {
+        }
+        
+        /** Way in which this value holds its object. */
+        mutable Mode dm_mode;
+        
+        /** Operations for the type of this value's object. */
+        const Operations* dm_operations;
+        
+        /** Object of this value. */
+        mutable const void* dm_object;
+        
+        /** Owner of this value's object when it is shared. */
+        mutable boost::shared_ptr<const void> dm_owner;
+
+        /** Internal buffer used for small objects. */
+        Storage dm_storage;
+        
+    }; // class Value
+
+    template <typename T>
+    const Value::Operations Value::Operations::For<T>::instance = {
+        IsCheaplyCopyable<T>::value &&
+        (sizeof(T) <= Value::kInlineSize) &&
+        (boost::alignment_of<T>::value <= 
+         boost::alignment_of<Value::Storage>::value),
+        &Value::Operations::For<T>::copy,
+        &Value::Operations::For<T>::destroy,
+        &Value::Operations::For<T>::share,
+        &Value::Operations::For<T>::share_moved,
+        &Value::Operations::For<T>::to_any
+    };
+    
+} } } // namespace KrellInstitute::CBTF::Impl
@@ -0,0 +1,356 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2026 Krell Institute. All Rights Reserved.
+//
+// This program is free software; you can redistribute it and/or modify it under
+// the terms of the GNU General Public License as published by the Free Software
+// Foundation; either version 2 of the License, or (at your option) any later
+// version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+// details.
+//
+// You should have received a copy of the GNU General Public License along with
+// this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+// Place, Suite 330, Boston, MA  02111-1307  USA
+////////////////////////////////////////////////////////////////////////////////
+
+/** @file Declaration and definition of the Input and Output classes. */
+
+#pragma once
+
+#include <algorithm>
+#include <boost/atomic.hpp>
+#include <boost/bind.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/locks.hpp>
+#include <boost/thread/mutex.hpp>
+#include <cstddef>
+#include <iterator>
+#include <KrellInstitute/CBTF/Component.hpp>
+#include <KrellInstitute/CBTF/Impl/Epoch.hpp>
+#include <KrellInstitute/CBTF/Impl/Value.hpp>
+#include <KrellInstitute/CBTF/Type.hpp>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace KrellInstitute { namespace CBTF {
+
+    /**
+     * Statically typed input of a component. A component declares such an
+     * input by having it as a data member, constructed along with the rest
+     * of the component, and naming the member function handling its values.
+     *
+     * The input is also declared with the component under the given name,
+     * so that it can be connected by name, like any other input, including
+     * from within component networks described in XML. Values arriving that
+     * way take the usual path. Only values emitted by a statically typed
+     * output connected directly to this input bypass it.
+     *
+     * @tparam T    Type of the input.
+     */
+    template <typename T>
+    class Input :
+        private boost::noncopyable
+    {
+        friend class Output<T>;
+        
+    public:
+
+        /**
+         * Construct an input. Called from the constructor of the component
+         * containing the input.
+         *
+         * @tparam C         Type of the component containing the input.
+         * @param component  Component containing the input.
+         * @param name       Name of the input.
+         * @param handler    Member function of the component to be called
+         *                   when receiving a new value on this input.
+         *
+         * @throw std::invalid_argument    An input has already been
+         *                                 declared with the given name.
+         */
+        template <typename C>
+        Input(C* component, const std::string& name,
+              void (C::*handler)(const T&)) :
+            dm_component(component),
+            dm_handler(static_cast<Handler>(handler)),
+            dm_outputs()
+        {
+            dm_component->declareInput<T>(
+                name, boost::bind(&Input::receive, this, _1)
+                );
+        }
+
+        /**
+         * Destroy an input. Any direct connections to it are removed.
+         */
+        ~Input()
+        {
+            boost::mutex::scoped_lock guard_connections(
+                Component::directConnections()
+                );
+
+            for (typename std::vector<Output<T>*>::const_iterator
+                     i = dm_outputs.begin(); i != dm_outputs.end(); ++i)
+            {
+                (*i)->removeInput(this);
+            }
+        }
+        
+    private:
+
+        /** Type of pointer to the member function handling values. */
+        typedef void (Component::*Handler)(const T&);
+
+        /** Pass a value to the handler. */
+        void receive(const T& value) const
+        {
+            (dm_component->*dm_handler)(value);
+        }
+
+        /** Component containing this input. */
+        Component* const dm_component;
+        
+        /** Member function handling the values received on this input. */
+        const Handler dm_handler;
+
+        /**
+         * Outputs directly connected to this input. Guarded by the direct
+         * connections lock.
+         */
+        std::vector<Output<T>*> dm_outputs;
+        
+    }; // class Input<T>
+
+    /**
+     * Statically typed output of a component. A component declares such an
+     * output by having it as a data member, constructed along with the rest
+     * of the component, and emits values by calling it.
+     *
+     * The output can be connected directly to statically typed inputs of the
+     * same type. An output and input of different types simply don't compile.
+     * Values are passed over a direct connection by calling the input's handler
+     * (through a pointer to a member function) from the emitting thread. There
+     * is no type check, type erasure, or virtual call per value, and no other
+     * per-value overhead than a brief Epoch critical section and a reference
+     * count taken on the list of directly connected inputs. No critical
+     * section is held while the inputs' handlers are called.
+     *
+     * The output is also declared with the component under the given name, so
+     * that it can be connected by name, like any other output, including from
+     * within component networks described in XML. Values are only emitted by
+     * name once the output has been connected that way.
+     *
+     * @tparam T    Type of the output.
+     *
+     * @note    Direct connections are always synchronous, aren't included in
+     *          the statistics or trace, and unlike connections made by name
+     *          don't keep the input's component alive while a value is being
+     *          passed to it. Components connected directly must therefore be
+     *          owned together, as by a component network, or otherwise not
+     *          destroyed while values are being emitted to them.
+     */
+    template <typename T>
+    class Output :
+        private boost::noncopyable
+    {
+        friend class Input<T>;
+
+    public:
+
+        /**
+         * Construct an output. Called from the constructor of the component
+         * containing the output.
+         *
+         * @tparam C         Type of the component containing the output.
+         * @param component  Component containing the output.
+         * @param name       Name of the output.
+         *
+         * @throw std::invalid_argument    An output has already been
+         *                                 declared with the given name.
+         */
+        template <typename C>
+        Output(C* component, const std::string& name) :
+            dm_component(component),
+            dm_connected(false),
+            dm_index(dm_component->declareOutputImpl(
+                         name, Type::of<T>(), dm_connected
+                         )),
+            dm_inputs(NULL)
+        {
+        }
+
+        /**
+         * Destroy an output. Any direct connections from it are removed.
+         */
+        ~Output()
+        {
+            boost::mutex::scoped_lock guard_connections(
+                Component::directConnections()
+                );
+
+            const boost::shared_ptr<const InputList>* inputs = dm_inputs.get();
+            if (inputs != NULL)
+            {
+                for (typename InputList::const_iterator
+                         i = (*inputs)->begin(); i != (*inputs)->end(); ++i)
+                {
+                    std::vector<Output*>& outputs = (*i)->dm_outputs;
+                    outputs.erase(
+                        std::find(outputs.begin(), outputs.end(), this)
+                        );
+                }
+            }
+        }
+
+        /**
+         * Emit a value on this output. Called by the component containing the
+         * output. The value is passed to each directly connected input, and
+         * then to each input connected by name.
+         *
+         * @param value    Value to be emitted.
+         */
+        void operator()(const T& value) const
+        {
+            boost::shared_ptr<const InputList> inputs;
+            {
+                Impl::Epoch::Guard guard_epoch;
+                const boost::shared_ptr<const InputList>* current =
+                    dm_inputs.get();
+                if (current != NULL)
+                {
+                    inputs = *current;
+                }
+            }
+            
+            if (inputs)
+            {
+                for (typename InputList::const_iterator
+                         i = inputs->begin(); i != inputs->end(); ++i)
+                {
+                    (*i)->receive(value);
+                }
+            }
+
+            if (dm_connected.load(boost::memory_order_acquire))
+            {
+                dm_component->emitOutputImpl(
+                    dm_index, Type::of<T>(), Impl::Value::borrow(value)
+                    );
+            }
+        }
+
+        /**
+         * Connect this output directly to an input.
+         *
+         * @param input    Input being connected.
+         *
+         * @throw std::runtime_error    This output is already directly
+         *                              connected to the input.
+         */
+        void connect(Input<T>& input)
+        {
+            boost::mutex::scoped_lock guard_connections(
+                Component::directConnections()
+                );
+            
+            const boost::shared_ptr<const InputList>* inputs = dm_inputs.get();
+            boost::shared_ptr<InputList> updated(new InputList());
+            if (inputs != NULL)
+            {
+                if (std::find((*inputs)->begin(), (*inputs)->end(), &input) !=
+                    (*inputs)->end())
+                {
+                    throw std::runtime_error(
+                        "The output and input are already connected "
+                        "to each other."
+                        );
+                }
+                updated->reserve((*inputs)->size() + 1);
+                updated->assign((*inputs)->begin(), (*inputs)->end());
+            }
+            updated->push_back(&input);
+
+            input.dm_outputs.push_back(this);
+            dm_inputs.publish(
+                new boost::shared_ptr<const InputList>(updated)
+                );
+        }
+
+        /**
+         * Disconnect this output from an input to which it is directly
+         * connected.
+         *
+         * @param input    Input being disconnected.
+         *
+         * @throw std::runtime_error    This output isn't directly connected
+         *                              to the input.
+         */
+        void disconnect(Input<T>& input)
+        {
+            boost::mutex::scoped_lock guard_connections(
+                Component::directConnections()
+                );
+
+            typename std::vector<Output*>::iterator i = std::find(
+                input.dm_outputs.begin(), input.dm_outputs.end(), this
+                );
+            if (i == input.dm_outputs.end())
+            {
+                throw std::runtime_error(
+                    "The output and input are not connected to each other."
+                    );
+            }
+
+            input.dm_outputs.erase(i);
+            removeInput(&input);
+        }
+
+    private:
+
+        /** Type of container listing the directly connected inputs. */
+        typedef std::vector<Input<T>*> InputList;
+
+        /**
+         * Publish an updated list of the directly connected inputs that
+         * excludes the given input. The caller must hold the direct
+         * connections lock.
+         */
+        void removeInput(Input<T>* input)
+        {
+            const InputList& inputs = **dm_inputs.get();
+            boost::shared_ptr<const InputList>* updated = NULL;
+            if (inputs.size() > 1)
+            {
+                boost::shared_ptr<InputList> list(new InputList());
+                list->reserve(inputs.size() - 1);
+                std::remove_copy(inputs.begin(), inputs.end(),
+                                 std::back_inserter(*list), input);
+                updated = new boost::shared_ptr<const InputList>(list);
+            }
+            dm_inputs.publish(updated);
+        }
+        
+        /** Component containing this output. */
+        Component* const dm_component;
+
+        /** Flag set once this output is connected by name. */
+        boost::atomic<bool> dm_connected;
+        
+        /** Index of this output within its component. */
+        const std::size_t dm_index;
+
+        /**
+         * Directly connected inputs, or null if there are none. The immutable
+         * list is shared so that emitting a value only needs to remain within
+         * an Epoch critical section long enough to take a reference to it.
+         */
+        Impl::Snapshot<boost::shared_ptr<const InputList> > dm_inputs;
+
+    }; // class Output<T>
+
+} } // namespace KrellInstitute::CBTF
@@ -72,7 +72,7 @@ namespace KrellInstitute { namespace CBTF {
 
         /** Default constructor. */
         SignalAdapter() :
-            Component(Type(typeid(SignalAdapter)), Version(0, 0, 0))
+            Component(Type::of<SignalAdapter>(), Version(0, 0, 0))
         {
             declareInput<T>(
                 "value", boost::bind(&SignalAdapter::valueHandler, this, _1)
@@ -0,0 +1,94 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2026 Krell Institute. All Rights Reserved.
+//
+// This program is free software; you can redistribute it and/or modify it under
+// the terms of the GNU General Public License as published by the Free Software
+// Foundation; either version 2 of the License, or (at your option) any later
+// version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+// details.
+//
+// You should have received a copy of the GNU General Public License along with
+// this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+// Place, Suite 330, Boston, MA  02111-1307  USA
+////////////////////////////////////////////////////////////////////////////////
+
+/** @file Declaration of the Statistics structure. */
+
+#pragma once
+
+#include <boost/cstdint.hpp>
+#include <cstddef>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace KrellInstitute { namespace CBTF {
+
+    /**
+     * Performance statistics of a component's inputs and outputs. Statistics
+     * are only gathered while their collection is enabled, either by calling
+     * Component::setStatisticsEnabled() or by setting the CBTF_STATISTICS
+     * environment variable. The latter also causes the statistics of every
+     * component to be written to the standard error stream when the component
+     * is destroyed or the process exits, whichever comes first.
+     */
+    struct Statistics
+    {
+        /**
+         * Number of buckets in a handler timing histogram. Bucket zero counts
+         * the handler invocations that took less than 2 nanoseconds, and each
+         * following bucket N counts those that took at least 2^N nanoseconds
+         * but less than 2^(N+1) nanoseconds. The last bucket also counts all
+         * of the invocations that took longer.
+         */
+        static const std::size_t kHistogramBuckets = 32;
+
+        /** Statistics of one of a component's inputs. */
+        struct Input
+        {
+            /** Number of values received, counting each value in a batch. */
+            boost::uint64_t dm_values;
+
+            /** Number of times the handler was invoked. */
+            boost::uint64_t dm_invocations;
+
+            /** Total time (in nanoseconds) spent inside the handler. */
+            boost::uint64_t dm_time;
+
+            /** Histogram of the time spent inside each handler invocation. */
+            std::vector<boost::uint64_t> dm_histogram;
+        };
+
+        /** Statistics of one of a component's outputs. */
+        struct Output
+        {
+            /** Number of values emitted, counting each value in a batch. */
+            boost::uint64_t dm_values;
+
+            /** Number of emissions, counting each batch only once. */
+            boost::uint64_t dm_emissions;
+        };
+
+        /** Statistics of the component's inputs, keyed by their name. */
+        std::map<std::string, Input> dm_inputs;
+
+        /** Statistics of the component's outputs, keyed by their name. */
+        std::map<std::string, Output> dm_outputs;
+    };
+
+    /**
+     * Redirection to an output stream.
+     *
+     * @param stream        Destination output stream.
+     * @param statistics    Statistics to be redirected.
+     * @return              Destination output stream.
+     */
+    std::ostream& operator<<(std::ostream& stream,
+                             const Statistics& statistics);
+
+} } // namespace KrellInstitute::CBTF
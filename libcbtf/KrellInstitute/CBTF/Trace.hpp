@@ -0,0 +1,185 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2026 Krell Institute. All Rights Reserved.
+//
+// This program is free software; you can redistribute it and/or modify it under
+// the terms of the GNU General Public License as published by the Free Software
+// Foundation; either version 2 of the License, or (at your option) any later
+// version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+// details.
+//
+// You should have received a copy of the GNU General Public License along with
+// this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+// Place, Suite 330, Boston, MA  02111-1307  USA
+////////////////////////////////////////////////////////////////////////////////
+
+/** @file Declaration of the Trace class. */
+
+#pragma once
+
+#include <boost/atomic.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/noncopyable.hpp>
+#include <iostream>
+#include <string>
+
+namespace KrellInstitute { namespace CBTF {
+
+    /**
+     * Recorder of the time spent handling each value. While tracing is enabled
+     * every invocation of a component's input handler, and every message
+     * handled by the MRNet frontend and backends, is recorded into a buffer
+     * private to the calling thread. Recording never takes a lock. Each buffer
+     * is a ring holding the most recent 65536 records, so the oldest records
+     * are silently overwritten when a thread records more than that.
+     *
+     * The records can be written at any time, in the Chrome trace JSON format
+     * understood by chrome://tracing and Perfetto. Timestamps are written as
+     * wall-clock microseconds, so the traces of the different processes of a
+     * distributed component network can be viewed together.
+     *
+     * Tracing is disabled by default. Setting the CBTF_TRACE environment
+     * variable to the name of a file enables tracing from the start of the
+     * process, and writes the trace to that file when the process exits. Any
+     * "%p" in the name is replaced by the process identifier.
+     */
+    class Trace :
+        private boost::noncopyable
+    {
+
+    public:
+
+        /** Type of the identifier of an interned label. */
+        typedef boost::uint32_t Label;
+
+        /**
+         * Records the time spent within the scope of an instance of this class
+         * if tracing was enabled upon entering the scope.
+         */
+        class Scope :
+            private boost::noncopyable
+        {
+
+        public:
+
+            /**
+             * Enter a scope.
+             *
+             * @param category    Label of the category of the scope, usually
+             *                    the component type.
+             * @param name        Label of the name of the scope, usually the
+             *                    name of an input.
+             */
+            Scope(const Label& category, const Label& name) :
+                dm_category(category),
+                dm_name(name),
+                dm_start(isEnabled() ? now() : 0)
+            {
+            }
+
+            /** Leave the scope. */
+            ~Scope()
+            {
+                if (dm_start != 0)
+                {
+                    record(dm_category, dm_name, dm_start, now() - dm_start);
+                }
+            }
+
+        private:
+
+            /** Label of the category of this scope. */
+            const Label dm_category;
+
+            /** Label of the name of this scope. */
+            const Label dm_name;
+
+            /** Time (in nanoseconds) at which this scope was entered. */
+            const boost::uint64_t dm_start;
+
+        }; // class Scope
+
+        /**
+         * Is tracing enabled?
+         *
+         * @return    Boolean "true" if tracing is enabled, or "false"
+         *            otherwise.
+         */
+        static bool isEnabled()
+        {
+            return dm_enabled.load(boost::memory_order_relaxed);
+        }
+
+        /**
+         * Enable or disable tracing.
+         *
+         * @param enabled    Boolean "true" if tracing is to be enabled, or
+         *                   "false" otherwise.
+         */
+        static void setEnabled(const bool& enabled);
+
+        /**
+         * Set the file to which the trace is written when the process exits.
+         *
+         * @param path    Path of the file, or an empty path if the trace
+         *                shouldn't be written when the process exits.
+         */
+        static void setOutputFile(const boost::filesystem::path& path);
+
+        /**
+         * Set the name under which this process appears in the trace.
+         *
+         * @param name    Name of this process.
+         */
+        static void setProcessName(const std::string& name);
+
+        /**
+         * Get the current time from the monotonic clock used for the trace.
+         *
+         * @return    Current time (in nanoseconds).
+         */
+        static boost::uint64_t now();
+
+        /**
+         * Intern a label. Labels are interned once, typically when an input
+         * or message handler is declared, so that records are small and
+         * recording them never allocates memory.
+         *
+         * @param text    Text of the label.
+         * @return        Identifier of the label.
+         */
+        static Label intern(const std::string& text);
+
+        /**
+         * Record the time spent handling something. Nothing is recorded if
+         * tracing is disabled.
+         *
+         * @param category    Label of the category of the record.
+         * @param name        Label of the name of the record.
+         * @param start       Time (in nanoseconds) at which the handling
+         *                    started, as returned by now().
+         * @param duration    Time (in nanoseconds) spent handling it.
+         */
+        static void record(const Label& category, const Label& name,
+                           const boost::uint64_t& start,
+                           const boost::uint64_t& duration);
+
+        /**
+         * Write the records of all threads in the Chrome trace JSON format.
+         *
+         * @param stream    Output stream to which the trace is written.
+         */
+        static void write(std::ostream& stream);
+
+    private:
+
+        /** Flag indicating if tracing is enabled. */
+        static boost::atomic<bool> dm_enabled;
+
+    }; // class Trace
+
+} } // namespace KrellInstitute::CBTF
@@ -36,6 +36,18 @@ namespace KrellInstitute { namespace CBTF {
      * type information, support dynamically defined types, and provide
      * rudimentary reflection capabilities.
      *
+     * Types are interned. Each distinct type name maps to a single canonical,
+     * process-wide entry that is created (and, for C++ types, demangled) only
+     * once. A Type is merely a handle to that entry, so copying a type never
+     * allocates, and comparing two types is an integer comparison.
+     *
+     * @note    Types are ordered by the order in which their names were first
+     *          interned within the process, <em>not</em> alphabetically by
+     *          name. Ordered containers such as std::set<Type> or std::map
+     *          keyed by Type therefore iterate in first-intern order, which
+     *          may differ from one run to the next. Sort by the names of the
+     *          types where a stable, alphabetical order is required.
+     *
      * @sa http://en.wikipedia.org/wiki/Run-time_type_information
      * @sa http://en.wikipedia.org/wiki/Reflection_(computer_science)     
      */
@@ -44,6 +56,21 @@ namespace KrellInstitute { namespace CBTF {
     {
         
     public:
+
+        /**
+         * Get the type for the template-specified C++ type. Equivalent to
+         * Type(typeid(T)), except that the intern table is only consulted
+         * the first time this is called for any given C++ type.
+         *
+         * @tparam T    C++ type whose type is to be returned.
+         * @return      Type for that C++ type.
+         */
+        template <typename T>
+        static const Type& of()
+        {
+            static const Type the_type(typeid(T));
+            return the_type;
+        }
         
         /**
          * Construct a type from its name.
@@ -111,7 +138,7 @@ namespace KrellInstitute { namespace CBTF {
          *
          * @sa http://en.wikipedia.org/wiki/Opaque_pointer
          */
-        Impl::TypeImpl* dm_impl;
+        const Impl::TypeImpl* dm_impl;
 
     }; // class Type
 
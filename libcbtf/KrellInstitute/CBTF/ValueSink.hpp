@@ -20,12 +20,21 @@
 
 #pragma once
 
+#include <algorithm>
+#include <boost/atomic.hpp>
 #include <boost/bind.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <boost/optional.hpp>
+#include <boost/scoped_ptr.hpp>
 #include <boost/shared_ptr.hpp>
 #include <boost/thread/condition_variable.hpp>
+#include <boost/thread/locks.hpp>
 #include <boost/thread/mutex.hpp>
+#include <boost/thread/thread_time.hpp>
+#include <cstddef>
 #include <deque>
 #include <KrellInstitute/CBTF/Component.hpp>
+#include <KrellInstitute/CBTF/Impl/RingBuffer.hpp>
 #include <KrellInstitute/CBTF/Type.hpp>
 #include <KrellInstitute/CBTF/Version.hpp>
 #include <typeinfo>
@@ -38,6 +47,14 @@ namespace KrellInstitute { namespace CBTF {
      * is itself a component, and thus its input can be attached to outputs
      * of other components via the usual mechanism for connecting components.
      *
+     * By default a sink holds any number of values. A sink can instead be
+     * given a capacity, along with a policy determining what happens when a
+     * value arrives at a full sink. A bounded sink that is promised a single
+     * producer, and a single consumer, at any one time holds its values in
+     * a lock-free ring buffer. Producers and consumers then only take a lock
+     * when they must wait for each other. The ring buffer isn't used with the
+     * kDropOldest policy, since the producer would then be popping values too.
+     *
      * @tparam T    Type of the value being sunk.
      *
      * @note    Unlike most component types, this type's factory function
@@ -51,63 +68,323 @@ namespace KrellInstitute { namespace CBTF {
         
     public:
 
+        /** Enumeration of the ways a full sink can handle arriving values. */
+        enum OverflowPolicy
+        {
+            kBlockProducer,  /**< Producer waits until there is room. */
+            kDropOldest,     /**< Oldest value in the sink is discarded. */
+            kDropNewest      /**< Arriving value is discarded. */
+        };
+        
         /**
          * Factory function for this component type.
          *
-         * @return    A new instance of this type.
+         * @param capacity           Maximum number of values held by the
+         *                           new sink, or zero if it is unbounded.
+         * @param policy             Handling of values arriving at a full
+         *                           sink.
+         * @param single_producer    Boolean "true" if values will be emitted
+         *                           into the new sink by one thread at a time,
+         *                           and will be taken from it by one thread at
+         *                           a time, or "false" otherwise.
+         * @return                   A new instance of this type.
          */
-        static boost::shared_ptr<ValueSink> instantiate()
+        static boost::shared_ptr<ValueSink> instantiate(
+            const std::size_t& capacity = 0,
+            const OverflowPolicy& policy = kBlockProducer,
+            const bool& single_producer = false
+            )
         {
-            return boost::shared_ptr<ValueSink>(new ValueSink());
+            return boost::shared_ptr<ValueSink>(
+                new ValueSink(capacity, policy, single_producer)
+                );
         }
                 
         /**
-         * Get the current value of this sink.
+         * Get the current value of this sink, waiting for one if necessary.
          *
          * @return    Current value of this sink.
          */
         operator T()
         {
-            boost::unique_lock<boost::mutex> guard_this(dm_mutex);
-            while (dm_values.empty())
+            boost::optional<T> value;
+            receive(value, true, NULL);
+            return *value;
+        }
+
+        /**
+         * Get the current value of this sink if there is one.
+         *
+         * @retval value    Current value of this sink.
+         * @return          Boolean "true" if a value was gotten, or "false"
+         *                  if this sink was empty.
+         */
+        bool tryGet(T& value)
+        {
+            boost::optional<T> received;
+            if (!receive(received, false, NULL))
             {
-                dm_cv.wait(guard_this);
+                return false;
             }
-            T value = dm_values.front();
-            dm_values.pop_front();
-            return value;
+            value = *received;
+            return true;
+        }
+
+        /**
+         * Get the current value of this sink, waiting a limited time for one
+         * if necessary.
+         *
+         * @param timeout    Maximum time to wait for a value.
+         * @retval value     Current value of this sink.
+         * @return           Boolean "true" if a value was gotten, or "false"
+         *                   if the timeout expired first.
+         */
+        bool getFor(const boost::posix_time::time_duration& timeout, T& value)
+        {
+            boost::system_time deadline = boost::get_system_time() + timeout;
+            boost::optional<T> received;
+            if (!receive(received, true, &deadline))
+            {
+                return false;
+            }
+            value = *received;
+            return true;
+        }
+
+        /**
+         * Get all of the current values of this sink, oldest first, without
+         * waiting. Values are removed from the sink all at once rather than
+         * one at a time.
+         *
+         * @tparam OutputIterator    Type of output iterator.
+         * @param out                Output iterator receiving the values.
+         * @return                   Number of values gotten.
+         */
+        template <typename OutputIterator>
+        std::size_t drain(OutputIterator out)
+        {
+            if (dm_ring)
+            {
+                std::size_t count = dm_ring->drain(out);
+                if (count > 0)
+                {
+                    notify(dm_producer_waiting, dm_not_full);
+                }
+                return count;
+            }
+
+            std::deque<T> values;
+            {
+                boost::unique_lock<boost::mutex> guard_this(dm_mutex);
+                values.swap(dm_values);
+                dm_not_full.notify_all();
+            }
+            std::copy(values.begin(), values.end(), out);
+            return values.size();
+        }
+
+        /**
+         * Get the number of values discarded because this sink was full.
+         *
+         * @return    Number of values discarded so far.
+         */
+        std::size_t getDroppedCount() const
+        {
+            return dm_dropped.load();
         }
         
     private:
 
-        /** Default constructor. */
-        ValueSink() :
-            Component(Type(typeid(ValueSink)), Version(1, 1, 0)),
+        /** Constructor from the capacity and policy of this sink. */
+        ValueSink(const std::size_t& capacity, const OverflowPolicy& policy,
+                  const bool& single_producer) :
+            Component(Type::of<ValueSink>(), Version(1, 1, 0)),
+            dm_capacity(capacity),
+            dm_policy(policy),
+            dm_ring(
+                (single_producer && (capacity > 0) && (policy != kDropOldest)) ?
+                new Impl::RingBuffer<T>(capacity) : NULL
+                ),
             dm_values(),
             dm_mutex(),
-            dm_cv()
+            dm_not_empty(),
+            dm_not_full(),
+            dm_consumer_waiting(false),
+            dm_producer_waiting(false),
+            dm_dropped(0)
         {
             declareInput<T>(
                 "value", boost::bind(&ValueSink::valueHandler, this, _1)
                 );
         }
-                
+
+        /**
+         * Wake the other side of the ring buffer if it is waiting. The fence
+         * pairs with the one taken by the waiting side after setting its flag,
+         * so that either the waiting side sees the ring buffer change, or this
+         * side sees the flag.
+         */
+        void notify(const boost::atomic<bool>& waiting,
+                    boost::condition_variable& cv)
+        {
+            boost::atomic_thread_fence(boost::memory_order_seq_cst);
+            if (waiting.load(boost::memory_order_relaxed))
+            {
+                boost::unique_lock<boost::mutex> guard_this(dm_mutex);
+                cv.notify_all();
+            }
+        }
+
+        /**
+         * Wait on a condition variable until the specified deadline, if any.
+         * Returns false if the deadline expired.
+         */
+        static bool waitUntil(boost::condition_variable& cv,
+                              boost::unique_lock<boost::mutex>& lock,
+                              const boost::system_time* deadline)
+        {
+            if (deadline == NULL)
+            {
+                cv.wait(lock);
+                return true;
+            }
+            return cv.timed_wait(lock, *deadline);
+        }
+
+        /**
+         * Take the oldest value from this sink. If requested, wait until the
+         * specified deadline (if any) for one to arrive. Returns false if no
+         * value was taken.
+         */
+        bool receive(boost::optional<T>& value, const bool& wait,
+                     const boost::system_time* deadline)
+        {
+            if (dm_ring)
+            {
+                if (!dm_ring->tryPop(value))
+                {
+                    if (!wait)
+                    {
+                        return false;
+                    }
+
+                    boost::unique_lock<boost::mutex> guard_this(dm_mutex);
+                    dm_consumer_waiting.store(true, boost::memory_order_relaxed);
+                    boost::atomic_thread_fence(boost::memory_order_seq_cst);
+                    bool received = dm_ring->tryPop(value);
+                    while (!received && waitUntil(dm_not_empty, guard_this,
+                                                  deadline))
+                    {
+                        received = dm_ring->tryPop(value);
+                    }
+                    received = received || dm_ring->tryPop(value);
+                    dm_consumer_waiting.store(false,
+                                              boost::memory_order_relaxed);
+                    if (!received)
+                    {
+                        return false;
+                    }
+                }
+                notify(dm_producer_waiting, dm_not_full);
+                return true;
+            }
+
+            boost::unique_lock<boost::mutex> guard_this(dm_mutex);
+            while (dm_values.empty())
+            {
+                if (!wait ||
+                    (!waitUntil(dm_not_empty, guard_this, deadline) &&
+                     dm_values.empty()))
+                {
+                    return false;
+                }
+            }
+            value = dm_values.front();
+            dm_values.pop_front();
+            dm_not_full.notify_one();
+            return true;
+        }
+        
         /** Handler for the "value" input. */
         void valueHandler(const T& value)
         {
+            if (dm_ring)
+            {
+                if (!dm_ring->tryPush(value))
+                {
+                    if (dm_policy == kDropNewest)
+                    {
+                        dm_dropped.fetch_add(1, boost::memory_order_relaxed);
+                        return;
+                    }
+                    
+                    boost::unique_lock<boost::mutex> guard_this(dm_mutex);
+                    dm_producer_waiting.store(true, boost::memory_order_relaxed);
+                    boost::atomic_thread_fence(boost::memory_order_seq_cst);
+                    while (!dm_ring->tryPush(value))
+                    {
+                        dm_not_full.wait(guard_this);
+                    }
+                    dm_producer_waiting.store(false,
+                                              boost::memory_order_relaxed);
+                }
+                notify(dm_consumer_waiting, dm_not_empty);
+                return;
+            }
+
             boost::unique_lock<boost::mutex> guard_this(dm_mutex);
+            if ((dm_capacity > 0) && (dm_values.size() >= dm_capacity))
+            {
+                switch (dm_policy)
+                {
+                case kBlockProducer:
+                    while (dm_values.size() >= dm_capacity)
+                    {
+                        dm_not_full.wait(guard_this);
+                    }
+                    break;
+                case kDropOldest:
+                    dm_values.pop_front();
+                    dm_dropped.fetch_add(1, boost::memory_order_relaxed);
+                    break;
+                case kDropNewest:
+                    dm_dropped.fetch_add(1, boost::memory_order_relaxed);
+                    return;
+                }
+            }
             dm_values.push_back(value);
-            dm_cv.notify_one();
+            dm_not_empty.notify_one();
         }
+
+        /** Maximum number of values in this sink, or zero if unbounded. */
+        const std::size_t dm_capacity;
+
+        /** Handling of values arriving when this sink is full. */
+        const OverflowPolicy dm_policy;
+
+        /** Ring buffer of values when there is a single producer. */
+        boost::scoped_ptr<Impl::RingBuffer<T> > dm_ring;
         
-        /** Current values of this sink. */
+        /** Current values of this sink when there isn't a ring buffer. */
         std::deque<T> dm_values;
 
         /** Mutual exclusion lock for this sink. */
         boost::mutex dm_mutex;
 
-        /** Condition variable for this sink. */
-        boost::condition_variable dm_cv;
+        /** Condition variable signaled when a value arrives. */
+        boost::condition_variable dm_not_empty;
+
+        /** Condition variable signaled when room becomes available. */
+        boost::condition_variable dm_not_full;
+
+        /** Flag indicating if the consumer waits on the ring buffer. */
+        boost::atomic<bool> dm_consumer_waiting;
+
+        /** Flag indicating if the producer waits on the ring buffer. */
+        boost::atomic<bool> dm_producer_waiting;
+
+        /** Number of values discarded because this sink was full. */
+        boost::atomic<std::size_t> dm_dropped;
                 
     }; // class ValueSink<T>
 
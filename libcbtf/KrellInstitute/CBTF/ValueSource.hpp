@@ -66,7 +66,7 @@ namespace KrellInstitute { namespace CBTF {
         ValueSource& operator=(const T& value)
         {
             dm_value = value;
-            emitOutput<T>("value", dm_value);
+            emitOutput(dm_value_port, dm_value);
             return *this;
         }
         
@@ -84,14 +84,17 @@ namespace KrellInstitute { namespace CBTF {
 
         /** Default constructor. */
         ValueSource() :
-            Component(Type(typeid(ValueSource)), Version(0, 0, 0)),
-            dm_value()
+            Component(Type::of<ValueSource>(), Version(0, 0, 0)),
+            dm_value(),
+            dm_value_port(declareOutput<T>("value"))
         {
-            declareOutput<T>("value");
         }
         
         /** Current value of this source. */
         T dm_value;
+
+        /** Handle of the "value" output. */
+        Component::OutputPort<T> dm_value_port;
        
     }; // class ValueSource<T>
         
@@ -0,0 +1,175 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2026 Krell Institute. All Rights Reserved.
+//
+// This program is free software; you can redistribute it and/or modify it under
+// the terms of the GNU General Public License as published by the Free Software
+// Foundation; either version 2 of the License, or (at your option) any later
+// version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+// details.
+//
+// You should have received a copy of the GNU General Public License along with
+// this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+// Place, Suite 330, Boston, MA  02111-1307  USA
+////////////////////////////////////////////////////////////////////////////////
+
+/** @file Definition of the plugin manifest functions. */
+
+#include <boost/filesystem/fstream.hpp>
+#include <stdexcept>
+#include <string>
+
+#include "Manifest.hpp"
+#include "Raise.hpp"
+
+using namespace KrellInstitute::CBTF;
+using namespace KrellInstitute::CBTF::Impl;
+
+
+
+/** Anonymous namespace hiding implementation details. */
+namespace {
+
+    /** First line of every manifest, identifying its format. */
+    const std::string kManifestHeader = "# CBTF plugin manifest 1";
+
+} // namespace <anonymous>
+
+
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+boost::filesystem::path KrellInstitute::CBTF::Impl::getManifestPath(
+    const boost::filesystem::path& path
+    )
+{
+    return boost::filesystem::path(path.string() + ".manifest");
+}
+
+
+
+//------------------------------------------------------------------------------
+// Each line of the manifest holds a keyword followed by one or two tab-separated
+// fields. "Component" lines give the type and version of a component, and are
+// followed by "Input" and "Output" lines naming that component's ports. Any
+// line that isn't understood causes the entire manifest to be disregarded so
+// that the plugin is loaded instead.
+//------------------------------------------------------------------------------
+bool KrellInstitute::CBTF::Impl::readManifest(
+    const boost::filesystem::path& path,
+    std::vector<Component::Descriptor>& descriptors
+    )
+{
+    const boost::filesystem::path manifest_path = getManifestPath(path);
+
+    boost::system::error_code error;
+    std::time_t manifest_time =
+        boost::filesystem::last_write_time(manifest_path, error);
+    if (error || (manifest_time < boost::filesystem::last_write_time(path)))
+    {
+        return false;
+    }
+    
+    boost::filesystem::ifstream stream(manifest_path);
+    std::string line;
+    if (!std::getline(stream, line) || (line != kManifestHeader))
+    {
+        return false;
+    }
+    
+    std::vector<Component::Descriptor> parsed;
+    while (std::getline(stream, line))
+    {
+        if (line.empty())
+        {
+            continue;
+        }
+
+        std::string::size_type tab = line.find('\t');
+        if (tab == std::string::npos)
+        {
+            return false;
+        }
+        
+        const std::string keyword = line.substr(0, tab);
+        const std::string fields = line.substr(tab + 1);
+        
+        if (keyword == "Component")
+        {
+            tab = fields.find('\t');
+            if (tab == std::string::npos)
+            {
+                return false;
+            }
+            try
+            {
+                parsed.push_back(Component::Descriptor(
+                    Type(fields.substr(0, tab)),
+                    Version(fields.substr(tab + 1))
+                    ));
+            }
+            catch (const std::exception&)
+            {
+                return false;
+            }
+        }
+        else if ((keyword == "Input") && !parsed.empty())
+        {
+            parsed.back().dm_inputs.insert(fields);
+        }
+        else if ((keyword == "Output") && !parsed.empty())
+        {
+            parsed.back().dm_outputs.insert(fields);
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    descriptors.insert(descriptors.end(), parsed.begin(), parsed.end());
+    return true;
+}
+
+
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+void KrellInstitute::CBTF::Impl::writeManifest(
+    const boost::filesystem::path& path,
+    const std::vector<Component::Descriptor>& descriptors
+    )
+{
+    const boost::filesystem::path manifest_path = getManifestPath(path);
+
+    boost::filesystem::ofstream stream(manifest_path);
+    
+    stream << kManifestHeader << std::endl;
+    for (std::vector<Component::Descriptor>::const_iterator
+             i = descriptors.begin(); i != descriptors.end(); ++i)
+    {
+        stream << "Component\t" << i->dm_type 
+               << "\t" << i->dm_version << std::endl;
+        for (std::set<std::string>::const_iterator
+                 j = i->dm_inputs.begin(); j != i->dm_inputs.end(); ++j)
+        {
+            stream << "Input\t" << *j << std::endl;
+        }
+        for (std::set<std::string>::const_iterator
+                 j = i->dm_outputs.begin(); j != i->dm_outputs.end(); ++j)
+        {
+            stream << "Output\t" << *j << std::endl;
+        }
+    }
+    
+    stream.close();
+    if (!stream)
+    {
+        raise<std::runtime_error>(
+            "The manifest (%1%) couldn't be written.", manifest_path
+            );
+    }
+}
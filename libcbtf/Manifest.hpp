@@ -0,0 +1,64 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2026 Krell Institute. All Rights Reserved.
+//
+// This program is free software; you can redistribute it and/or modify it under
+// the terms of the GNU General Public License as published by the Free Software
+// Foundation; either version 2 of the License, or (at your option) any later
+// version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+// details.
+//
+// You should have received a copy of the GNU General Public License along with
+// this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+// Place, Suite 330, Boston, MA  02111-1307  USA
+////////////////////////////////////////////////////////////////////////////////
+
+/** @file Declaration of the plugin manifest functions. */
+
+#pragma once
+
+#include <boost/filesystem.hpp>
+#include <KrellInstitute/CBTF/Component.hpp>
+#include <vector>
+
+namespace KrellInstitute { namespace CBTF { namespace Impl {
+
+    /**
+     * Get the path of the manifest of the specified plugin. A plugin's manifest
+     * lists the component types, versions, and ports provided by the plugin,
+     * and is found alongside the plugin with ".manifest" appended to its name.
+     *
+     * @param path    Path of the plugin.
+     * @return        Path of the plugin's manifest.
+     */
+    boost::filesystem::path getManifestPath(const boost::filesystem::path& path);
+
+    /**
+     * Read the manifest of the specified plugin. The manifest is only read if
+     * it exists, is well formed, and is no older than the plugin itself.
+     *
+     * @param path              Path of the plugin.
+     * @retval descriptors      Descriptors of the components provided by the
+     *                          plugin.
+     * @return                  Boolean "true" if the manifest was read, or
+     *                          "false" otherwise.
+     */
+    bool readManifest(const boost::filesystem::path& path,
+                      std::vector<Component::Descriptor>& descriptors);
+
+    /**
+     * Write the manifest of the specified plugin.
+     *
+     * @param path           Path of the plugin.
+     * @param descriptors    Descriptors of the components provided by the
+     *                       plugin.
+     *
+     * @throw std::runtime_error    The manifest couldn't be written.
+     */
+    void writeManifest(const boost::filesystem::path& path,
+                       const std::vector<Component::Descriptor>& descriptors);
+
+} } } // namespace KrellInstitute::CBTF::Impl
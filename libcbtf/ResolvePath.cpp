@@ -19,9 +19,19 @@
 /** @file Definition of the path resolution functions. */
 
 #include <boost/bind.hpp>
+#include <boost/shared_ptr.hpp>
 #include <boost/spirit/home/classic.hpp>
+#include <boost/thread/locks.hpp>
+#include <boost/thread/mutex.hpp>
 #include <cstdlib>
 #include <map>
+#include <set>
+#include <string>
+
+#if defined(__linux__)
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
 
 #include "Global.hpp"
 #include "ResolvePath.hpp"
@@ -72,6 +82,224 @@ namespace {
         }
     } add_default_search_paths;
 
+    /** Cached listing of the entries of one directory. */
+    struct DirectoryIndex
+    {
+        /** Names of the entries of the directory. */
+        std::set<std::string> dm_entries;
+
+        /** Flag indicating if the listing can be cached. */
+        bool dm_cacheable;
+    };
+
+    /**
+     * Cache of the listings of the directories that have been searched, so
+     * that repeated resolutions only touch the filesystem to confirm entries
+     * found in the listings, rather than to probe every directory. Each
+     * listed directory is watched, using inotify, and its listing discarded
+     * as soon as an entry is added to or removed from it. The listings of
+     * directories that can't be watched aren't cached, and nothing is cached
+     * at all where inotify isn't available, since the listings could then
+     * never be invalidated. Caching is disabled if the CBTF_RESOLVE_PATH_CACHE
+     * environment variable is set to "0". Deliberately never destroyed so that
+     * paths can still be resolved during static C++ destruction.
+     */
+    struct DirectoryCache
+    {
+        /** Flag indicating if caching is enabled. */
+        bool dm_enabled;
+
+        /** Mutual exclusion lock for this cache. */
+        boost::mutex dm_mutex;
+
+        /** Listings of the directories, keyed by their path. */
+        std::map<
+            boost::filesystem::path, boost::shared_ptr<const DirectoryIndex>
+            > dm_indexes;
+
+        /** File descriptor of the inotify instance, or -1 if there is none. */
+        int dm_inotify;
+
+        /**
+         * Directories being watched, keyed by their inotify watch. Several
+         * paths (e.g. a symbolic link and its target) can reach the same
+         * directory, and so share one watch.
+         */
+        std::map<int, std::set<boost::filesystem::path> > dm_watches;
+
+        /** Number of changes seen so far in the watched directories. */
+        std::size_t dm_changes;
+
+        /** Default constructor. */
+        DirectoryCache() :
+            dm_enabled(true),
+            dm_mutex(),
+            dm_indexes(),
+            dm_inotify(-1),
+            dm_watches(),
+            dm_changes(0)
+        {
+            const char* value = getenv("CBTF_RESOLVE_PATH_CACHE");
+            dm_enabled = (value == NULL) || (std::string(value) != "0");
+#if defined(__linux__)
+            if (dm_enabled)
+            {
+                dm_inotify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+            }
+#endif
+        }
+
+        /**
+         * Discard the listings of the directories that have changed since they
+         * were listed. Must be called while holding the lock on this cache.
+         */
+        void discardChanged()
+        {
+#if defined(__linux__)
+            if (dm_inotify == -1)
+            {
+                return;
+            }
+
+            char buffer[4096]
+                __attribute__ ((aligned(__alignof__(struct inotify_event))));
+            for (ssize_t length = read(dm_inotify, buffer, sizeof(buffer));
+                 length > 0;
+                 length = read(dm_inotify, buffer, sizeof(buffer)))
+            {
+                for (char* event = buffer; event < (buffer + length);)
+                {
+                    const struct inotify_event* e =
+                        reinterpret_cast<const struct inotify_event*>(event);
+
+                    ++dm_changes;
+                    
+                    if (e->mask & IN_Q_OVERFLOW)
+                    {
+                        dm_indexes.clear();
+                    }
+                    
+                    std::map<
+                        int, std::set<boost::filesystem::path>
+                        >::iterator i = dm_watches.find(e->wd);
+                    if (i != dm_watches.end())
+                    {
+                        for (std::set<boost::filesystem::path>::const_iterator
+                                 j = i->second.begin();
+                             j != i->second.end();
+                             ++j)
+                        {
+                            dm_indexes.erase(*j);
+                        }
+                        if (e->mask & IN_IGNORED)
+                        {
+                            dm_watches.erase(i);
+                        }
+                    }
+                    
+                    event += sizeof(struct inotify_event) + e->len;
+                }
+            }
+#endif
+        }
+
+        /** List the specified directory, and start watching it for changes. */
+        boost::shared_ptr<const DirectoryIndex> list(
+            const boost::filesystem::path& directory
+            )
+        {
+            boost::shared_ptr<DirectoryIndex> index(new DirectoryIndex());
+            index->dm_cacheable = false;
+
+#if defined(__linux__)
+            if (dm_inotify != -1)
+            {
+                int watch = inotify_add_watch(
+                    dm_inotify, directory.string().c_str(),
+                    IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO |
+                    IN_DELETE_SELF | IN_MOVE_SELF | IN_ONLYDIR
+                    );
+                if (watch != -1)
+                {
+                    boost::mutex::scoped_lock guard(dm_mutex);
+                    dm_watches[watch].insert(directory);
+                    index->dm_cacheable = true;
+                }
+            }
+#endif
+            
+            boost::system::error_code error;
+            for (boost::filesystem::directory_iterator
+                     i(directory, error), i_end; !error && (i != i_end);
+                 i.increment(error))
+            {
+                index->dm_entries.insert(i->path().filename().string());
+            }
+            
+            return index;
+        }
+
+        /**
+         * Does the specified relative path exist within the given directory?
+         * The first component of the relative path is looked up in the
+         * directory's listing, which quickly rules out most directories. The
+         * path is then checked directly, so that entries such as dangling
+         * symbolic links aren't considered to exist.
+         */
+        bool exists(const boost::filesystem::path& directory,
+                    const boost::filesystem::path& path)
+        {
+            const std::string first = path.begin()->string();
+            if (!dm_enabled || (dm_inotify == -1) ||
+                (first == ".") || (first == ".."))
+            {
+                return boost::filesystem::exists(directory / path);
+            }
+
+            boost::shared_ptr<const DirectoryIndex> index;
+            std::size_t changes = 0;
+            {
+                boost::mutex::scoped_lock guard(dm_mutex);
+                discardChanged();
+                changes = dm_changes;
+                std::map<
+                    boost::filesystem::path,
+                    boost::shared_ptr<const DirectoryIndex>
+                    >::const_iterator i = dm_indexes.find(directory);
+                if (i != dm_indexes.end())
+                {
+                    index = i->second;
+                }
+            }
+
+            // The listing isn't cached if anything changed while listing it
+            if (!index)
+            {
+                index = list(directory);
+                boost::mutex::scoped_lock guard(dm_mutex);
+                discardChanged();
+                if (index->dm_cacheable && (dm_changes == changes))
+                {
+                    dm_indexes.insert(std::make_pair(directory, index));
+                }
+            }
+
+            if (index->dm_entries.find(first) == index->dm_entries.end())
+            {
+                return false;
+            }
+
+            return boost::filesystem::exists(directory / path);
+        }
+    };
+
+    /** Access the cache of directory listings. */
+    DirectoryCache& directoryCache()
+    {
+        static DirectoryCache* the_cache = new DirectoryCache();
+        return *the_cache;
+    }
+
 } // namespace <anonymous>
 
 
@@ -121,6 +349,8 @@ void KrellInstitute::CBTF::Impl::appendToSearchPath(
 
 
 //------------------------------------------------------------------------------
+// Existence checks go through the cache of directory listings, so a search
+// path that was already listed costs no filesystem access at all.
 //------------------------------------------------------------------------------
 boost::filesystem::path KrellInstitute::CBTF::Impl::resolvePath(
     const std::vector<boost::filesystem::path>& search_paths,
@@ -135,11 +365,9 @@ boost::filesystem::path KrellInstitute::CBTF::Impl::resolvePath(
     for (std::vector<boost::filesystem::path>::const_iterator
              i = search_paths.begin(); i != search_paths.end(); ++i)
     {
-        boost::filesystem::path candidate = *i / path;
-
-        if (boost::filesystem::exists(candidate))
+        if (directoryCache().exists(*i, path))
         {
-            return candidate;
+            return *i / path;
         }
     }
 
@@ -149,6 +377,8 @@ boost::filesystem::path KrellInstitute::CBTF::Impl::resolvePath(
 
 
 //------------------------------------------------------------------------------
+// The search paths are copied while holding their lock, so that they can be
+// safely modified while the resolution is in progress.
 //------------------------------------------------------------------------------
 boost::filesystem::path KrellInstitute::CBTF::Impl::resolvePath(
     const FileType& type,
@@ -160,11 +390,15 @@ boost::filesystem::path KrellInstitute::CBTF::Impl::resolvePath(
         return path;
     }
 
-    SearchPaths::Type::const_iterator i = SearchPaths::value().find(type);
-    if (i != SearchPaths::value().end())
+    std::vector<boost::filesystem::path> search_paths;
     {
-        return resolvePath(i->second, path);
+        SearchPaths::GuardType guard_search_paths(SearchPaths::mutex());
+        SearchPaths::Type::const_iterator i = SearchPaths::value().find(type);
+        if (i != SearchPaths::value().end())
+        {
+            search_paths = i->second;
+        }
     }
     
-    return boost::filesystem::path();
+    return resolvePath(search_paths, path);
 }
@@ -0,0 +1,83 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2026 Krell Institute. All Rights Reserved.
+//
+// This program is free software; you can redistribute it and/or modify it under
+// the terms of the GNU General Public License as published by the Free Software
+// Foundation; either version 2 of the License, or (at your option) any later
+// version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+// details.
+//
+// You should have received a copy of the GNU General Public License along with
+// this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+// Place, Suite 330, Boston, MA  02111-1307  USA
+////////////////////////////////////////////////////////////////////////////////
+
+/** @file Definition of the Statistics structure. */
+
+#include <KrellInstitute/CBTF/Statistics.hpp>
+
+using namespace KrellInstitute::CBTF;
+
+
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+const std::size_t Statistics::kHistogramBuckets;
+
+
+
+//------------------------------------------------------------------------------
+// Write one line per input and output. The non-empty buckets of each input's
+// timing histogram follow on the next line, each labeled with its lower bound.
+//------------------------------------------------------------------------------
+std::ostream& KrellInstitute::CBTF::operator<<(std::ostream& stream,
+                                               const Statistics& statistics)
+{
+    for (std::map<std::string, Statistics::Input>::const_iterator
+             i = statistics.dm_inputs.begin();
+         i != statistics.dm_inputs.end();
+         ++i)
+    {
+        stream << "    Input \"" << i->first << "\": "
+               << i->second.dm_values << " values in "
+               << i->second.dm_invocations << " invocations taking "
+               << i->second.dm_time << " ns";
+        if (i->second.dm_invocations > 0)
+        {
+            stream << " (mean "
+                   << (i->second.dm_time / i->second.dm_invocations)
+                   << " ns)";
+        }
+        stream << std::endl;
+
+        if (i->second.dm_invocations > 0)
+        {
+            stream << "        Histogram:";
+            for (std::size_t b = 0; b < i->second.dm_histogram.size(); ++b)
+            {
+                if (i->second.dm_histogram[b] > 0)
+                {
+                    stream << " >=" << ((b == 0) ? 0 : (1ULL << b)) << "ns:"
+                           << i->second.dm_histogram[b];
+                }
+            }
+            stream << std::endl;
+        }
+    }
+
+    for (std::map<std::string, Statistics::Output>::const_iterator
+             i = statistics.dm_outputs.begin();
+         i != statistics.dm_outputs.end();
+         ++i)
+    {
+        stream << "    Output \"" << i->first << "\": "
+               << i->second.dm_values << " values in "
+               << i->second.dm_emissions << " emissions" << std::endl;
+    }
+
+    return stream;
+}
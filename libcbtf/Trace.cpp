@@ -0,0 +1,459 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2026 Krell Institute. All Rights Reserved.
+//
+// This program is free software; you can redistribute it and/or modify it under
+// the terms of the GNU General Public License as published by the Free Software
+// Foundation; either version 2 of the License, or (at your option) any later
+// version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+// details.
+//
+// You should have received a copy of the GNU General Public License along with
+// this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+// Place, Suite 330, Boston, MA  02111-1307  USA
+////////////////////////////////////////////////////////////////////////////////
+
+/** @file Definition of the Trace class. */
+
+#include <boost/algorithm/string/replace.hpp>
+#include <boost/filesystem/fstream.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/thread/locks.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/tss.hpp>
+#include <cstddef>
+#include <cstdlib>
+#include <deque>
+#include <iomanip>
+#include <KrellInstitute/CBTF/Trace.hpp>
+#include <map>
+#include <time.h>
+#include <unistd.h>
+#include <vector>
+
+using namespace KrellInstitute::CBTF;
+
+
+
+/** Anonymous namespace hiding implementation details. */
+namespace {
+
+    /** Record of the time spent handling something. */
+    struct Record
+    {
+        /** Time (in nanoseconds) at which the handling started. */
+        boost::uint64_t dm_start;
+
+        /** Time (in nanoseconds) spent handling it. */
+        boost::uint64_t dm_duration;
+
+        /** Label of the category of this record. */
+        Trace::Label dm_category;
+
+        /** Label of the name of this record. */
+        Trace::Label dm_name;
+    };
+
+    /**
+     * Ring buffer of the records of a single thread. Only the owning thread
+     * writes to the buffer, so recording needs no lock. Buffers are released
+     * when their thread exits, and then reused by later threads, the same way
+     * as the per-thread records of the Epoch class. They are never deleted, so
+     * that the records of exited threads still appear in the trace until they
+     * are overwritten, and so that the trace can always be written without
+     * walking the list of buffers under a lock. A reused buffer keeps its
+     * thread identifier, so a series of short-lived threads shares a single
+     * row of the trace rather than each adding a new one.
+     */
+    struct Buffer
+    {
+        /** Number of records held by a buffer. */
+        static const std::size_t kCapacity = 65536;
+
+        /** Identifier of the owning thread within the trace. */
+        unsigned int dm_thread;
+
+        /** Number of records ever written to this buffer. */
+        boost::atomic<boost::uint64_t> dm_head;
+
+        /** Flag indicating if this buffer is owned by a thread. */
+        boost::atomic<bool> dm_in_use;
+
+        /** Next buffer in the list of all buffers. */
+        Buffer* dm_next;
+
+        /** Records of this buffer. */
+        Record dm_records[kCapacity];
+    };
+
+    /**
+     * Global state of the tracing. Deliberately never destroyed so that the
+     * trace can still be written during static C++ destruction.
+     */
+    struct State
+    {
+        /** Mutual exclusion lock for this state. */
+        boost::mutex dm_mutex;
+
+        /** Text of the interned labels, indexed by their identifier. */
+        std::deque<std::string> dm_labels;
+
+        /** Identifiers of the interned labels, indexed by their text. */
+        std::map<std::string, Trace::Label> dm_label_ids;
+
+        /** List of all the per-thread buffers. */
+        boost::atomic<Buffer*> dm_buffers;
+
+        /** Number of per-thread buffers allocated so far. */
+        unsigned int dm_threads;
+
+        /** Name of this process within the trace. */
+        std::string dm_process_name;
+
+        /** File to which the trace is written when the process exits. */
+        boost::filesystem::path dm_output_file;
+
+        /** Flag indicating if writing at exit has been registered. */
+        bool dm_registered;
+
+        /** Default constructor. */
+        State() :
+            dm_mutex(),
+            dm_labels(),
+            dm_label_ids(),
+            dm_buffers(NULL),
+            dm_threads(0),
+            dm_process_name(),
+            dm_output_file(),
+            dm_registered(false)
+        {
+        }
+    };
+
+    /** Access the global state of the tracing. */
+    State& state()
+    {
+        static State* the_state = new State();
+        return *the_state;
+    }
+
+    /**
+     * Release the buffer of an exiting thread for reuse. Its records are left
+     * in place for the trace.
+     */
+    void releaseBuffer(Buffer* buffer)
+    {
+        buffer->dm_in_use.store(false);
+    }
+
+    /** Per-thread buffer of the calling thread. */
+    boost::thread_specific_ptr<Buffer> current_buffer(releaseBuffer);
+
+    /** Get the per-thread buffer of the calling thread, allocating one. */
+    Buffer* getCurrentBuffer()
+    {
+        Buffer* buffer = current_buffer.get();
+        if (buffer != NULL)
+        {
+            return buffer;
+        }
+
+        State& the_state = state();
+
+        for (buffer = the_state.dm_buffers.load();
+             buffer != NULL;
+             buffer = buffer->dm_next)
+        {
+            bool in_use = false;
+            if (buffer->dm_in_use.compare_exchange_strong(in_use, true))
+            {
+                current_buffer.reset(buffer);
+                return buffer;
+            }
+        }
+
+        buffer = new Buffer();
+        buffer->dm_head.store(0);
+        buffer->dm_in_use.store(true);
+        {
+            boost::mutex::scoped_lock guard_state(the_state.dm_mutex);
+            buffer->dm_thread = ++the_state.dm_threads;
+            buffer->dm_next = the_state.dm_buffers.load();
+            the_state.dm_buffers.store(buffer);
+        }
+
+        current_buffer.reset(buffer);
+        return buffer;
+    }
+
+    /** Write a string to a stream as a JSON string. */
+    void writeString(std::ostream& stream, const std::string& text)
+    {
+        stream << '"';
+        for (std::string::const_iterator i = text.begin(); i != text.end(); ++i)
+        {
+            if ((*i == '"') || (*i == '\\'))
+            {
+                stream << '\\' << *i;
+            }
+            else if (static_cast<unsigned char>(*i) < 0x20)
+            {
+                stream << "\\u" << std::hex << std::setw(4)
+                       << std::setfill('0') << static_cast<int>(*i)
+                       << std::dec << std::setfill(' ');
+            }
+            else
+            {
+                stream << *i;
+            }
+        }
+        stream << '"';
+    }
+
+    /** Write a time (in nanoseconds) to a stream as microseconds. */
+    void writeTime(std::ostream& stream, const boost::uint64_t& time)
+    {
+        stream << (time / 1000) << '.' << std::setw(3) << std::setfill('0')
+               << (time % 1000) << std::setfill(' ');
+    }
+
+    /** Write the trace to the output file when the process exits. */
+    void writeAtExit()
+    {
+        boost::filesystem::path path;
+        {
+            State& the_state = state();
+            boost::mutex::scoped_lock guard_state(the_state.dm_mutex);
+            path = the_state.dm_output_file;
+        }
+
+        if (!path.empty())
+        {
+            boost::filesystem::ofstream stream(path);
+            Trace::write(stream);
+        }
+    }
+
+    /**
+     * Enable tracing, from the start of the process, if the CBTF_TRACE
+     * environment variable names the file to which the trace is written.
+     */
+    struct Environment
+    {
+        Environment()
+        {
+            const char* value = getenv("CBTF_TRACE");
+            if ((value != NULL) && (std::string(value) != ""))
+            {
+                Trace::setOutputFile(boost::replace_all_copy(
+                    std::string(value), "%p",
+                    boost::lexical_cast<std::string>(getpid())
+                    ));
+                Trace::setEnabled(true);
+            }
+        }
+    } the_environment;
+
+} // namespace <anonymous>
+
+
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+boost::atomic<bool> Trace::dm_enabled(false);
+
+
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+void Trace::setEnabled(const bool& enabled)
+{
+    dm_enabled.store(enabled);
+}
+
+
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+void Trace::setOutputFile(const boost::filesystem::path& path)
+{
+    State& the_state = state();
+    boost::mutex::scoped_lock guard_state(the_state.dm_mutex);
+
+    the_state.dm_output_file = path;
+    if (!the_state.dm_registered)
+    {
+        the_state.dm_registered = true;
+        atexit(&writeAtExit);
+    }
+}
+
+
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+void Trace::setProcessName(const std::string& name)
+{
+    State& the_state = state();
+    boost::mutex::scoped_lock guard_state(the_state.dm_mutex);
+
+    the_state.dm_process_name = name;
+}
+
+
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+boost::uint64_t Trace::now()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (static_cast<boost::uint64_t>(now.tv_sec) * 1000000000) +
+        static_cast<boost::uint64_t>(now.tv_nsec);
+}
+
+
+
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+Trace::Label Trace::intern(const std::string& text)
+{
+    State& the_state = state();
+    boost::mutex::scoped_lock guard_state(the_state.dm_mutex);
+
+    std::map<std::string, Label>::const_iterator i =
+        the_state.dm_label_ids.find(text);
+    if (i != the_state.dm_label_ids.end())
+    {
+        return i->second;
+    }
+
+    Label label = static_cast<Label>(the_state.dm_labels.size());
+    the_state.dm_labels.push_back(text);
+    the_state.dm_label_ids.insert(std::make_pair(text, label));
+    return label;
+}
+
+
+
+//------------------------------------------------------------------------------
+// Fill the next slot of the calling thread's ring buffer and only then publish
+// it by advancing the head, so that a concurrent write() never sees the slot
+// half filled.
+//------------------------------------------------------------------------------
+void Trace::record(const Label& category, const Label& name,
+                   const boost::uint64_t& start,
+                   const boost::uint64_t& duration)
+{
+    if (!isEnabled())
+    {
+        return;
+    }
+
+    Buffer* buffer = getCurrentBuffer();
+
+    const boost::uint64_t head =
+        buffer->dm_head.load(boost::memory_order_relaxed);
+
+    Record& record = buffer->dm_records[head % Buffer::kCapacity];
+    record.dm_start = start;
+    record.dm_duration = duration;
+    record.dm_category = category;
+    record.dm_name = name;
+
+    buffer->dm_head.store(head + 1, boost::memory_order_release);
+}
+
+
+
+//------------------------------------------------------------------------------
+// Threads keep recording while their buffers are copied. So copy the records
+// available at the start, and afterwards discard those whose slots might have
+// been reused in the meantime. Timestamps are shifted from the monotonic clock
+// to the wall clock so that the traces of different processes line up.
+//------------------------------------------------------------------------------
+void Trace::write(std::ostream& stream)
+{
+    State& the_state = state();
+
+    struct timespec realtime;
+    clock_gettime(CLOCK_REALTIME, &realtime);
+    const boost::uint64_t offset =
+        (static_cast<boost::uint64_t>(realtime.tv_sec) * 1000000000) +
+        static_cast<boost::uint64_t>(realtime.tv_nsec) - now();
+
+    const int pid = static_cast<int>(getpid());
+
+    std::string process_name;
+    std::deque<std::string> labels;
+    {
+        boost::mutex::scoped_lock guard_state(the_state.dm_mutex);
+        process_name = the_state.dm_process_name;
+        labels = the_state.dm_labels;
+    }
+
+    stream << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+
+    bool first = true;
+    if (!process_name.empty())
+    {
+        stream << std::endl << "{\"name\":\"process_name\",\"ph\":\"M\","
+               << "\"pid\":" << pid << ",\"args\":{\"name\":";
+        writeString(stream, process_name);
+        stream << "}}";
+        first = false;
+    }
+
+    for (Buffer* buffer = the_state.dm_buffers.load();
+         buffer != NULL;
+         buffer = buffer->dm_next)
+    {
+        const boost::uint64_t head =
+            buffer->dm_head.load(boost::memory_order_acquire);
+        const boost::uint64_t tail =
+            (head > Buffer::kCapacity) ? (head - Buffer::kCapacity) : 0;
+
+        std::vector<Record> records;
+        for (boost::uint64_t i = tail; i < head; ++i)
+        {
+            records.push_back(buffer->dm_records[i % Buffer::kCapacity]);
+        }
+
+        boost::atomic_thread_fence(boost::memory_order_acquire);
+        const boost::uint64_t overwritten =
+            buffer->dm_head.load(boost::memory_order_relaxed) + 1;
+        const std::size_t skipped = static_cast<std::size_t>(
+            (overwritten > (tail + Buffer::kCapacity)) ?
+            std::min<boost::uint64_t>(
+                overwritten - (tail + Buffer::kCapacity), records.size()
+                ) : 0
+            );
+
+        for (std::vector<Record>::const_iterator
+                 i = records.begin() + skipped; i != records.end(); ++i)
+        {
+            if ((i->dm_category >= labels.size()) ||
+                (i->dm_name >= labels.size()))
+            {
+                continue;
+            }
+
+            stream << (first ? "" : ",") << std::endl << "{\"name\":";
+            writeString(stream, labels[i->dm_name]);
+            stream << ",\"cat\":";
+            writeString(stream, labels[i->dm_category]);
+            stream << ",\"ph\":\"X\",\"ts\":";
+            writeTime(stream, i->dm_start + offset);
+            stream << ",\"dur\":";
+            writeTime(stream, i->dm_duration);
+            stream << ",\"pid\":" << pid
+                   << ",\"tid\":" << buffer->dm_thread << "}";
+            first = false;
+        }
+    }
+
+    stream << std::endl << "]}" << std::endl;
+}
@@ -31,7 +31,7 @@ using namespace KrellInstitute::CBTF::Impl;
 // Let the implementation do the real work.
 //------------------------------------------------------------------------------
 Type::Type(const std::string& name) :
-    dm_impl(new TypeImpl(name))
+    dm_impl(TypeImpl::intern(name))
 {
 }
 
@@ -41,59 +41,60 @@ Type::Type(const std::string& name) :
 // Let the implementation do the real work.
 //------------------------------------------------------------------------------
 Type::Type(const std::type_info& info) :
-    dm_impl(new TypeImpl(info))
+    dm_impl(TypeImpl::intern(info))
 {
 }
 
 
 
 //------------------------------------------------------------------------------
-// Let the implementation do the real work.
+// Interned entries are never destroyed, so copying is just a pointer copy.
 //------------------------------------------------------------------------------
 Type::Type(const Type& other) :
-    dm_impl(new TypeImpl(*other.dm_impl))
+    dm_impl(other.dm_impl)
 {
 }
 
 
 
 //------------------------------------------------------------------------------
-// Let the implementation do the real work.
+// The interned entry is shared with every other copy of this type and is
+// never destroyed, so there is nothing to do here.
 //------------------------------------------------------------------------------
 Type::~Type()
 {
-    delete dm_impl;
 }
 
 
 
 //------------------------------------------------------------------------------
-// Let the implementation do the real work.
+// Interned entries are never destroyed, so copying is just a pointer copy.
 //------------------------------------------------------------------------------
 Type& Type::operator=(const Type& other)
 {
-    *dm_impl = *other.dm_impl;
+    dm_impl = other.dm_impl;
     return *this;
 }
 
 
 
 //------------------------------------------------------------------------------
-// Let the implementation do the real work.
+// Compare the identifiers of the interned entries.
 //------------------------------------------------------------------------------
 bool Type::operator<(const Type& other) const
 {
-    return *dm_impl < *other.dm_impl;
+    return dm_impl->getIdentifier() < other.dm_impl->getIdentifier();
 }
 
 
 
 //------------------------------------------------------------------------------
-// Let the implementation do the real work.
+// There is exactly one interned entry per type name, so two types are equal
+// if, and only if, they refer to the same entry.
 //------------------------------------------------------------------------------
 bool Type::operator==(const Type& other) const
 {
-    return *dm_impl == *other.dm_impl;
+    return dm_impl == other.dm_impl;
 }
 
 
@@ -103,7 +104,7 @@ bool Type::operator==(const Type& other) const
 //------------------------------------------------------------------------------
 Type::operator std::string() const
 {
-    return *dm_impl;
+    return dm_impl->getName();
 }
 
 
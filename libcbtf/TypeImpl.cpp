@@ -18,8 +18,11 @@
 
 /** @file Definition of the TypeImpl class. */
 
+#include <boost/thread/locks.hpp>
+#include <boost/thread/shared_mutex.hpp>
 #include <cstdlib>
 #include <cxxabi.h>
+#include <map>
 
 #include "TypeImpl.hpp"
 
@@ -28,80 +31,134 @@ using namespace KrellInstitute::CBTF::Impl;
 
 
 
-//------------------------------------------------------------------------------
-//------------------------------------------------------------------------------
-TypeImpl::TypeImpl(const std::string& name) :
-    dm_name(name)
-{
-}
+/** Anonymous namespace hiding implementation details. */
+namespace {
 
+    /**
+     * Table of interned types. Not implemented using the KRELL_INSTITUTE_CBTF_
+     * IMPL_GLOBAL macro because types are routinely constructed during static
+     * C++ initialization, and that macro's initializer would discard entries
+     * that were interned before it ran. The table (and its entries) are also
+     * deliberately never destroyed so that types remain valid throughout
+     * static C++ destruction.
+     */
+    struct InternTable
+    {
+        /** Mutual exclusion lock for this table. */
+        boost::shared_mutex dm_mutex;
 
+        /** Interned entries indexed by their type name. */
+        std::map<std::string, const TypeImpl*> dm_names;
 
-//------------------------------------------------------------------------------
-// Demangle the type's name from the provided C++ run-time type information.
-//------------------------------------------------------------------------------
-TypeImpl::TypeImpl(const std::type_info& info) :
-    dm_name()
-{
-    int status = 0;
-    char* raw = abi::__cxa_demangle(info.name(), NULL, NULL, &status);
-    dm_name = (status == 0) ? raw : info.name();
-    free(raw);
-}
+        /** Interned entries indexed by their C++ run-time type information. */
+        std::map<const std::type_info*, const TypeImpl*> dm_infos;
+    };
+
+    /** Access the table of interned types. */
+    InternTable& table()
+    {
+        static InternTable* the_table = new InternTable();
+        return *the_table;
+    }
+    
+    /** Demangle the type name from the given C++ run-time type information. */
+    std::string demangle(const std::type_info& info)
+    {
+        int status = 0;
+        char* raw = abi::__cxa_demangle(info.name(), NULL, NULL, &status);
+        std::string name = (status == 0) ? raw : info.name();
+        free(raw);
+        return name;
+    }
+    
+} // namespace <anonymous>
 
 
 
 //------------------------------------------------------------------------------
+// Look for an existing entry with the given name under a shared lock. Failing
+// that, take an exclusive lock and create one (if another thread hasn't beaten
+// us to it in the meantime).
 //------------------------------------------------------------------------------
-TypeImpl::TypeImpl(const TypeImpl& other) :
-    dm_name(other.dm_name)
+const TypeImpl* TypeImpl::intern(const std::string& name)
 {
-}
-
+    InternTable& the_table = table();
 
+    {
+        boost::shared_lock<boost::shared_mutex> guard(the_table.dm_mutex);
+        std::map<std::string, const TypeImpl*>::const_iterator i =
+            the_table.dm_names.find(name);
+        if (i != the_table.dm_names.end())
+        {
+            return i->second;
+        }
+    }
 
-//------------------------------------------------------------------------------
-//------------------------------------------------------------------------------
-TypeImpl::~TypeImpl()
-{
+    boost::unique_lock<boost::shared_mutex> guard(the_table.dm_mutex);
+    std::map<std::string, const TypeImpl*>::const_iterator i =
+        the_table.dm_names.find(name);
+    if (i == the_table.dm_names.end())
+    {
+        i = the_table.dm_names.insert(std::make_pair(
+            name, new TypeImpl(name, the_table.dm_names.size())
+            )).first;
+    }
+    return i->second;
 }
 
 
 
 //------------------------------------------------------------------------------
+// Look for an existing entry for this run-time type information. Failing that,
+// demangle its name (outside of any lock) and intern that. Different shared
+// libraries can have distinct type_info objects for the same C++ type, which
+// is why the name is the final arbiter of identity.
 //------------------------------------------------------------------------------
-TypeImpl& TypeImpl::operator=(const TypeImpl& other)
+const TypeImpl* TypeImpl::intern(const std::type_info& info)
 {
-    if (this != &other)
+    InternTable& the_table = table();
+
     {
-        dm_name = other.dm_name;
+        boost::shared_lock<boost::shared_mutex> guard(the_table.dm_mutex);
+        std::map<const std::type_info*, const TypeImpl*>::const_iterator i =
+            the_table.dm_infos.find(&info);
+        if (i != the_table.dm_infos.end())
+        {
+            return i->second;
+        }
     }
-    return *this;
+
+    const TypeImpl* impl = intern(demangle(info));
+
+    boost::unique_lock<boost::shared_mutex> guard(the_table.dm_mutex);
+    the_table.dm_infos.insert(std::make_pair(&info, impl));
+    return impl;
 }
 
 
 
 //------------------------------------------------------------------------------
 //------------------------------------------------------------------------------
-bool TypeImpl::operator<(const TypeImpl& other) const
+const std::string& TypeImpl::getName() const
 {
-    return dm_name < other.dm_name;
+    return dm_name;
 }
 
 
 
 //------------------------------------------------------------------------------
 //------------------------------------------------------------------------------
-bool TypeImpl::operator==(const TypeImpl& other) const
+std::size_t TypeImpl::getIdentifier() const
 {
-    return dm_name == other.dm_name;
+    return dm_identifier;
 }
 
 
 
 //------------------------------------------------------------------------------
 //------------------------------------------------------------------------------
-TypeImpl::operator std::string() const
+TypeImpl::TypeImpl(const std::string& name, const std::size_t& identifier) :
+    dm_name(name),
+    dm_identifier(identifier)
 {
-    return dm_name;
 }
@@ -20,6 +20,8 @@
 
 #pragma once
 
+#include <boost/noncopyable.hpp>
+#include <cstddef>
 #include <string>
 #include <typeinfo>
 
@@ -29,40 +31,39 @@ namespace KrellInstitute { namespace CBTF { namespace Impl {
      * Implementation details of the Type class. Anything that
      * would normally be a private member of Type is instead a
      * member of TypeImpl.
+     *
+     * Each TypeImpl is the canonical, interned entry for one type name.
+     * Entries are created on demand by intern() and are never destroyed,
+     * allowing Type to refer to them with a bare pointer.
      */
-    class TypeImpl
+    class TypeImpl :
+        private boost::noncopyable
     {
 
     public:
 
-        /** Construct a type from its name. */
-        TypeImpl(const std::string& name);
+        /** Get the interned entry for the type with the given name. */
+        static const TypeImpl* intern(const std::string& name);
 
-        /** Construct a type from its C++ run-time type information. */
-        TypeImpl(const std::type_info& info);
+        /** Get the interned entry for the given C++ run-time type information. */
+        static const TypeImpl* intern(const std::type_info& info);
         
-        /** Construct a type from an existing type. */
-        TypeImpl(const TypeImpl& other);
-        
-        /** Destructor. */
-        ~TypeImpl();
-        
-        /** Replace this type with a copy of another one. */
-        TypeImpl& operator=(const TypeImpl& other);
-
-        /** Is this type less than another one? */
-        bool operator<(const TypeImpl& other) const;
+        /** Get the (demangled) name of this type. */
+        const std::string& getName() const;
 
-        /** Is this type equal to another one? */
-        bool operator==(const TypeImpl& other) const;
-        
-        /** Type conversion to a string. */
-        operator std::string() const;
+        /** Get the unique identifier of this type. */
+        std::size_t getIdentifier() const;
         
     private:
 
+        /** Construct an entry for the type with the given name. */
+        TypeImpl(const std::string& name, const std::size_t& identifier);
+        
         /** Name of this type. */
-        std::string dm_name;
+        const std::string dm_name;
+
+        /** Unique identifier of this type. */
+        const std::size_t dm_identifier;
         
     }; // class TypeImpl
         
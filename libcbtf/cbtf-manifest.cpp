@@ -0,0 +1,73 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2026 Krell Institute. All Rights Reserved.
+//
+// This program is free software; you can redistribute it and/or modify it under
+// the terms of the GNU General Public License as published by the Free Software
+// Foundation; either version 2 of the License, or (at your option) any later
+// version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+// details.
+//
+// You should have received a copy of the GNU General Public License along with
+// this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+// Place, Suite 330, Boston, MA  02111-1307  USA
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @file Tool writing the manifests of component plugins.
+ *
+ * A plugin's manifest lists the component types, versions, and ports that it
+ * provides, allowing Component::registerPlugin() to register them without
+ * loading the plugin. Intended to be run at build or install time. Usage:
+ *
+ *     cbtf-manifest <plugin> [<plugin> ...]
+ *
+ * The manifest of each plugin is written alongside it, with ".manifest"
+ * appended to its name. Plugins should be given one per invocation when one
+ * of them depends upon the component types of another.
+ */
+
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <KrellInstitute/CBTF/Component.hpp>
+
+using namespace KrellInstitute::CBTF;
+
+
+
+/**
+ * Main entry point of the tool.
+ *
+ * @param argc    Number of command-line arguments.
+ * @param argv    Command-line arguments.
+ * @return        Exit status of the tool.
+ */
+int main(int argc, char* argv[])
+{
+    if (argc < 2)
+    {
+        std::cerr << "Usage: " << argv[0] << " <plugin> [<plugin> ...]"
+                  << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    int status = EXIT_SUCCESS;
+    for (int i = 1; i < argc; ++i)
+    {
+        try
+        {
+            Component::writePluginManifest(argv[i]);
+        }
+        catch (const std::exception& error)
+        {
+            std::cerr << argv[0] << ": " << error.what() << std::endl;
+            status = EXIT_FAILURE;
+        }
+    }
+    
+    return status;
+}
@@ -0,0 +1,787 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2026 Krell Institute. All Rights Reserved.
+//
+// This program is free software; you can redistribute it and/or modify it under
+// the terms of the GNU General Public License as published by the Free Software
+// Foundation; either version 2 of the License, or (at your option) any later
+// version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+// details.
+//
+// You should have received a copy of the GNU General Public License along with
+// this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+// Place, Suite 330, Boston, MA  02111-1307  USA
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @file Microbenchmarks of the hot paths of the CBTF libraries.
+ *
+ * Each benchmark is calibrated to find an iteration count taking at least the
+ * minimum time, and is then repeated several times with that count. The median,
+ * minimum, and maximum time per iteration are written as JSON, in the format
+ * used by Google Benchmark, so that results from different releases can be
+ * compared with the usual tools. Usage:
+ *
+ *     cbtf-bench [--filter <text>] [--repetitions <n>] [--min-time <ms>]
+ *                [--output <file>]
+ *
+ * Only benchmarks whose name contains the filter text are run. The JSON is
+ * written to standard output unless an output file is given. Progress goes to
+ * the standard error stream.
+ */
+
+#include <algorithm>
+#include <boost/any.hpp>
+#include <boost/bind.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/function.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/thread.hpp>
+#include <cstddef>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <KrellInstitute/CBTF/BoostExts.hpp>
+#include <KrellInstitute/CBTF/Component.hpp>
+#include <KrellInstitute/CBTF/Impl/Value.hpp>
+#include <KrellInstitute/CBTF/Ports.hpp>
+#include <KrellInstitute/CBTF/Type.hpp>
+#include <KrellInstitute/CBTF/ValueSink.hpp>
+#include <KrellInstitute/CBTF/ValueSource.hpp>
+#include <KrellInstitute/CBTF/Version.hpp>
+#include <stdexcept>
+#include <string>
+#include <time.h>
+#include <typeinfo>
+#include <vector>
+
+#if defined(CBTF_BENCH_XML)
+#include <KrellInstitute/CBTF/XML.hpp>
+#endif
+
+#if defined(CBTF_BENCH_MRNET)
+#include <KrellInstitute/CBTF/XDR.hpp>
+#include "TestMessage.h"
+#endif
+
+#include "ResolvePath.hpp"
+
+using namespace KrellInstitute::CBTF;
+
+
+
+/** Anonymous namespace hiding implementation details. */
+namespace {
+
+    /**
+     * Type of function running a benchmark. It is given the number of
+     * iterations to run, and returns the time (in nanoseconds) they took.
+     * Any setup and teardown is done outside of the timed region.
+     */
+    typedef boost::function<double (const std::size_t&)> Function;
+
+    /** Benchmark. */
+    struct Benchmark
+    {
+        /** Name of the benchmark. */
+        std::string dm_name;
+
+        /** Function running the benchmark. */
+        Function dm_function;
+    };
+
+    /** Result of a benchmark. */
+    struct Result
+    {
+        /** Name of the benchmark. */
+        std::string dm_name;
+
+        /** Number of iterations in each repetition. */
+        std::size_t dm_iterations;
+
+        /** Time (in nanoseconds) per iteration of each repetition. */
+        std::vector<double> dm_times;
+    };
+
+    /** Get the current value of the monotonic clock in nanoseconds. */
+    double now()
+    {
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return static_cast<double>(ts.tv_sec) * 1.0e9 + ts.tv_nsec;
+    }
+
+    /** Sink for results that must not be optimized away. */
+    volatile std::size_t the_escape = 0;
+
+    /** Keep the given value from being optimized away. */
+    template <typename T>
+    void escape(const T& value)
+    {
+        the_escape += static_cast<std::size_t>(value);
+    }
+
+    /**
+     * Component that emits values of the template-specified type
+     * in all of the different ways supported by Component.
+     */
+    template <typename T>
+    class Emitter :
+        public Component
+    {
+
+    public:
+
+        /** Enumeration of the different ways values can be emitted. */
+        enum Mode { kAny, kBorrowed, kMoved, kShared, kPort };
+
+        /** Construct an emitter of the given value. */
+        Emitter(const T& value) :
+            Component(Type::of<Emitter>(), Version(0, 0, 0)),
+            dm_value(value)
+        {
+            dm_out = declareOutput<T>("out");
+        }
+
+        /** Emit the value the specified number of times in the given manner. */
+        void run(const Mode& mode, const std::size_t& iterations)
+        {
+            for (std::size_t i = 0; i < iterations; ++i)
+            {
+                switch (mode)
+                {
+                case kAny:
+                    emitOutput("out", Type::of<T>(), boost::any(dm_value));
+                    break;
+                case kBorrowed:
+                    emitOutput<T>("out", dm_value);
+                    break;
+                case kMoved:
+                    emitOutput("out", T(dm_value));
+                    break;
+                case kShared:
+                    emitOutputShared<T>(
+                        "out", boost::shared_ptr<const T>(new T(dm_value))
+                        );
+                    break;
+                case kPort:
+                    emitOutput(dm_out, dm_value);
+                    break;
+                }
+            }
+        }
+
+    private:
+
+        /** Value being emitted. */
+        const T dm_value;
+
+        /** Handle of the "out" output. */
+        Component::OutputPort<T> dm_out;
+
+    }; // class Emitter<T>
+
+    /**
+     * Component that receives values of the template-specified type, either
+     * inspecting them during the emission or retaining them for later use.
+     */
+    template <typename T>
+    class Receiver :
+        public Component
+    {
+
+    public:
+
+        /** Construct a receiver. */
+        Receiver(const bool& retain) :
+            Component(Type::of<Receiver>(), Version(0, 0, 0)),
+            dm_retain(retain),
+            dm_value(),
+            dm_inspected(NULL)
+        {
+            declareInput(
+                "in", Type::of<T>(), boost::bind(&Receiver::inHandler, this, _1)
+                );
+        }
+
+    private:
+
+        /** Handler for the "in" input. */
+        void inHandler(const Impl::Value& value)
+        {
+            if (dm_retain)
+            {
+                dm_value = value.retain();
+            }
+            else
+            {
+                dm_inspected = value.get<T>();
+            }
+        }
+
+        /** Flag indicating if values are retained. */
+        const bool dm_retain;
+
+        /** Last value retained by this receiver. */
+        Impl::Value dm_value;
+
+        /** Last value inspected by this receiver. */
+        const T* volatile dm_inspected;
+
+    }; // class Receiver<T>
+
+    /** Emit values to the given number of receivers. */
+    template <typename T>
+    double emit(const T& value, const typename Emitter<T>::Mode& mode,
+                const std::size_t& fan_out, const bool& retain,
+                const std::size_t& iterations)
+    {
+        boost::shared_ptr<Emitter<T> > emitter(new Emitter<T>(value));
+        Component::Instance emitter_instance =
+            boost::reinterpret_pointer_cast<Component>(emitter);
+
+        std::vector<Component::Instance> receivers;
+        for (std::size_t i = 0; i < fan_out; ++i)
+        {
+            receivers.push_back(Component::Instance(
+                reinterpret_cast<Component*>(new Receiver<T>(retain))
+                ));
+            Component::connect(emitter_instance, "out", receivers.back(), "in");
+        }
+
+        double start = now();
+        emitter->run(mode, iterations);
+        return now() - start;
+    }
+
+    /** Instantiate the given component type. */
+    double instantiate(const Type& type, const std::size_t& iterations)
+    {
+        double start = now();
+        for (std::size_t i = 0; i < iterations; ++i)
+        {
+            Component::Instance instance = Component::instantiate(type);
+            escape(instance.use_count());
+        }
+        return now() - start;
+    }
+
+    /** Connect and then disconnect two components of the test plugin. */
+    double connectDisconnect(const std::size_t& iterations)
+    {
+        Component::Instance b = Component::instantiate(Type("TestComponentB"));
+        Component::Instance c = Component::instantiate(Type("TestComponentC"));
+
+        double start = now();
+        for (std::size_t i = 0; i < iterations; ++i)
+        {
+            Component::connect(b, "half", c, "in");
+            Component::disconnect(b, "half", c, "in");
+        }
+        return now() - start;
+    }
+
+    /** Pass values through a chain of components from the test plugin. */
+    double chain(const std::size_t& length, const std::size_t& iterations)
+    {
+        boost::shared_ptr<ValueSource<int> > source =
+            ValueSource<int>::instantiate();
+        boost::shared_ptr<ValueSink<int> > sink =
+            ValueSink<int>::instantiate();
+
+        std::vector<Component::Instance> stages;
+        Component::Instance previous =
+            boost::reinterpret_pointer_cast<Component>(source);
+        std::string previous_output = "value";
+        for (std::size_t i = 0; i < length; ++i)
+        {
+            stages.push_back(Component::instantiate(Type("TestComponentC")));
+            Component::connect(previous, previous_output, stages.back(), "in");
+            previous = stages.back();
+            previous_output = "incremented";
+        }
+        Component::connect(previous, previous_output,
+                           boost::reinterpret_pointer_cast<Component>(sink),
+                           "value");
+
+        double start = now();
+        for (std::size_t i = 0; i < iterations; ++i)
+        {
+            *source = static_cast<int>(i);
+            int value = *sink;
+            escape(value);
+        }
+        return now() - start;
+    }
+
+    /** Component with statically typed ports that decrements its values. */
+    class TypedStage :
+        public Component
+    {
+
+    public:
+
+        /** Construct a stage. */
+        TypedStage() :
+            Component(Type::of<TypedStage>(), Version(0, 0, 0)),
+            dm_in(this, "in", &TypedStage::inHandler),
+            dm_out(this, "out")
+        {
+        }
+
+        /** The "in" input. */
+        Input<int> dm_in;
+
+        /** The "out" output. */
+        Output<int> dm_out;
+
+    private:
+
+        /** Handler for the "in" input. */
+        void inHandler(const int& in)
+        {
+            dm_out(in - 1);
+        }
+
+    }; // class TypedStage
+
+    /** Pass values through a chain of directly connected typed components. */
+    double typedChain(const std::size_t& length, const std::size_t& iterations)
+    {
+        std::vector<boost::shared_ptr<TypedStage> > stages;
+        for (std::size_t i = 0; i <= length; ++i)
+        {
+            stages.push_back(boost::shared_ptr<TypedStage>(new TypedStage()));
+            if (i > 0)
+            {
+                stages[i - 1]->dm_out.connect(stages[i]->dm_in);
+            }
+        }
+
+        double start = now();
+        for (std::size_t i = 0; i < iterations; ++i)
+        {
+            stages.front()->dm_out(static_cast<int>(i));
+        }
+        return now() - start;
+    }
+
+    /** Construct types from a name. */
+    double typeFromName(const std::size_t& iterations)
+    {
+        const std::string name("KrellInstitute::CBTF::ValueSink<int>");
+
+        double start = now();
+        for (std::size_t i = 0; i < iterations; ++i)
+        {
+            Type type(name);
+            escape(type == Type::of<int>());
+        }
+        return now() - start;
+    }
+
+    /** Construct types from run-time type information. */
+    double typeFromTypeInfo(const std::size_t& iterations)
+    {
+        double start = now();
+        for (std::size_t i = 0; i < iterations; ++i)
+        {
+            Type type(typeid(ValueSink<int>));
+            escape(type == Type::of<int>());
+        }
+        return now() - start;
+    }
+
+    /** Compare types. */
+    double typeCompare(const std::size_t& iterations)
+    {
+        const Type a(typeid(ValueSink<int>));
+        const Type b(typeid(ValueSource<int>));
+
+        double start = now();
+        for (std::size_t i = 0; i < iterations; ++i)
+        {
+            escape((a == b) + (a < b) + (b < a));
+        }
+        return now() - start;
+    }
+
+    /** Construct versions from a string. */
+    double versionFromString(const std::size_t& iterations)
+    {
+        const std::string text("1.12.123");
+
+        double start = now();
+        for (std::size_t i = 0; i < iterations; ++i)
+        {
+            Version version(text);
+            escape(version.getMajorNumber());
+        }
+        return now() - start;
+    }
+
+    /** Construct versions from their numbers. */
+    double versionFromNumbers(const std::size_t& iterations)
+    {
+        double start = now();
+        for (std::size_t i = 0; i < iterations; ++i)
+        {
+            Version version(1, 12, static_cast<unsigned int>(i));
+            escape(version.getMajorNumber());
+        }
+        return now() - start;
+    }
+
+    /** Compare versions. */
+    double versionCompare(const std::size_t& iterations)
+    {
+        const Version a(1, 12, 123);
+        const Version b(1, 12, 124);
+
+        double start = now();
+        for (std::size_t i = 0; i < iterations; ++i)
+        {
+            escape((a == b) + (a < b) + (b < a));
+        }
+        return now() - start;
+    }
+
+    /** Pass values through a value sink from the same thread. */
+    double sinkSameThread(const std::size_t& iterations)
+    {
+        boost::shared_ptr<ValueSource<int> > source =
+            ValueSource<int>::instantiate();
+        boost::shared_ptr<ValueSink<int> > sink =
+            ValueSink<int>::instantiate();
+        Component::connect(boost::reinterpret_pointer_cast<Component>(source),
+                           "value",
+                           boost::reinterpret_pointer_cast<Component>(sink),
+                           "value");
+
+        double start = now();
+        for (std::size_t i = 0; i < iterations; ++i)
+        {
+            *source = static_cast<int>(i);
+        }
+        for (std::size_t i = 0; i < iterations; ++i)
+        {
+            int value = *sink;
+            escape(value);
+        }
+        return now() - start;
+    }
+
+    /** Emit the given number of values into a value source. */
+    void produce(boost::shared_ptr<ValueSource<int> > source,
+                 const std::size_t& iterations)
+    {
+        for (std::size_t i = 0; i < iterations; ++i)
+        {
+            *source = static_cast<int>(i);
+        }
+    }
+
+    /** Pass values through a value sink from another thread. */
+    double sinkCrossThread(const std::size_t& iterations)
+    {
+        boost::shared_ptr<ValueSource<int> > source =
+            ValueSource<int>::instantiate();
+        boost::shared_ptr<ValueSink<int> > sink =
+            ValueSink<int>::instantiate();
+        Component::connect(boost::reinterpret_pointer_cast<Component>(source),
+                           "value",
+                           boost::reinterpret_pointer_cast<Component>(sink),
+                           "value");
+
+        double start = now();
+        boost::thread producer(boost::bind(&produce, source, iterations));
+        for (std::size_t i = 0; i < iterations; ++i)
+        {
+            int value = *sink;
+            escape(value);
+        }
+        producer.join();
+        return now() - start;
+    }
+
+#if defined(CBTF_BENCH_XML)
+    /** Register the XML-defined component network used by the unit tests. */
+    double registerTestXML(const std::size_t& iterations)
+    {
+        double start = now();
+        for (std::size_t i = 0; i < iterations; ++i)
+        {
+            registerXML(CBTF_TEST_BINARY_DIR "/test-xml.xml");
+        }
+        return now() - start;
+    }
+#endif
+
+#if defined(CBTF_BENCH_MRNET)
+    /** Round trip messages through the XDR/MRNet conversion components. */
+    double roundTripXDR(const std::size_t& iterations)
+    {
+        typedef boost::shared_ptr<TestMessage> TestMessagePtr;
+
+        boost::shared_ptr<ValueSource<TestMessagePtr> > source =
+            ValueSource<TestMessagePtr>::instantiate();
+        boost::shared_ptr<ValueSink<TestMessagePtr> > sink =
+            ValueSink<TestMessagePtr>::instantiate();
+        Component::Instance xdr_to_mrnet = Component::instantiate(Type(
+            "KrellInstitute::CBTF::ConvertXDRToMRNet<TestMessage>"
+            ));
+        Component::Instance mrnet_to_xdr = Component::instantiate(Type(
+            "KrellInstitute::CBTF::ConvertMRNetToXDR<TestMessage>"
+            ));
+
+        Component::connect(boost::reinterpret_pointer_cast<Component>(source),
+                           "value", xdr_to_mrnet, "in");
+        Component::connect(xdr_to_mrnet, "out", mrnet_to_xdr, "in");
+        Component::connect(mrnet_to_xdr, "out",
+                           boost::reinterpret_pointer_cast<Component>(sink),
+                           "value");
+
+        TestMessagePtr message(new TestMessage());
+
+        double start = now();
+        for (std::size_t i = 0; i < iterations; ++i)
+        {
+            message->x = static_cast<int>(i);
+            *source = message;
+            TestMessagePtr output = *sink;
+            escape(output->x);
+        }
+        return now() - start;
+    }
+#endif
+
+    /** Get all of the benchmarks. */
+    std::vector<Benchmark> getBenchmarks()
+    {
+        static const char* const kModes[] = {
+            "any", "borrowed", "moved", "shared", "port"
+        };
+        static const std::size_t kFanOuts[] = { 0, 1, 4, 16 };
+
+        std::vector<Benchmark> benchmarks;
+
+#define BENCHMARK(name, function) \
+        { \
+            Benchmark benchmark = { name, function }; \
+            benchmarks.push_back(benchmark); \
+        }
+
+        for (std::size_t i = 0; i < sizeof(kFanOuts) / sizeof(kFanOuts[0]); ++i)
+        {
+            const std::string fan_out =
+                boost::lexical_cast<std::string>(kFanOuts[i]);
+            BENCHMARK("emitOutput/fan-out:" + fan_out,
+                      boost::bind(&emit<int>, 42, Emitter<int>::kPort,
+                                  kFanOuts[i], false, _1));
+        }
+
+        for (int retain = 0; retain < 2; ++retain)
+        {
+            for (int m = Emitter<int>::kAny; m <= Emitter<int>::kShared; ++m)
+            {
+                const std::string suffix = std::string(kModes[m]) + "/" +
+                    (retain ? "retained" : "inspected");
+                const Emitter<int>::Mode mode =
+                    static_cast<Emitter<int>::Mode>(m);
+                BENCHMARK("emitOutput/int/" + suffix,
+                          boost::bind(&emit<int>, 42, mode, 4,
+                                      retain != 0, _1));
+                BENCHMARK("emitOutput/vector<double>/" + suffix,
+                          boost::bind(&emit<std::vector<double> >,
+                                      std::vector<double>(8192, 1.0),
+                                      static_cast<Emitter<
+                                          std::vector<double> >::Mode>(m),
+                                      4, retain != 0, _1));
+            }
+        }
+
+        BENCHMARK("emitOutput/chain:1", boost::bind(&chain, 1, _1));
+        BENCHMARK("emitOutput/chain:8", boost::bind(&chain, 8, _1));
+        BENCHMARK("emitOutput/typed-chain:1", boost::bind(&typedChain, 1, _1));
+        BENCHMARK("emitOutput/typed-chain:8", boost::bind(&typedChain, 8, _1));
+        BENCHMARK("instantiate/TestComponentB",
+                  boost::bind(&instantiate, Type("TestComponentB"), _1));
+        BENCHMARK("connect+disconnect", &connectDisconnect);
+        BENCHMARK("Type/construct/name", &typeFromName);
+        BENCHMARK("Type/construct/type_info", &typeFromTypeInfo);
+        BENCHMARK("Type/compare", &typeCompare);
+        BENCHMARK("Version/construct/string", &versionFromString);
+        BENCHMARK("Version/construct/numbers", &versionFromNumbers);
+        BENCHMARK("Version/compare", &versionCompare);
+        BENCHMARK("ValueSink/same-thread", &sinkSameThread);
+        BENCHMARK("ValueSink/cross-thread", &sinkCrossThread);
+
+#if defined(CBTF_BENCH_XML)
+        BENCHMARK("registerXML/test-xml.xml", &registerTestXML);
+        BENCHMARK("instantiate/TestXML",
+                  boost::bind(&instantiate, Type("TestXML"), _1));
+#endif
+
+#if defined(CBTF_BENCH_MRNET)
+        BENCHMARK("XDR/round-trip", &roundTripXDR);
+#endif
+
+#undef BENCHMARK
+
+        return benchmarks;
+    }
+
+    /**
+     * Run a benchmark. The iteration count is increased tenfold, starting from
+     * one, until a run takes at least the minimum time. The benchmark is then
+     * repeated with that iteration count.
+     */
+    Result run(const Benchmark& benchmark, const std::size_t& repetitions,
+               const double& min_time)
+    {
+        Result result = { benchmark.dm_name, 1, std::vector<double>() };
+
+        while ((benchmark.dm_function(result.dm_iterations) < min_time) &&
+               (result.dm_iterations < 1000000000))
+        {
+            result.dm_iterations *= 10;
+        }
+
+        for (std::size_t i = 0; i < repetitions; ++i)
+        {
+            result.dm_times.push_back(
+                benchmark.dm_function(result.dm_iterations) /
+                result.dm_iterations
+                );
+        }
+
+        return result;
+    }
+
+    /** Write the results as JSON in the format used by Google Benchmark. */
+    void write(std::ostream& stream, const std::vector<Result>& results)
+    {
+        char date[64] = "";
+        time_t seconds = time(NULL);
+        struct tm local;
+        strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S%z",
+                 localtime_r(&seconds, &local));
+
+        stream << "{" << std::endl
+               << "  \"context\": {" << std::endl
+               << "    \"date\": \"" << date << "\"," << std::endl
+               << "    \"executable\": \"cbtf-bench\"," << std::endl
+               << "    \"num_cpus\": " << boost::thread::hardware_concurrency()
+               << std::endl
+               << "  }," << std::endl
+               << "  \"benchmarks\": [";
+
+        for (std::vector<Result>::const_iterator
+                 i = results.begin(); i != results.end(); ++i)
+        {
+            std::vector<double> times(i->dm_times);
+            std::sort(times.begin(), times.end());
+
+            stream << ((i == results.begin()) ? "" : ",") << std::endl
+                   << "    {" << std::endl
+                   << "      \"name\": \"" << i->dm_name << "\"," << std::endl
+                   << "      \"iterations\": " << i->dm_iterations << ","
+                   << std::endl
+                   << "      \"repetitions\": " << times.size() << ","
+                   << std::endl
+                   << std::fixed << std::setprecision(3)
+                   << "      \"real_time\": " << times[times.size() / 2] << ","
+                   << std::endl
+                   << "      \"min_time\": " << times.front() << ","
+                   << std::endl
+                   << "      \"max_time\": " << times.back() << ","
+                   << std::endl
+                   << "      \"time_unit\": \"ns\"" << std::endl
+                   << "    }";
+        }
+
+        stream << std::endl << "  ]" << std::endl << "}" << std::endl;
+    }
+
+} // namespace <anonymous>
+
+
+
+/** Main entry point of the benchmark. */
+int main(int argc, char* argv[])
+{
+    std::string filter;
+    std::size_t repetitions = 5;
+    double min_time = 10.0e6;
+    std::string output;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string argument(argv[i]);
+        const bool has_value = (i + 1) < argc;
+        if (has_value && (argument == "--filter"))
+        {
+            filter = argv[++i];
+        }
+        else if (has_value && (argument == "--repetitions"))
+        {
+            repetitions = std::max<std::size_t>(
+                boost::lexical_cast<std::size_t>(argv[++i]), 1
+                );
+        }
+        else if (has_value && (argument == "--min-time"))
+        {
+            min_time = boost::lexical_cast<double>(argv[++i]) * 1.0e6;
+        }
+        else if (has_value && (argument == "--output"))
+        {
+            output = argv[++i];
+        }
+        else
+        {
+            std::cerr << "Usage: " << argv[0] << " [--filter <text>] "
+                      << "[--repetitions <n>] [--min-time <ms>] "
+                      << "[--output <file>]" << std::endl;
+            return 1;
+        }
+    }
+
+    Impl::prependToSearchPath(Impl::kPluginFileType, CBTF_TEST_BINARY_DIR);
+    Component::registerPlugin("plugin.so");
+
+    std::vector<Benchmark> benchmarks = getBenchmarks();
+    std::vector<Result> results;
+    for (std::vector<Benchmark>::const_iterator
+             i = benchmarks.begin(); i != benchmarks.end(); ++i)
+    {
+        if (i->dm_name.find(filter) == std::string::npos)
+        {
+            continue;
+        }
+
+        results.push_back(run(*i, repetitions, min_time));
+
+        std::vector<double> times(results.back().dm_times);
+        std::sort(times.begin(), times.end());
+        std::cerr << std::setw(56) << std::left << i->dm_name
+                  << std::setw(14) << std::right << std::fixed
+                  << std::setprecision(1) << times[times.size() / 2]
+                  << " ns" << std::endl;
+    }
+
+    if (output.empty())
+    {
+        write(std::cout, results);
+    }
+    else
+    {
+        std::ofstream stream(output.c_str());
+        write(stream, results);
+    }
+
+    return 0;
+}
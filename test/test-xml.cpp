@@ -18,9 +18,18 @@
 
 /** @file Unit tests for the CBTF XML library. */
 
+#include <boost/algorithm/string/join.hpp>
+#include <boost/bind.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/filesystem/fstream.hpp>
+#include <boost/ref.hpp>
 #include <boost/shared_ptr.hpp>
 #include <boost/test/unit_test.hpp>
+#include <boost/thread.hpp>
+#include <cstdlib>
 #include <iostream>
+#include <iterator>
 #include <KrellInstitute/CBTF/BoostExts.hpp>
 #include <KrellInstitute/CBTF/Component.hpp>
 #include <KrellInstitute/CBTF/Type.hpp>
@@ -32,6 +41,9 @@
 #include <set>
 #include <stdexcept>
 #include <string>
+#include <vector>
+
+#include "XercesExts.hpp"
 
 using namespace KrellInstitute::CBTF;
 
@@ -94,4 +106,317 @@ BOOST_AUTO_TEST_CASE(TestXML)
     *input_value = 10;
     int the_output_value = *output_value;
     BOOST_CHECK_EQUAL(the_output_value, 42);
+
+    // Test instantiation of a second, independent network from the same plan
+    Component::Instance second_network;
+    BOOST_CHECK_NO_THROW(
+        second_network = Component::instantiate(Type("TestXML"))
+        );
+    BOOST_REQUIRE(second_network);
+    BOOST_CHECK(second_network != network);
+    BOOST_CHECK_EQUAL(second_network->getVersion(), Version(1, 2, 3));
+    boost::shared_ptr<ValueSource<int> > second_input_value =
+        ValueSource<int>::instantiate();
+    boost::shared_ptr<ValueSink<int> > second_output_value = 
+        ValueSink<int>::instantiate();
+    Component::connect(
+        boost::reinterpret_pointer_cast<Component>(second_input_value),
+        "value", second_network, "in"
+        );
+    Component::connect(
+        second_network, "out",
+        boost::reinterpret_pointer_cast<Component>(second_output_value),
+        "value"
+        );
+    *second_input_value = 5;
+    int the_second_output_value = *second_output_value;
+    BOOST_CHECK_EQUAL(the_second_output_value, 22);
+    *input_value = 20;
+    the_output_value = *output_value;
+    BOOST_CHECK_EQUAL(the_output_value, 82);
+    BOOST_CHECK(!output_value->tryGet(the_output_value));
+    BOOST_CHECK(!second_output_value->tryGet(the_second_output_value));
+}
+
+
+
+/**
+ * Unit test for the parallel instantiation of the components of XML-defined
+ * component networks. Relies upon TestXML having registered "test-xml.xml".
+ */
+BOOST_AUTO_TEST_CASE(TestXMLParallel)
+{
+    std::set<Type> available_types = Component::getAvailableTypes();
+    BOOST_REQUIRE_NE(available_types.find(Type("TestXML")),
+                     available_types.end());
+    
+    BOOST_REQUIRE_EQUAL(setenv("CBTF_NETWORK_PARALLEL", "1", 1), 0);
+
+    // Test several networks whose components were instantiated in parallel
+    for (int i = 0; i < 8; ++i)
+    {
+        Component::Instance network;
+        BOOST_CHECK_NO_THROW(network = Component::instantiate(Type("TestXML")));
+        BOOST_REQUIRE(network);
+        BOOST_CHECK_EQUAL(network->getVersion(), Version(1, 2, 3));
+        
+        boost::shared_ptr<ValueSource<int> > input_value =
+            ValueSource<int>::instantiate();
+        boost::shared_ptr<ValueSink<int> > output_value = 
+            ValueSink<int>::instantiate();
+        Component::connect(
+            boost::reinterpret_pointer_cast<Component>(input_value),
+            "value", network, "in"
+            );
+        Component::connect(
+            network, "out",
+            boost::reinterpret_pointer_cast<Component>(output_value),
+            "value"
+            );
+        *input_value = i;
+        int the_output_value = *output_value;
+        BOOST_CHECK_EQUAL(the_output_value, (i * 2 + 1) * 2);
+    }
+    
+    BOOST_REQUIRE_EQUAL(unsetenv("CBTF_NETWORK_PARALLEL"), 0);
+}
+
+
+
+/** Append the value of a selected node to a list of values. */
+void appendValue(const xercesc::DOMNode* node,
+                 std::vector<std::string>& values)
+{
+    values.push_back(xercesc::selectValue(node, "."));
+}
+
+
+
+/** Select nodes and return their values, in order, separated by commas. */
+std::string selectValues(const xercesc::DOMNode* root,
+                         const std::string& expression)
+{
+    std::vector<std::string> values;
+    xercesc::selectNodes(
+        root, expression, boost::bind(&appendValue, _1, boost::ref(values))
+        );
+    return boost::algorithm::join(values, ",");
+}
+
+
+
+/**
+ * Unit test for the XPath selectors of the Xerces-C++ extensions.
+ */
+BOOST_AUTO_TEST_CASE(TestSelectors)
+{
+    boost::shared_ptr<xercesc::DOMDocument> document = xercesc::loadFromString(
+        "<a>"
+        "<b id=\"1\">one</b>"
+        "<c><b id=\"2\">two</b><d><b id=\"4\">four</b></d></c>"
+        "<b id=\"3\">three</b>"
+        "</a>"
+        );
+    BOOST_REQUIRE(document);
+    
+    // Test that nodes are selected in document order
+    BOOST_CHECK_EQUAL(selectValues(document.get(), "./a/b"), "one,three");
+    BOOST_CHECK_EQUAL(selectValues(document.get(), "./a/*"), "one,,three");
+    BOOST_CHECK_EQUAL(selectValues(document.get(), "./a/c/b/../../b"),
+                      "one,three");
+
+    // Test that nodes reached more than once are selected only once
+    std::vector<std::string> values;
+    xercesc::selectNodes(document.get(), "./a/*/..",
+                         boost::bind(&appendValue, _1, boost::ref(values)));
+    BOOST_CHECK_EQUAL(values.size(), 1u);
+    BOOST_CHECK_EQUAL(selectValues(document.get(), "./a/*/..//b"),
+                      "one,two,three");
+
+    // Test that "//" selects the current node and its children, but not
+    // their descendants
+    BOOST_CHECK_EQUAL(selectValues(document.get(), "./a//b"), "one,two,three");
+    BOOST_CHECK_EQUAL(selectValues(document.get(), "/ a / c // b"), "two,four");
+
+    // Test selection of attributes
+    BOOST_CHECK_EQUAL(selectValues(document.get(), "./a/b/@id"), "1,3");
+    BOOST_CHECK_EQUAL(xercesc::selectValue(document.get(), "./a/c/b/@id"), "2");
+    BOOST_CHECK_EQUAL(xercesc::selectValue(document.get(), "./a/@id"), "");
+    BOOST_CHECK_EQUAL(xercesc::selectValue(document.get(), "./a/c/e"), "");
+
+    // Test selection from an element rather than the document
+    const xercesc::DOMNode* c = document->getDocumentElement()->getFirstChild()
+        ->getNextSibling();
+    BOOST_CHECK_EQUAL(selectValues(c, "./b"), "two");
+    BOOST_CHECK_EQUAL(selectValues(c, "/b"), "one,three");
+    
+    // Test that selecting the parent of the document fails
+    BOOST_CHECK_THROW(xercesc::selectValue(document.get(), ".."),
+                      std::runtime_error);
+    BOOST_CHECK_THROW(selectValues(document.get(), "./a/../.."),
+                      std::runtime_error);
+}
+
+
+
+/** Read the entire contents of the specified file. */
+std::string readFile(const boost::filesystem::path& path)
+{
+    boost::filesystem::ifstream stream(path, std::ios::in | std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(stream),
+                       std::istreambuf_iterator<char>());
+}
+
+
+
+/** Replace the contents of the specified file. */
+void writeFile(const boost::filesystem::path& path, const std::string& contents)
+{
+    boost::filesystem::ofstream stream(
+        path, std::ios::out | std::ios::binary | std::ios::trunc
+        );
+    stream.write(contents.data(), contents.size());
+}
+
+
+
+/**
+ * Unit test for the binary form of documents used by the XML cache.
+ */
+BOOST_AUTO_TEST_CASE(TestBinaryDocuments)
+{
+    const boost::filesystem::path directory =
+        boost::filesystem::temp_directory_path() /
+        boost::filesystem::unique_path();
+    BOOST_REQUIRE(boost::filesystem::create_directory(directory));
+    const boost::filesystem::path path = directory / "document.dom";
+    const boost::uint64_t key = 0x0123456789ABCDEFULL;
+    
+    // Test that documents are unchanged by saving and loading their binary form
+    const char* const kDocuments[] = {
+        CBTF_TEST_SOURCE_DIR "/test-xml.xml",
+        CBTF_TEST_SOURCE_DIR "/test-mrnet.xml"
+    };
+    for (std::size_t i = 0; i < sizeof(kDocuments) / sizeof(kDocuments[0]); ++i)
+    {
+        boost::shared_ptr<xercesc::DOMDocument> document =
+            xercesc::loadFromFile(kDocuments[i]);
+        BOOST_REQUIRE(document);
+        BOOST_REQUIRE_NO_THROW(
+            xercesc::saveToBinary(document.get(), path, key)
+            );
+        boost::shared_ptr<xercesc::DOMDocument> loaded =
+            xercesc::loadFromBinary(path, key);
+        BOOST_REQUIRE(loaded);
+        BOOST_CHECK_EQUAL(
+            xercesc::saveToString(loaded->getDocumentElement()),
+            xercesc::saveToString(document->getDocumentElement())
+            );
+    }
+    const std::string contents = readFile(path);
+    BOOST_REQUIRE(!contents.empty());
+    
+    // Test that a missing file, or one saved with another key, isn't loaded
+    BOOST_CHECK(!xercesc::loadFromBinary(directory / "missing.dom", key));
+    BOOST_CHECK(!xercesc::loadFromBinary(path, key + 1));
+    
+    // Test that truncated files aren't loaded
+    for (std::string::size_type size = 0;
+         size < contents.size();
+         size += (size < 64) ? 1 : 61)
+    {
+        writeFile(path, contents.substr(0, size));
+        BOOST_CHECK(!xercesc::loadFromBinary(path, key));
+    }
+    
+    // Test that garbage files aren't loaded
+    writeFile(path, std::string(contents.size(), '\x5A'));
+    BOOST_CHECK(!xercesc::loadFromBinary(path, key));
+    std::string corrupted(contents);
+    for (std::string::size_type i = 24 /* Magic and header */;
+         i < corrupted.size();
+         ++i)
+    {
+        corrupted[i] ^= 0x5A;
+    }
+    writeFile(path, corrupted);
+    BOOST_CHECK(!xercesc::loadFromBinary(path, key));
+    writeFile(path, contents + '\0');
+    BOOST_CHECK(!xercesc::loadFromBinary(path, key));
+
+    // Test that the intact file is still loaded
+    writeFile(path, contents);
+    BOOST_CHECK(xercesc::loadFromBinary(path, key));
+
+    boost::filesystem::remove_all(directory);
+}
+
+
+
+/**
+ * Load the specified document, validating it against the network schema,
+ * and get the type of the network it describes. Any error is returned in
+ * place of the type.
+ */
+void loadNetworkType(const std::string& path, std::string& type)
+{
+    try
+    {
+        const std::vector<boost::filesystem::path> schema_paths(
+            1, CBTF_XML_SOURCE_DIR "/Network.xsd"
+            );
+        boost::shared_ptr<xercesc::DOMDocument> document =
+            xercesc::loadFromFile(path, schema_paths);
+        type = xercesc::selectValue(document.get(), "./*/Type");
+    }
+    catch (const std::exception& error)
+    {
+        type = error.what();
+    }
+}
+
+
+
+/**
+ * Unit test for the schema grammar pool shared by all parsers.
+ */
+BOOST_AUTO_TEST_CASE(TestGrammarPool)
+{
+    const std::string kXML = CBTF_TEST_SOURCE_DIR "/test-xml.xml";
+    const std::string kMRNet = CBTF_TEST_SOURCE_DIR "/test-mrnet.xml";
+
+    // Test loading of two documents sharing a schema, one after the other
+    std::string xml_type, mrnet_type;
+    loadNetworkType(kXML, xml_type);
+    loadNetworkType(kMRNet, mrnet_type);
+    BOOST_CHECK_EQUAL(xml_type, "TestXML");
+    BOOST_CHECK_EQUAL(mrnet_type, "TestMRNet");
+    loadNetworkType(kXML, xml_type);
+    BOOST_CHECK_EQUAL(xml_type, "TestXML");
+
+    // Test loading of the same documents from two threads at once
+    for (int i = 0; i < 16; ++i)
+    {
+        xml_type.clear();
+        mrnet_type.clear();
+        boost::thread xml_thread(
+            boost::bind(&loadNetworkType, kXML, boost::ref(xml_type))
+            );
+        boost::thread mrnet_thread(
+            boost::bind(&loadNetworkType, kMRNet, boost::ref(mrnet_type))
+            );
+        xml_thread.join();
+        mrnet_thread.join();
+        BOOST_CHECK_EQUAL(xml_type, "TestXML");
+        BOOST_CHECK_EQUAL(mrnet_type, "TestMRNet");
+    }
+    
+    // Test that a missing schema is still reported once the pool is in use
+    BOOST_CHECK_THROW(
+        xercesc::loadFromFile(
+            kXML,
+            std::vector<boost::filesystem::path>(1, "non_existent_file.xsd")
+            ),
+        std::runtime_error
+        );
 }
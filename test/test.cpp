@@ -18,23 +18,43 @@
 
 /** @file Unit tests for the CBTF library. */
 
+#include <boost/any.hpp>
+#include <boost/atomic.hpp>
 #include <boost/bind.hpp>
 #include <boost/filesystem.hpp>
+#include <boost/filesystem/fstream.hpp>
+#include <boost/function.hpp>
 #include <boost/shared_ptr.hpp>
+#include <boost/range/iterator_range.hpp>
+#include <boost/ref.hpp>
 #include <boost/test/unit_test.hpp>
+#include <boost/thread/barrier.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/weak_ptr.hpp>
+#include <cstdlib>
+#include <dlfcn.h>
 #include <iostream>
+#include <iterator>
 #include <KrellInstitute/CBTF/BoostExts.hpp>
 #include <KrellInstitute/CBTF/Component.hpp>
+#include <KrellInstitute/CBTF/Impl/Value.hpp>
+#include <KrellInstitute/CBTF/Ports.hpp>
 #include <KrellInstitute/CBTF/SignalAdapter.hpp>
+#include <KrellInstitute/CBTF/Trace.hpp>
 #include <KrellInstitute/CBTF/Type.hpp>
 #include <KrellInstitute/CBTF/ValueSink.hpp>
 #include <KrellInstitute/CBTF/ValueSource.hpp>
 #include <KrellInstitute/CBTF/Version.hpp>
 #include <map>
 #include <set>
+#include <sstream>
 #include <stdexcept>
 #include <string>
 #include <typeinfo>
+#include <vector>
+
+#include "Arena.hpp"
+#include "ResolvePath.hpp"
 
 using namespace KrellInstitute::CBTF;
 
@@ -120,6 +140,13 @@ BOOST_AUTO_TEST_CASE(TestType)
     another_type = type_of_z;
     BOOST_CHECK_NE(another_type, type_of_x);
     BOOST_CHECK_EQUAL(another_type, type_of_z);
+
+    // Test type interning
+    BOOST_CHECK_EQUAL(Type::of<int>(), type_of_x);
+    BOOST_CHECK_EQUAL(Type("int"), type_of_x);
+    BOOST_CHECK_EQUAL(Type(std::string("My") + "Class"), type_of_MyClass);
+    BOOST_CHECK(!(type_of_x < type_of_y) && !(type_of_y < type_of_x));
+    BOOST_CHECK((type_of_x < type_of_z) != (type_of_z < type_of_x));
 }
 
 
@@ -177,6 +204,63 @@ BOOST_AUTO_TEST_CASE(TestVersion)
 
 
 
+/**
+ * Handler used by the unit test for the Value class.
+ */
+void checkAnyIsFive(const boost::any& value)
+{
+    BOOST_CHECK_EQUAL(boost::any_cast<int>(value), 5);
+}
+
+
+
+/**
+ * Unit test for the Value class.
+ */
+BOOST_AUTO_TEST_CASE(TestValue)
+{
+    // Test construction of an empty value
+    BOOST_CHECK(Impl::Value().empty());
+    
+    // Test borrowing and retaining a large object
+    std::vector<int> object(16, 7);
+    Impl::Value borrowed = Impl::Value::borrow(object);
+    BOOST_CHECK_EQUAL(borrowed.get<std::vector<int> >(), &object);
+    Impl::Value first = borrowed.retain();
+    BOOST_CHECK_NE(first.get<std::vector<int> >(), &object);
+    BOOST_CHECK(*first.get<std::vector<int> >() == object);
+    Impl::Value second = borrowed.retain();
+    BOOST_CHECK_EQUAL(first.get<std::vector<int> >(),
+                      second.get<std::vector<int> >());
+
+    // Test borrowing and retaining a small object
+    int x = 5;
+    Impl::Value small = Impl::Value::borrow(x).retain();
+    x = 6;
+    BOOST_CHECK_EQUAL(*small.get<int>(), 5);
+    Impl::Value copy = small;
+    BOOST_CHECK_EQUAL(*copy.get<int>(), 5);
+
+    // Test sharing an object
+    boost::shared_ptr<const std::vector<int> > shared(
+        new std::vector<int>(object)
+        );
+    Impl::Value value_of_shared = Impl::Value::share(shared);
+    BOOST_CHECK_EQUAL(value_of_shared.retain().get<std::vector<int> >(),
+                      shared.get());
+
+    // Test conversion to and from boost::any
+    boost::any any(x);
+    BOOST_CHECK_EQUAL(*Impl::Value(any).get<int>(), 6);
+    BOOST_CHECK_EQUAL(boost::any_cast<int>(small.toAny()), 5);
+    boost::function<void (const boost::any&)> legacy_handler =
+        boost::bind(&checkAnyIsFive, _1);
+    boost::function<void (const Impl::Value&)> handler = legacy_handler;
+    handler(small);
+}
+
+
+
 /**
  * Component type used by the unit test for the Component class.
  */
@@ -263,6 +347,86 @@ KRELL_INSTITUTE_CBTF_REGISTER_FACTORY_FUNCTION(TestComponentC)
 
 
 
+/**
+ * Component type, registered along with its descriptor, used by the unit test
+ * for the Component class.
+ */
+class __attribute__ ((visibility ("hidden"))) TestComponentE :
+    public Component
+{
+
+public:
+
+    /** Number of instances of this component type constructed so far. */
+    static boost::atomic<int> instances;
+
+    /** Optional barrier at which each new instance waits for another. */
+    static boost::barrier* rendezvous;
+
+    /** Number of values received by all instances so far. */
+    static boost::atomic<int> received;
+
+    /** Number of times an instance has been reset so far. */
+    static boost::atomic<int> resets;
+
+    /** Register this component type without instantiating it. */
+    static void registerDescribed()
+    {
+        Component::Descriptor descriptor(
+            Type(typeid(TestComponentE)), Version(1, 0, 0)
+            );
+        descriptor.dm_inputs.insert("in");
+        Component::registerFactoryFunction(
+            descriptor, &TestComponentE::factoryFunction
+            );
+    }
+
+    /** Factory function for this component type. */
+    static Component::Instance factoryFunction()
+    {
+        return Component::Instance(
+            reinterpret_cast<Component*>(new TestComponentE())
+            );
+    }
+
+private:
+
+    /** Default constructor. */
+    TestComponentE() :
+        Component(Type(typeid(TestComponentE)), Version(1, 0, 0))
+    {
+        ++instances;
+        if (rendezvous != NULL)
+        {
+            rendezvous->wait();
+        }
+        declareInput<int>(
+            "in", boost::bind(&TestComponentE::inHandler, this, _1)
+            );
+    }
+
+    /** Reset this component so that it can be recycled. */
+    virtual bool reset()
+    {
+        ++resets;
+        return true;
+    }
+    
+    /** Handler for the "in" input. */
+    void inHandler(const int&)
+    {
+        ++received;
+    }
+
+}; // class TestComponentE
+
+boost::atomic<int> TestComponentE::instances(0);
+boost::barrier* TestComponentE::rendezvous = NULL;
+boost::atomic<int> TestComponentE::received(0);
+boost::atomic<int> TestComponentE::resets(0);
+
+
+
 /**
  * Unit test for the Component class.
  */
@@ -284,6 +448,23 @@ BOOST_AUTO_TEST_CASE(TestComponent)
     available_types = Component::getAvailableTypes();
     BOOST_CHECK_NE(available_types.find(Type("TestComponentB")),
                    available_types.end());
+
+    // Test registration of several plugins in parallel
+    std::vector<boost::filesystem::path> plugin_paths;
+    BOOST_CHECK_NO_THROW(Component::registerPlugins(plugin_paths));
+    plugin_paths.push_back("plugin.so");
+    plugin_paths.push_back("ThisPluginDoesNotExist");
+    BOOST_CHECK_THROW(Component::registerPlugins(plugin_paths),
+                      std::runtime_error);
+    
+    // Test lazy loading of plugins having a manifest
+    const std::string plugin_path =
+        std::string(CBTF_TEST_BINARY_DIR) + "/plugin.so";
+    BOOST_CHECK(dlopen(plugin_path.c_str(), RTLD_NOW | RTLD_NOLOAD) == NULL);
+    BOOST_CHECK(
+        Component::getDescriptor(Type("TestComponentB")).dm_outputs.count("half")
+        );
+    BOOST_CHECK(dlopen(plugin_path.c_str(), RTLD_NOW | RTLD_NOLOAD) == NULL);
     
     // Test component instantiation
     BOOST_CHECK_THROW(Component::instantiate(Type(typeid(long))),
@@ -298,6 +479,12 @@ BOOST_AUTO_TEST_CASE(TestComponent)
         instance_of_b = Component::instantiate(Type("TestComponentB"))
         );
     BOOST_REQUIRE(instance_of_b);
+    void* plugin_handle = dlopen(plugin_path.c_str(), RTLD_NOW | RTLD_NOLOAD);
+    BOOST_CHECK(plugin_handle != NULL);
+    if (plugin_handle != NULL)
+    {
+        dlclose(plugin_handle);
+    }
     
     // Test component instance metadata
     BOOST_CHECK(!instance_of_a->getBuildString().empty());
@@ -313,6 +500,70 @@ BOOST_AUTO_TEST_CASE(TestComponent)
     BOOST_CHECK_EQUAL(outputs.find("triple")->second, Type("int"));
     BOOST_REQUIRE_NE(outputs.find("float"), outputs.end());
     BOOST_CHECK_EQUAL(outputs.find("float")->second, Type(typeid(float)));
+
+    // Test sharing of the port schemas between instances
+    Component::Instance another_a =
+        Component::instantiate(Type("TestComponentA"));
+    BOOST_REQUIRE(another_a);
+    BOOST_CHECK_EQUAL(&another_a->getInputs(), &instance_of_a->getInputs());
+    BOOST_CHECK_EQUAL(&another_a->getOutputs(), &instance_of_a->getOutputs());
+    
+    // Test registration along with a descriptor
+    TestComponentE::registerDescribed();
+    TestComponentE::registerDescribed();
+    available_types = Component::getAvailableTypes();
+    BOOST_CHECK_NE(available_types.find(Type("TestComponentE")),
+                   available_types.end());
+    Component::Descriptor descriptor =
+        Component::getDescriptor(Type("TestComponentE"));
+    BOOST_CHECK_EQUAL(descriptor.dm_version, Version(1, 0, 0));
+    BOOST_CHECK_EQUAL(descriptor.dm_inputs.size(), 1);
+    BOOST_CHECK(descriptor.dm_outputs.empty());
+    BOOST_CHECK_EQUAL(TestComponentE::instances, 0);
+    BOOST_CHECK_NO_THROW(Component::instantiate(Type("TestComponentE")));
+    BOOST_CHECK_EQUAL(TestComponentE::instances, 1);
+    descriptor = Component::getDescriptor(Type("TestComponentA"));
+    BOOST_CHECK_EQUAL(descriptor.dm_inputs.size(), 1);
+    BOOST_CHECK_EQUAL(descriptor.dm_outputs.size(), 3);
+    BOOST_CHECK_THROW(Component::getDescriptor(Type("TestComponentE"),
+                                               Version(0, 0, 0)),
+                      std::runtime_error);
+
+    // Test concurrent instantiation, which would deadlock if serialized
+    boost::barrier rendezvous(2);
+    TestComponentE::rendezvous = &rendezvous;
+    boost::thread other(boost::bind(&Component::instantiate,
+                                    Type("TestComponentE"),
+                                    boost::optional<Version>()));
+    BOOST_CHECK_NO_THROW(Component::instantiate(Type("TestComponentE")));
+    other.join();
+    TestComponentE::rendezvous = NULL;
+    BOOST_CHECK_EQUAL(TestComponentE::instances, 3);
+
+    // Test pooling of component instances
+    Component::setPoolCapacity(Type("TestComponentE"), 1);
+    Component::Instance pooled = Component::instantiate(Type("TestComponentE"));
+    const Component* pooled_address = pooled.get();
+    boost::shared_ptr<ValueSource<int> > pooled_value =
+        ValueSource<int>::instantiate();
+    Component::connect(boost::reinterpret_pointer_cast<Component>(pooled_value),
+                       "value", pooled, "in");
+    *pooled_value = 1;
+    BOOST_CHECK_EQUAL(TestComponentE::received, 1);
+    pooled.reset();
+    BOOST_CHECK_EQUAL(TestComponentE::resets, 1);
+    BOOST_CHECK_NO_THROW(*pooled_value = 2);
+    BOOST_CHECK_EQUAL(TestComponentE::received, 1);
+    pooled = Component::instantiate(Type("TestComponentE"));
+    BOOST_CHECK_EQUAL(pooled.get(), pooled_address);
+    BOOST_CHECK_EQUAL(TestComponentE::instances, 4);
+    BOOST_CHECK_EQUAL(pooled->getInputs().size(), 1);
+    *pooled_value = 3;
+    BOOST_CHECK_EQUAL(TestComponentE::received, 1);
+    Component::setPoolCapacity(Type("TestComponentE"), 0);
+    pooled.reset();
+    pooled = Component::instantiate(Type("TestComponentE"));
+    BOOST_CHECK_EQUAL(TestComponentE::instances, 5);
     
     // Test component versioning
     std::set<Version> available_versions =
@@ -377,6 +628,17 @@ BOOST_AUTO_TEST_CASE(TestComponent)
     *input_value = 42;
     int second_output_value = *output_value;
     BOOST_CHECK_EQUAL(second_output_value, 42);
+
+    // Test removal of connections to destroyed components
+    Component::connect(instance_of_a, "triple", output_value_component, "value");
+    output_value_component.reset();
+    output_value.reset();
+    BOOST_CHECK_NO_THROW(*input_value = 7);
+    Component::disconnect(input_value_component, "value", instance_of_a, "in");
+    BOOST_CHECK_THROW(Component::disconnect(
+                          input_value_component, "value", instance_of_a, "in"
+                          ),
+                      std::runtime_error);
 }
 
 
@@ -391,6 +653,127 @@ void callback(const int& value)
 
 
 
+/**
+ * Component type, describing itself to the registration macro, used by the
+ * unit test for the registration of factory functions.
+ */
+class __attribute__ ((visibility ("hidden"))) TestComponentH :
+    public Component
+{
+
+public:
+
+    /** Number of instances of this component type constructed so far. */
+    static boost::atomic<int> instances;
+
+    /** Descriptor of this component type. */
+    static Component::Descriptor describe()
+    {
+        Component::Descriptor descriptor(
+            Type(typeid(TestComponentH)), Version(2, 0, 0)
+            );
+        descriptor.dm_inputs.insert("in");
+        descriptor.dm_outputs.insert("out");
+        return descriptor;
+    }
+
+    /** Factory function for this component type. */
+    static Component::Instance factoryFunction()
+    {
+        return Component::Instance(
+            reinterpret_cast<Component*>(new TestComponentH())
+            );
+    }
+
+    /** Factory function that always fails. */
+    static Component::Instance failingFactoryFunction()
+    {
+        throw std::runtime_error("TestComponentH failed on purpose.");
+    }
+
+    /**
+     * Factory function that instantiates another component from another
+     * thread before instantiating this component type.
+     */
+    static Component::Instance queryingFactoryFunction()
+    {
+        boost::thread other(boost::bind(&Component::instantiate,
+                                        Type("TestComponentA"),
+                                        boost::optional<Version>()));
+        other.join();
+        return factoryFunction();
+    }
+
+    /**
+     * Register the failing factory function, the querying one, and then the
+     * real one, none of them along with its descriptor.
+     */
+    static void registerAfterFailure()
+    {
+        Component::registerFactoryFunction(
+            &TestComponentH::failingFactoryFunction
+            );
+        Component::registerFactoryFunction(
+            &TestComponentH::queryingFactoryFunction
+            );
+        Component::registerFactoryFunction(&TestComponentH::factoryFunction);
+    }
+
+private:
+
+    /** Default constructor. */
+    TestComponentH() :
+        Component(Type(typeid(TestComponentH)), Version(2, 0, 0))
+    {
+        ++instances;
+        declareInput<int>(
+            "in", boost::bind(&TestComponentH::inHandler, this, _1)
+            );
+        declareOutput<int>("out");
+    }
+
+    /** Handler for the "in" input. */
+    void inHandler(const int& in)
+    {
+        emitOutput<int>("out", in);
+    }
+
+}; // class TestComponentH
+
+boost::atomic<int> TestComponentH::instances(0);
+
+KRELL_INSTITUTE_CBTF_REGISTER_FACTORY_FUNCTION(TestComponentH)
+
+
+
+/**
+ * Unit test for the registration of factory functions.
+ */
+BOOST_AUTO_TEST_CASE(TestRegistration)
+{
+    // Test that a component type describing itself is never instantiated
+    std::set<Type> available_types = Component::getAvailableTypes();
+    BOOST_CHECK_NE(available_types.find(Type("TestComponentH")),
+                   available_types.end());
+    Component::Descriptor descriptor =
+        Component::getDescriptor(Type("TestComponentH"));
+    BOOST_CHECK_EQUAL(descriptor.dm_version, Version(2, 0, 0));
+    BOOST_CHECK_EQUAL(descriptor.dm_inputs.count("in"), 1);
+    BOOST_CHECK_EQUAL(descriptor.dm_outputs.count("out"), 1);
+    BOOST_CHECK_EQUAL(TestComponentH::instances, 0);
+    BOOST_CHECK(Component::instantiate(Type("TestComponentH")));
+    BOOST_CHECK_EQUAL(TestComponentH::instances, 1);
+
+    // Test that a failing factory function doesn't lose those queued after it,
+    // and that factory functions may query the registry from other threads,
+    // which would deadlock if they were called with the registry locked
+    TestComponentH::registerAfterFailure();
+    BOOST_CHECK_NO_THROW(Component::getAvailableTypes());
+    BOOST_CHECK_EQUAL(TestComponentH::instances, 3);
+}
+
+
+
 /**
  * Unit test for the SignalAdapter class.
  */
@@ -418,3 +801,1144 @@ BOOST_AUTO_TEST_CASE(TestSignalAdapter)
     output_value->Value.connect(callback);
     *input_value = 10;
 }
+
+
+
+/**
+ * Component type, whose handler throws an exception that isn't derived from
+ * std::exception for negative values, used by the unit test for asynchronous
+ * components.
+ */
+class __attribute__ ((visibility ("hidden"))) TestComponentI :
+    public Component
+{
+
+public:
+
+    /** Factory function for this component type. */
+    static Component::Instance factoryFunction()
+    {
+        return Component::Instance(
+            reinterpret_cast<Component*>(new TestComponentI())
+            );
+    }
+
+private:
+
+    /** Default constructor. */
+    TestComponentI() :
+        Component(Type(typeid(TestComponentI)), Version(0, 0, 0))
+    {
+        declareInput<int>(
+            "in", boost::bind(&TestComponentI::inHandler, this, _1)
+            );
+        declareOutput<int>("out");
+    }
+
+    /** Handler for the "in" input.*/
+    void inHandler(const int& in)
+    {
+        if (in < 0)
+        {
+            throw in;
+        }
+        emitOutput<int>("out", in);
+    }
+    
+}; // class TestComponentI
+
+KRELL_INSTITUTE_CBTF_REGISTER_FACTORY_FUNCTION(TestComponentI)
+
+
+
+/**
+ * Unit test for asynchronous components and connections.
+ */
+BOOST_AUTO_TEST_CASE(TestAsynchronous)
+{
+    BOOST_CHECK_THROW(Component::setThreadPoolSize(0), std::invalid_argument);
+    
+    Component::Instance instance_of_a =
+        Component::instantiate(Type("TestComponentA"));
+    BOOST_REQUIRE(instance_of_a);
+    Component::Instance instance_of_c =
+        Component::instantiate(Type("TestComponentC"));
+    BOOST_REQUIRE(instance_of_c);
+    
+    boost::shared_ptr<ValueSource<int> > input_value = 
+        ValueSource<int>::instantiate();
+    boost::shared_ptr<ValueSink<int> > output_value = 
+        ValueSink<int>::instantiate();
+    Component::Instance input_value_component = 
+        boost::reinterpret_pointer_cast<Component>(input_value);
+    Component::Instance output_value_component = 
+        boost::reinterpret_pointer_cast<Component>(output_value);
+
+    // Test an asynchronous component followed by an asynchronous connection
+    Component::setAsynchronous(instance_of_a, true);
+    Component::connect(input_value_component, "value", instance_of_a, "in");
+    Component::connect(instance_of_a, "double", instance_of_c, "in", true);
+    Component::connect(instance_of_c, "incremented",
+                       output_value_component, "value");
+
+    // Test that the values arrive, in order, on another thread
+    for (int i = 0; i < 1000; ++i)
+    {
+        *input_value = i;
+    }
+    for (int i = 0; i < 1000; ++i)
+    {
+        int value = *output_value;
+        BOOST_REQUIRE_EQUAL(value, (2 * i) + 1);
+    }
+
+    // Test switching the component back to being synchronous
+    Component::disconnect(instance_of_a, "double", instance_of_c, "in");
+    Component::connect(instance_of_a, "double", instance_of_c, "in");
+    Component::setAsynchronous(instance_of_a, false);
+    *input_value = 21;
+    int value = *output_value;
+    BOOST_CHECK_EQUAL(value, 43);
+
+    // Test that an asynchronous component whose handler throws something
+    // other than a std::exception keeps receiving values
+    Component::Instance instance_of_i =
+        Component::instantiate(Type("TestComponentI"));
+    BOOST_REQUIRE(instance_of_i);
+    boost::shared_ptr<ValueSource<int> > thrown_input_value = 
+        ValueSource<int>::instantiate();
+    boost::shared_ptr<ValueSink<int> > thrown_output_value = 
+        ValueSink<int>::instantiate();
+    Component::setAsynchronous(instance_of_i, true);
+    Component::connect(boost::reinterpret_pointer_cast<Component>(
+                           thrown_input_value
+                           ), "value", instance_of_i, "in");
+    Component::connect(instance_of_i, "out",
+                       boost::reinterpret_pointer_cast<Component>(
+                           thrown_output_value
+                           ), "value");
+    *thrown_input_value = -1;
+    for (int i = 0; i < 100; ++i)
+    {
+        *thrown_input_value = i;
+        *thrown_input_value = -1;
+    }
+    for (int i = 0; i < 100; ++i)
+    {
+        value = *thrown_output_value;
+        BOOST_REQUIRE_EQUAL(value, i);
+    }
+}
+
+
+
+/**
+ * Callback used by the unit test for reentrant emission. Breaks, and then
+ * remakes, the very connection over which it was invoked.
+ */
+void reconnect(Component::Instance output, Component::Instance input,
+               int& count)
+{
+    Component::disconnect(output, "value", input, "value");
+    Component::connect(output, "value", input, "value");
+    ++count;
+}
+
+
+
+/**
+ * Callback used by the unit test for reentrant emission.
+ */
+void countValue(boost::atomic<int>& count, const int&)
+{
+    ++count;
+}
+
+
+
+/**
+ * Thread function used by the unit tests for reentrant emission and for
+ * bounded value sinks.
+ */
+void emitValues(boost::shared_ptr<ValueSource<int> > source, int n)
+{
+    for (int i = 0; i < n; ++i)
+    {
+        *source = i;
+    }
+}
+
+
+
+/**
+ * Unit test for changing connections during, and concurrently with, emission.
+ */
+BOOST_AUTO_TEST_CASE(TestReentrancy)
+{
+    // Test changing connections from within a handler
+    boost::shared_ptr<ValueSource<int> > input_value =
+        ValueSource<int>::instantiate();
+    boost::shared_ptr<SignalAdapter<int> > output_value =
+        SignalAdapter<int>::instantiate();
+    Component::Instance input_value_component =
+        boost::reinterpret_pointer_cast<Component>(input_value);
+    Component::Instance output_value_component =
+        boost::reinterpret_pointer_cast<Component>(output_value);
+    Component::connect(input_value_component, "value",
+                       output_value_component, "value");
+    int count = 0;
+    output_value->Value.connect(boost::bind(
+        &reconnect, input_value_component, output_value_component,
+        boost::ref(count)
+        ));
+    BOOST_CHECK_NO_THROW(*input_value = 1);
+    BOOST_CHECK_NO_THROW(*input_value = 2);
+    BOOST_CHECK_EQUAL(count, 2);
+    output_value->Value.disconnect_all_slots();
+
+    // Test emitting from several threads while connections change
+    const int kThreads = 4, kValues = 10000;
+    boost::shared_ptr<SignalAdapter<int> > counted_value =
+        SignalAdapter<int>::instantiate();
+    Component::Instance counted_value_component =
+        boost::reinterpret_pointer_cast<Component>(counted_value);
+    boost::atomic<int> counted(0);
+    counted_value->Value.connect(boost::bind(
+        &countValue, boost::ref(counted), _1
+        ));
+    std::vector<boost::shared_ptr<ValueSource<int> > > sources;
+    for (int i = 0; i < kThreads; ++i)
+    {
+        sources.push_back(ValueSource<int>::instantiate());
+        Component::connect(
+            boost::reinterpret_pointer_cast<Component>(sources.back()), "value",
+            counted_value_component, "value"
+            );
+    }
+    boost::thread_group threads;
+    for (int i = 0; i < kThreads; ++i)
+    {
+        threads.create_thread(boost::bind(&emitValues, sources[i], kValues));
+    }
+    for (int n = 0; n < 1000; ++n)
+    {
+        Component::Instance source =
+            boost::reinterpret_pointer_cast<Component>(sources[n % kThreads]);
+        Component::connect(source, "value", output_value_component, "value");
+        Component::disconnect(source, "value", output_value_component, "value");
+    }
+    threads.join_all();
+    BOOST_CHECK_EQUAL(counted.load(), kThreads * kValues);
+}
+
+
+
+/**
+ * Component type used by the unit test for batch emission.
+ */
+class __attribute__ ((visibility ("hidden"))) TestComponentD :
+    public Component
+{
+
+public:
+
+    /** Factory function for this component type. */
+    static Component::Instance factoryFunction()
+    {
+        return Component::Instance(
+            reinterpret_cast<Component*>(new TestComponentD())
+            );
+    }
+
+private:
+
+    /** Default constructor. */
+    TestComponentD() :
+        Component(Type(typeid(TestComponentD)), Version(0, 0, 0))
+    {
+        declareInput<std::vector<int> >(
+            "values", boost::bind(&TestComponentD::valuesHandler, this, _1)
+            );
+        declareInputBatch<int>(
+            "batch", boost::bind(&TestComponentD::batchHandler, this, _1)
+            );
+        declareOutput<int>("unrolled");
+        dm_forwarded = declareOutput<int>("forwarded");
+        declareOutput<int>("size");
+    }
+
+    /** Handler for the "values" input. */
+    void valuesHandler(const std::vector<int>& values)
+    {
+        emitOutputBatch("unrolled", values);
+    }
+
+    /** Handler for the "batch" input. */
+    void batchHandler(const boost::iterator_range<const int*>& batch)
+    {
+        emitOutput<int>("size", static_cast<int>(batch.size()));
+        emitOutputBatch(dm_forwarded, batch);
+    }
+
+    /** Handle of the "forwarded" output. */
+    Component::OutputPort<int> dm_forwarded;
+    
+}; // class TestComponentD
+
+KRELL_INSTITUTE_CBTF_REGISTER_FACTORY_FUNCTION(TestComponentD)
+
+
+
+/**
+ * Unit test for batch emission and batch input handlers.
+ */
+BOOST_AUTO_TEST_CASE(TestBatch)
+{
+    Component::Instance unroller =
+        Component::instantiate(Type("TestComponentD"));
+    BOOST_REQUIRE(unroller);
+    Component::Instance forwarder =
+        Component::instantiate(Type("TestComponentD"));
+    BOOST_REQUIRE(forwarder);
+
+    boost::shared_ptr<ValueSource<std::vector<int> > > input_values = 
+        ValueSource<std::vector<int> >::instantiate();
+    boost::shared_ptr<ValueSource<int> > input_value = 
+        ValueSource<int>::instantiate();
+    boost::shared_ptr<ValueSink<int> > unrolled_values = 
+        ValueSink<int>::instantiate();
+    boost::shared_ptr<ValueSink<int> > forwarded_values = 
+        ValueSink<int>::instantiate();
+    boost::shared_ptr<ValueSink<int> > batch_sizes = 
+        ValueSink<int>::instantiate();
+
+    Component::connect(
+        boost::reinterpret_pointer_cast<Component>(input_values), "value",
+        unroller, "values"
+        );
+    Component::connect(
+        boost::reinterpret_pointer_cast<Component>(input_value), "value",
+        forwarder, "batch"
+        );
+    Component::connect(
+        unroller, "unrolled",
+        boost::reinterpret_pointer_cast<Component>(unrolled_values), "value"
+        );
+    Component::connect(unroller, "unrolled", forwarder, "batch");
+    Component::connect(
+        forwarder, "forwarded",
+        boost::reinterpret_pointer_cast<Component>(forwarded_values), "value"
+        );
+    Component::connect(
+        forwarder, "size",
+        boost::reinterpret_pointer_cast<Component>(batch_sizes), "value"
+        );
+    
+    // Test that batches are unrolled for scalar handlers and intact otherwise
+    std::vector<int> values;
+    values.push_back(1);
+    values.push_back(2);
+    values.push_back(3);
+    *input_values = values;
+    int size = *batch_sizes;
+    BOOST_CHECK_EQUAL(size, 3);
+    for (int i = 1; i <= 3; ++i)
+    {
+        int unrolled = *unrolled_values;
+        BOOST_CHECK_EQUAL(unrolled, i);
+        int forwarded = *forwarded_values;
+        BOOST_CHECK_EQUAL(forwarded, i);
+    }
+
+    // Test that empty batches aren't passed on
+    *input_values = std::vector<int>();
+
+    // Test that single values are passed to batch handlers as a batch
+    *input_value = 42;
+    size = *batch_sizes;
+    BOOST_CHECK_EQUAL(size, 1);
+    int forwarded = *forwarded_values;
+    BOOST_CHECK_EQUAL(forwarded, 42);
+
+    // Test that batches remain intact over asynchronous connections
+    Component::disconnect(unroller, "unrolled", forwarder, "batch");
+    Component::connect(unroller, "unrolled", forwarder, "batch", true);
+    values.push_back(4);
+    *input_values = values;
+    size = *batch_sizes;
+    BOOST_CHECK_EQUAL(size, 4);
+    for (int i = 1; i <= 4; ++i)
+    {
+        int unrolled = *unrolled_values;
+        BOOST_CHECK_EQUAL(unrolled, i);
+        forwarded = *forwarded_values;
+        BOOST_CHECK_EQUAL(forwarded, i);
+    }
+}
+
+
+
+/**
+ * Component type, emitting its outputs through pre-resolved handles, used by
+ * the unit test for output port handles.
+ */
+class __attribute__ ((visibility ("hidden"))) TestComponentG :
+    public Component
+{
+
+public:
+
+    /** Factory function for this component type. */
+    static Component::Instance factoryFunction()
+    {
+        return Component::Instance(
+            reinterpret_cast<Component*>(new TestComponentG())
+            );
+    }
+
+private:
+
+    /** Default constructor. */
+    TestComponentG() :
+        Component(Type(typeid(TestComponentG)), Version(0, 0, 0))
+    {
+        declareInput<int>(
+            "in", boost::bind(&TestComponentG::inHandler, this, _1)
+            );
+        declareInput<int>(
+            "unresolved",
+            boost::bind(&TestComponentG::unresolvedHandler, this, _1)
+            );
+        dm_double = declareOutput<int>("double");
+        dm_triple = declareOutput<int>("triple");
+    }
+
+    /** Handler for the "in" input. */
+    void inHandler(const int& in)
+    {
+        emitOutput(dm_double, 2 * in);
+        emitOutput(dm_triple, 3 * in);
+    }
+
+    /** Handler for the "unresolved" input. */
+    void unresolvedHandler(const int& in)
+    {
+        emitOutput(Component::OutputPort<int>(), in);
+    }
+
+    /** Handle of the "double" output. */
+    Component::OutputPort<int> dm_double;
+
+    /** Handle of the "triple" output. */
+    Component::OutputPort<int> dm_triple;
+    
+}; // class TestComponentG
+
+KRELL_INSTITUTE_CBTF_REGISTER_FACTORY_FUNCTION(TestComponentG)
+
+
+
+/**
+ * Unit test for emitting outputs through pre-resolved output port handles.
+ */
+BOOST_AUTO_TEST_CASE(TestOutputPorts)
+{
+    Component::Instance component =
+        Component::instantiate(Type("TestComponentG"));
+    BOOST_REQUIRE(component);
+
+    boost::shared_ptr<ValueSource<int> > input_value = 
+        ValueSource<int>::instantiate();
+    boost::shared_ptr<ValueSource<int> > unresolved_value = 
+        ValueSource<int>::instantiate();
+    boost::shared_ptr<ValueSink<int> > doubled_values = 
+        ValueSink<int>::instantiate();
+    boost::shared_ptr<ValueSink<int> > tripled_values = 
+        ValueSink<int>::instantiate();
+
+    Component::connect(
+        boost::reinterpret_pointer_cast<Component>(input_value), "value",
+        component, "in"
+        );
+    Component::connect(
+        boost::reinterpret_pointer_cast<Component>(unresolved_value), "value",
+        component, "unresolved"
+        );
+    
+    // Test that emitting an unconnected handle is harmless
+    *input_value = 1;
+
+    // Test that connections made after the handles were resolved are used
+    Component::connect(
+        component, "double",
+        boost::reinterpret_pointer_cast<Component>(doubled_values), "value"
+        );
+    Component::connect(
+        component, "triple",
+        boost::reinterpret_pointer_cast<Component>(tripled_values), "value"
+        );
+    *input_value = 2;
+    int doubled = *doubled_values;
+    BOOST_CHECK_EQUAL(doubled, 4);
+    int tripled = *tripled_values;
+    BOOST_CHECK_EQUAL(tripled, 6);
+
+    // Test that disconnections are seen through the handles
+    Component::disconnect(
+        component, "triple",
+        boost::reinterpret_pointer_cast<Component>(tripled_values), "value"
+        );
+    *input_value = 3;
+    doubled = *doubled_values;
+    BOOST_CHECK_EQUAL(doubled, 6);
+    BOOST_CHECK(!tripled_values->tryGet(tripled));
+
+    // Test that a handle not referring to any output is rejected
+    BOOST_CHECK_THROW(*unresolved_value = 4, std::invalid_argument);
+}
+
+
+
+/**
+ * Unit test for the collection of component statistics.
+ */
+BOOST_AUTO_TEST_CASE(TestStatistics)
+{
+    Component::Instance component =
+        Component::instantiate(Type("TestComponentD"));
+    BOOST_REQUIRE(component);
+
+    boost::shared_ptr<ValueSource<std::vector<int> > > input_values = 
+        ValueSource<std::vector<int> >::instantiate();
+    boost::shared_ptr<ValueSink<int> > unrolled_values = 
+        ValueSink<int>::instantiate();
+
+    Component::connect(
+        boost::reinterpret_pointer_cast<Component>(input_values), "value",
+        component, "values"
+        );
+    Component::connect(
+        component, "unrolled",
+        boost::reinterpret_pointer_cast<Component>(unrolled_values), "value"
+        );
+
+    std::vector<int> values;
+    values.push_back(1);
+    values.push_back(2);
+    
+    // Test that nothing is counted while collection is disabled
+    *input_values = values;
+    Statistics statistics = component->getStatistics();
+    BOOST_CHECK_EQUAL(statistics.dm_inputs["values"].dm_invocations, 0);
+    BOOST_CHECK_EQUAL(statistics.dm_outputs["unrolled"].dm_emissions, 0);
+
+    // Test that inputs, outputs, and batches are counted while enabled
+    Component::setStatisticsEnabled(true);
+    *input_values = values;
+    *input_values = values;
+    Component::setStatisticsEnabled(false);
+    statistics = component->getStatistics();
+
+    BOOST_CHECK_EQUAL(statistics.dm_inputs.size(), 2);
+    BOOST_CHECK_EQUAL(statistics.dm_inputs["values"].dm_values, 2);
+    BOOST_CHECK_EQUAL(statistics.dm_inputs["values"].dm_invocations, 2);
+    BOOST_CHECK_EQUAL(statistics.dm_inputs["batch"].dm_invocations, 0);
+    BOOST_CHECK_EQUAL(statistics.dm_outputs["unrolled"].dm_values, 4);
+    BOOST_CHECK_EQUAL(statistics.dm_outputs["unrolled"].dm_emissions, 2);
+    BOOST_CHECK_EQUAL(statistics.dm_outputs["size"].dm_emissions, 0);
+
+    const std::vector<boost::uint64_t>& histogram =
+        statistics.dm_inputs["values"].dm_histogram;
+    BOOST_CHECK_EQUAL(histogram.size(), Statistics::kHistogramBuckets);
+    boost::uint64_t invocations = 0;
+    for (std::size_t b = 0; b < histogram.size(); ++b)
+    {
+        invocations += histogram[b];
+    }
+    BOOST_CHECK_EQUAL(invocations, 2);
+    
+    int unrolled = 0;
+    for (int i = 0; i < 6; ++i)
+    {
+        unrolled = *unrolled_values;
+    }
+    BOOST_CHECK_EQUAL(unrolled, 2);
+}
+
+
+
+/** Record a trace scope with the given name from the calling thread. */
+void recordTraceScope(const std::string& name)
+{
+    Trace::Scope scope(Trace::intern("TestTrace"), Trace::intern(name));
+}
+
+
+
+/** Get the thread of the trace record with the given name, or -1 if none. */
+int findTraceThread(const std::string& trace, const std::string& name)
+{
+    std::string::size_type i = trace.find("{\"name\":\"" + name + "\"");
+    if (i == std::string::npos)
+    {
+        return -1;
+    }
+    i = trace.find(",\"tid\":", i);
+    if (i == std::string::npos)
+    {
+        return -1;
+    }
+    return atoi(trace.c_str() + i + 7);
+}
+
+
+
+/**
+ * Unit test for the Trace class.
+ */
+BOOST_AUTO_TEST_CASE(TestTrace)
+{
+    Component::Instance component =
+        Component::instantiate(Type("TestComponentA"));
+    BOOST_REQUIRE(component);
+
+    boost::shared_ptr<ValueSource<int> > input_value = 
+        ValueSource<int>::instantiate();
+
+    Component::connect(
+        boost::reinterpret_pointer_cast<Component>(input_value), "value",
+        component, "in"
+        );
+
+    // Test that nothing is recorded while tracing is disabled
+    *input_value = 1;
+    std::ostringstream disabled;
+    Trace::write(disabled);
+    BOOST_CHECK_EQUAL(disabled.str().find("\"TestComponentA\""),
+                      std::string::npos);
+    
+    // Test that handler invocations are recorded while tracing is enabled
+    Trace::setEnabled(true);
+    *input_value = 2;
+    {
+        Trace::Scope scope(Trace::intern("TestTrace"), Trace::intern("\"a\""));
+    }
+    Trace::setEnabled(false);
+    
+    std::ostringstream enabled;
+    Trace::write(enabled);
+    BOOST_CHECK_NE(enabled.str().find(
+                       "{\"name\":\"in\",\"cat\":\"TestComponentA\",\"ph\":\"X\""
+                       ), std::string::npos);
+    BOOST_CHECK_NE(enabled.str().find(
+                       "{\"name\":\"\\\"a\\\"\",\"cat\":\"TestTrace\""
+                       ), std::string::npos);
+
+    // Test that the buffer of an exited thread is reused by a later thread
+    Trace::setEnabled(true);
+    boost::thread first(boost::bind(&recordTraceScope, "first"));
+    first.join();
+    boost::thread second(boost::bind(&recordTraceScope, "second"));
+    second.join();
+    Trace::setEnabled(false);
+
+    std::ostringstream reused;
+    Trace::write(reused);
+    const int first_thread = findTraceThread(reused.str(), "first");
+    BOOST_CHECK_NE(first_thread, -1);
+    BOOST_CHECK_EQUAL(findTraceThread(reused.str(), "second"), first_thread);
+}
+
+
+
+/**
+ * Unit test for bounded value sinks.
+ */
+BOOST_AUTO_TEST_CASE(TestValueSink)
+{
+    boost::shared_ptr<ValueSource<int> > source = 
+        ValueSource<int>::instantiate();
+    Component::Instance source_component =
+        boost::reinterpret_pointer_cast<Component>(source);
+
+    // Test the non-blocking, timed, and bulk receives of an unbounded sink
+    boost::shared_ptr<ValueSink<int> > unbounded =
+        ValueSink<int>::instantiate();
+    Component::connect(
+        source_component, "value",
+        boost::reinterpret_pointer_cast<Component>(unbounded), "value"
+        );
+    int value = -1;
+    BOOST_CHECK(!unbounded->tryGet(value));
+    BOOST_CHECK(!unbounded->getFor(boost::posix_time::milliseconds(1), value));
+    emitValues(source, 5);
+    BOOST_CHECK(unbounded->tryGet(value));
+    BOOST_CHECK_EQUAL(value, 0);
+    BOOST_CHECK(unbounded->getFor(boost::posix_time::milliseconds(1), value));
+    BOOST_CHECK_EQUAL(value, 1);
+    std::vector<int> values;
+    BOOST_CHECK_EQUAL(unbounded->drain(std::back_inserter(values)), 3);
+    BOOST_CHECK_EQUAL(values.size(), 3);
+    BOOST_CHECK_EQUAL(values.back(), 4);
+    BOOST_CHECK(!unbounded->tryGet(value));
+    Component::disconnect(
+        source_component, "value",
+        boost::reinterpret_pointer_cast<Component>(unbounded), "value"
+        );
+
+    // Test the overflow policies, both with and without a ring buffer
+    for (int single_producer = 0; single_producer < 2; ++single_producer)
+    {
+        boost::shared_ptr<ValueSink<int> > oldest =
+            ValueSink<int>::instantiate(
+                2, ValueSink<int>::kDropOldest, single_producer != 0
+                );
+        boost::shared_ptr<ValueSink<int> > newest =
+            ValueSink<int>::instantiate(
+                2, ValueSink<int>::kDropNewest, single_producer != 0
+                );
+        boost::shared_ptr<ValueSink<int> > blocking =
+            ValueSink<int>::instantiate(
+                2, ValueSink<int>::kBlockProducer, single_producer != 0
+                );
+        Component::connect(
+            source_component, "value",
+            boost::reinterpret_pointer_cast<Component>(oldest), "value"
+            );
+        Component::connect(
+            source_component, "value",
+            boost::reinterpret_pointer_cast<Component>(newest), "value"
+            );
+        Component::connect(
+            source_component, "value",
+            boost::reinterpret_pointer_cast<Component>(blocking), "value"
+            );
+
+        boost::thread producer(boost::bind(&emitValues, source, 1000));
+        
+        int previous = -1;
+        for (int i = 0; i < 1000; ++i)
+        {
+            value = *blocking;
+            BOOST_CHECK_EQUAL(value, previous + 1);
+            previous = value;
+        }
+        producer.join();
+
+        values.clear();
+        BOOST_CHECK_EQUAL(oldest->drain(std::back_inserter(values)), 2);
+        BOOST_CHECK_EQUAL(values[0], 998);
+        BOOST_CHECK_EQUAL(values[1], 999);
+        BOOST_CHECK_EQUAL(oldest->getDroppedCount(), 998);
+        
+        values.clear();
+        BOOST_CHECK_EQUAL(newest->drain(std::back_inserter(values)), 2);
+        BOOST_CHECK_EQUAL(values[0], 0);
+        BOOST_CHECK_EQUAL(values[1], 1);
+        BOOST_CHECK_EQUAL(newest->getDroppedCount(), 998);
+        
+        BOOST_CHECK_EQUAL(blocking->getDroppedCount(), 0);
+        BOOST_CHECK(!blocking->tryGet(value));
+
+        Component::disconnect(
+            source_component, "value",
+            boost::reinterpret_pointer_cast<Component>(oldest), "value"
+            );
+        Component::disconnect(
+            source_component, "value",
+            boost::reinterpret_pointer_cast<Component>(newest), "value"
+            );
+        Component::disconnect(
+            source_component, "value",
+            boost::reinterpret_pointer_cast<Component>(blocking), "value"
+            );
+    }
+}
+
+
+
+/**
+ * Unit test for the path resolution functions.
+ */
+BOOST_AUTO_TEST_CASE(TestResolvePath)
+{
+    const boost::filesystem::path directory =
+        boost::filesystem::temp_directory_path() /
+        boost::filesystem::unique_path();
+    BOOST_REQUIRE(boost::filesystem::create_directory(directory));
+    const std::vector<boost::filesystem::path> search_paths(1, directory);
+
+    // Test resolution of a file before and after it is created and removed
+    BOOST_CHECK(Impl::resolvePath(search_paths, "TestResolvePath").empty());
+    BOOST_CHECK(Impl::resolvePath(search_paths, "TestResolvePath").empty());
+    {
+        boost::filesystem::ofstream file(directory / "TestResolvePath");
+    }
+    BOOST_CHECK_EQUAL(Impl::resolvePath(search_paths, "TestResolvePath"),
+                      directory / "TestResolvePath");
+    boost::filesystem::remove(directory / "TestResolvePath");
+    BOOST_CHECK(Impl::resolvePath(search_paths, "TestResolvePath").empty());
+
+    // Test resolution of a path within a subdirectory
+    boost::filesystem::create_directory(directory / "sub");
+    {
+        boost::filesystem::ofstream file(directory / "sub" / "file");
+    }
+    BOOST_CHECK_EQUAL(Impl::resolvePath(search_paths, "sub/file"),
+                      directory / "sub/file");
+    BOOST_CHECK(Impl::resolvePath(search_paths, "sub/none").empty());
+
+    // Test that a dangling symbolic link doesn't hide a later search path
+    boost::filesystem::create_directory(directory / "first");
+    boost::filesystem::create_directory(directory / "second");
+    boost::filesystem::create_symlink(directory / "none",
+                                      directory / "first" / "file");
+    {
+        boost::filesystem::ofstream file(directory / "second" / "file");
+    }
+    std::vector<boost::filesystem::path> both_paths;
+    both_paths.push_back(directory / "first");
+    both_paths.push_back(directory / "second");
+    BOOST_CHECK_EQUAL(Impl::resolvePath(both_paths, "file"),
+                      directory / "second" / "file");
+
+    // Test that changes are seen through each of two paths to one directory
+    boost::filesystem::create_directory_symlink(directory / "sub",
+                                                directory / "link");
+    const std::vector<boost::filesystem::path> link_paths(
+        1, directory / "link"
+        );
+    const std::vector<boost::filesystem::path> sub_paths(1, directory / "sub");
+    BOOST_CHECK(Impl::resolvePath(link_paths, "added").empty());
+    BOOST_CHECK(Impl::resolvePath(sub_paths, "added").empty());
+    {
+        boost::filesystem::ofstream file(directory / "sub" / "added");
+    }
+    BOOST_CHECK_EQUAL(Impl::resolvePath(link_paths, "added"),
+                      directory / "link" / "added");
+    BOOST_CHECK_EQUAL(Impl::resolvePath(sub_paths, "added"),
+                      directory / "sub" / "added");
+    
+    boost::filesystem::remove_all(directory);
+}
+
+
+
+/**
+ * Unit test for the Arena class.
+ */
+BOOST_AUTO_TEST_CASE(TestArena)
+{
+    // Test allocation from an arena
+    boost::shared_ptr<Impl::Arena> arena(new Impl::Arena(1024));
+    BOOST_CHECK_EQUAL(arena->getSize(), 0);
+    void* small = arena->allocate(3, 1);
+    void* aligned = arena->allocate(8, 8);
+    BOOST_CHECK_EQUAL(reinterpret_cast<std::size_t>(aligned) % 8, 0);
+    BOOST_CHECK(static_cast<char*>(aligned) >= static_cast<char*>(small) + 3);
+    arena->allocate(4096, 8);
+    BOOST_CHECK_EQUAL(arena->getSize(), 3 + 8 + 4096);
+
+    // Test nesting of the current arena
+    BOOST_CHECK(!Impl::Arena::current());
+    {
+        Impl::Arena::Scope outer(arena);
+        BOOST_CHECK(Impl::Arena::current() == arena);
+        {
+            Impl::Arena::Scope inner((boost::shared_ptr<Impl::Arena>()));
+            BOOST_CHECK(!Impl::Arena::current());
+            BOOST_CHECK(Impl::Arena::acquire() != arena);
+        }
+        BOOST_CHECK(Impl::Arena::acquire() == arena);
+    }
+    BOOST_CHECK(!Impl::Arena::current());
+
+    // Test components constructed within an arena's scope
+    boost::weak_ptr<Impl::Arena> observer(arena);
+    Component::Instance instance;
+    boost::shared_ptr<ValueSource<int> > input_value;
+    boost::shared_ptr<ValueSink<int> > output_value;
+    {
+        Impl::Arena::Scope scope(arena);
+        std::size_t size = arena->getSize();
+        instance = Component::instantiate(Type(typeid(TestComponentA)));
+        input_value = ValueSource<int>::instantiate();
+        output_value = ValueSink<int>::instantiate();
+        BOOST_CHECK_GT(arena->getSize(), size);
+    }
+    arena.reset();
+    BOOST_CHECK(!observer.expired());
+
+    Component::connect(boost::reinterpret_pointer_cast<Component>(input_value),
+                       "value", instance, "in");
+    Component::connect(instance, "triple",
+                       boost::reinterpret_pointer_cast<Component>(output_value),
+                       "value");
+    *input_value = 5;
+    int value = *output_value;
+    BOOST_CHECK_EQUAL(value, 15);
+}
+
+
+
+/**
+ * Component type, with statically typed ports, used by the unit test for the
+ * Input and Output classes.
+ */
+class __attribute__ ((visibility ("hidden"))) TestComponentF :
+    public Component
+{
+
+public:
+
+    /** Factory function for this component type. */
+    static boost::shared_ptr<TestComponentF> instantiate()
+    {
+        return boost::shared_ptr<TestComponentF>(new TestComponentF());
+    }
+
+    /** The "in" input. */
+    Input<int> dm_in;
+
+    /** The "doubled" output. */
+    Output<int> dm_doubled;
+    
+private:
+
+    /** Default constructor. */
+    TestComponentF() :
+        Component(Type(typeid(TestComponentF)), Version(0, 0, 0)),
+        dm_in(this, "in", &TestComponentF::inHandler),
+        dm_doubled(this, "doubled")
+    {
+    }
+
+    /** Handler for the "in" input. */
+    void inHandler(const int& in)
+    {
+        dm_doubled(2 * in);
+    }
+
+}; // class TestComponentF
+
+
+
+/**
+ * Unit test for the Input and Output classes.
+ */
+BOOST_AUTO_TEST_CASE(TestPorts)
+{
+    boost::shared_ptr<TestComponentF> first = TestComponentF::instantiate();
+    boost::shared_ptr<TestComponentF> second = TestComponentF::instantiate();
+
+    // Test direct connection of statically typed ports
+    BOOST_CHECK_NO_THROW(first->dm_doubled.connect(second->dm_in));
+    BOOST_CHECK_THROW(first->dm_doubled.connect(second->dm_in),
+                      std::runtime_error);
+
+    // Test connection of statically typed ports by name
+    boost::shared_ptr<ValueSource<int> > input_value =
+        ValueSource<int>::instantiate();
+    boost::shared_ptr<ValueSink<int> > output_value =
+        ValueSink<int>::instantiate();
+    Component::connect(boost::reinterpret_pointer_cast<Component>(input_value),
+                       "value",
+                       boost::reinterpret_pointer_cast<Component>(first),
+                       "in");
+    Component::connect(boost::reinterpret_pointer_cast<Component>(second),
+                       "doubled",
+                       boost::reinterpret_pointer_cast<Component>(output_value),
+                       "value");
+    BOOST_CHECK_THROW(Component::connect(
+                          boost::reinterpret_pointer_cast<Component>(second),
+                          "doubled",
+                          boost::reinterpret_pointer_cast<Component>(first),
+                          "doubled"
+                          ),
+                      std::runtime_error);
+    *input_value = 5;
+    int value = *output_value;
+    BOOST_CHECK_EQUAL(value, 20);
+
+    // Test disconnection of statically typed ports
+    first->dm_doubled.disconnect(second->dm_in);
+    BOOST_CHECK_THROW(first->dm_doubled.disconnect(second->dm_in),
+                      std::runtime_error);
+    Component::connect(boost::reinterpret_pointer_cast<Component>(first),
+                       "doubled",
+                       boost::reinterpret_pointer_cast<Component>(output_value),
+                       "value");
+    *input_value = 7;
+    value = *output_value;
+    BOOST_CHECK_EQUAL(value, 14);
+
+    // Test removal of direct connections to destroyed components
+    first->dm_doubled.connect(second->dm_in);
+    second.reset();
+    *input_value = 3;
+    value = *output_value;
+    BOOST_CHECK_EQUAL(value, 6);
+
+    // Test that outputs stop being emitted by name once disconnected by name
+    Component::disconnect(boost::reinterpret_pointer_cast<Component>(first),
+                          "doubled",
+                          boost::reinterpret_pointer_cast<Component>(output_value),
+                          "value");
+    Component::setStatisticsEnabled(true);
+    *input_value = 4;
+    Component::setStatisticsEnabled(false);
+    Statistics statistics = first->getStatistics();
+    BOOST_CHECK_EQUAL(statistics.dm_outputs["doubled"].dm_emissions, 0);
+
+    // Test the same once the inputs connected by name are destroyed
+    Component::connect(boost::reinterpret_pointer_cast<Component>(first),
+                       "doubled",
+                       boost::reinterpret_pointer_cast<Component>(output_value),
+                       "value");
+    Component::setStatisticsEnabled(true);
+    *input_value = 5;
+    output_value.reset();
+    *input_value = 6;
+    Component::setStatisticsEnabled(false);
+    statistics = first->getStatistics();
+    BOOST_CHECK_EQUAL(statistics.dm_outputs["doubled"].dm_emissions, 1);
+}
+
+
+
+/**
+ * Converter component type used by the unit test for the converter index.
+ *
+ * @tparam From    Type of the values converted.
+ * @tparam To      Type of the values produced.
+ */
+template <typename From, typename To>
+class __attribute__ ((visibility ("hidden"))) TestConvert :
+    public Component
+{
+
+public:
+
+    /** Register this component type under the given name. */
+    static void registerAs(const std::string& name)
+    {
+        registerAs(name, boost::bind(&TestConvert::factoryFunction, name));
+    }
+
+    /** Register a factory function for the given converter type name. */
+    static void registerAs(const std::string& name,
+                           const Component::FactoryFunction& function)
+    {
+        Component::registerFactoryFunction(
+            Component::Descriptor(Type(name), Version(0, 0, 0)), function
+            );
+    }
+
+    /** Factory function for this component type. */
+    static Component::Instance factoryFunction(const std::string& name)
+    {
+        return Component::Instance(
+            reinterpret_cast<Component*>(new TestConvert(name))
+            );
+    }
+
+private:
+
+    /** Construct a converter with the given type name. */
+    TestConvert(const std::string& name) :
+        Component(Type(name), Version(0, 0, 0))
+    {
+        declareInput<From>(
+            "in", boost::bind(&TestConvert::inHandler, this, _1)
+            );
+        declareOutput<To>("out");
+    }
+
+    /** Handler for the "in" input. */
+    void inHandler(const From& in)
+    {
+        emitOutput<To>("out", static_cast<To>(in));
+    }
+
+}; // class TestConvert<From, To>
+
+
+
+/**
+ * Factory function for a converter, used by the unit test for the converter
+ * index, that throws something other than a std::exception while the given
+ * number of failures remains.
+ */
+Component::Instance failingConverterFactoryFunction(int& failures)
+{
+    if (failures > 0)
+    {
+        --failures;
+        throw failures;
+    }
+    return TestConvert<char, short>::factoryFunction("TestConvertCharToShort");
+}
+
+
+
+/**
+ * Unit test for the converter index.
+ */
+BOOST_AUTO_TEST_CASE(TestConverters)
+{
+    TestConvert<int, float>::registerAs("TestConvertIntToFloat");
+    TestConvert<float, double>::registerAs("TestConvertFloatToDouble");
+    TestConvert<double, float>::registerAs("TestDoubleToFloat");
+
+    // Test single and multiple hop conversions
+    std::vector<Type> chain =
+        Component::findConverters(Type::of<int>(), Type::of<float>());
+    BOOST_REQUIRE_EQUAL(chain.size(), 1);
+    BOOST_CHECK_EQUAL(chain[0], Type("TestConvertIntToFloat"));
+    chain = Component::findConverters(Type::of<int>(), Type::of<double>());
+    BOOST_REQUIRE_EQUAL(chain.size(), 2);
+    BOOST_CHECK_EQUAL(chain[0], Type("TestConvertIntToFloat"));
+    BOOST_CHECK_EQUAL(chain[1], Type("TestConvertFloatToDouble"));
+    BOOST_CHECK(Component::findConverters(Type::of<double>(),
+                                          Type::of<float>()).empty());
+    BOOST_CHECK(Component::findConverters(Type::of<int>(),
+                                          Type::of<int>()).empty());
+
+    // Test indexing of converters registered after a search
+    TestConvert<double, int>::registerAs("TestConvertDoubleToInt");
+    chain = Component::findConverters(Type::of<double>(), Type::of<float>());
+    BOOST_REQUIRE_EQUAL(chain.size(), 2);
+    BOOST_CHECK_EQUAL(chain[0], Type("TestConvertDoubleToInt"));
+    BOOST_CHECK_EQUAL(chain[1], Type("TestConvertIntToFloat"));
+
+    // Test that a converter which failed to instantiate is retried
+    int failures = 1;
+    TestConvert<char, short>::registerAs(
+        "TestConvertCharToShort",
+        boost::bind(&failingConverterFactoryFunction, boost::ref(failures))
+        );
+    BOOST_CHECK(Component::findConverters(Type::of<char>(),
+                                          Type::of<short>()).empty());
+    BOOST_CHECK_EQUAL(failures, 0);
+    chain = Component::findConverters(Type::of<char>(), Type::of<short>());
+    BOOST_REQUIRE_EQUAL(chain.size(), 1);
+    BOOST_CHECK_EQUAL(chain[0], Type("TestConvertCharToShort"));
+
+    // Test the conversion itself
+    boost::shared_ptr<ValueSource<int> > input_value =
+        ValueSource<int>::instantiate();
+    boost::shared_ptr<ValueSink<double> > output_value =
+        ValueSink<double>::instantiate();
+    chain = Component::findConverters(Type::of<int>(), Type::of<double>());
+    Component::Instance first = Component::instantiate(chain[0]);
+    Component::Instance second = Component::instantiate(chain[1]);
+    Component::connect(boost::reinterpret_pointer_cast<Component>(input_value),
+                       "value", first, "in");
+    Component::connect(first, "out", second, "in");
+    Component::connect(second, "out",
+                       boost::reinterpret_pointer_cast<Component>(output_value),
+                       "value");
+    *input_value = 3;
+    double value = *output_value;
+    BOOST_CHECK_EQUAL(value, 3.0);
+}